@@ -4,14 +4,22 @@
 #include <HardwareSerial.h>
 #include <SoftwareSerial.h>
 #include <utilities.h>
+#include <binaryframe.h>
+#include <binaryframeassembler.h>
+#include <requesttokenizer.h>
+#include <lineassembler.h>
+#include <responsebuilder.h>
 #include "include/gpio.h"
 #include "include/arduinopcstrings.h"
+#include "include/requestdispatch.h"
+#include "include/pincapabilities.h"
 
 #define ARRAY_SIZE(x) (sizeof(x)/sizeof(x[0]))
 
 #if defined(__HAVE_CAN_BUS__)
     #include "include/mcp_can.h"
     #include "include/canmessage.h"
+    #include "include/canreceivering.h"
 #endif //__HAVE_CAN_BUS__
 
 #if defined(__HAVE_LIN_BUS__)
@@ -21,10 +29,11 @@
 
 using namespace ArduinoPCStrings;
 using namespace Utilities;
+using namespace RequestDispatch;
+using namespace PinCapabilities;
 
 #define ID_WIDTH 3
 #define MESSAGE_WIDTH 2
-#define MAXIMUM_SERIAL_READ_SIZE 175
 #define PIN_OFFSET 2
 #define NEXT_SERIAL_PORT_UNAVAILABLE -1
 #define SERIAL_BAUD 115200L
@@ -51,7 +60,20 @@ using namespace Utilities;
 #define PIN_PLACEHOLDER 1
 #define SOFT 1
 #define SERIAL_PIN_NOT_IN_USE -1
-
+#define IO_STREAM_STOPPED 0
+#define IO_STREAM_MINIMUM_INTERVAL 10
+#define IO_STREAM_MAXIMUM_INTERVAL 60000
+#define IO_STREAM_PERIODIC 0
+#define IO_STREAM_ON_CHANGE 1
+#define IO_STREAM_DELTA 2
+
+static bool binaryFramingEnabled{false};
+static unsigned long ioStreamInterval{IO_STREAM_STOPPED};
+static unsigned long ioStreamLastTime{0};
+static uint8_t ioStreamMode{IO_STREAM_PERIODIC};
+static bool ioStreamReportSent{false};
+static uint16_t ioStreamLastChecksum{0};
+static Stream *ioStreamOutput{nullptr};
 static const bool NO_BROADCAST{false};
 static const bool BROADCAST{true};
 
@@ -74,21 +96,25 @@ void broadcastString(const char *str);
     void printBlankLinResult(const char *header, int resultCode); 
 #endif
 
-void handleSerialString(const char *str);
-void digitalReadRequest(const char *str);
-void softDigitalReadRequest(const char *str);
-void digitalWriteRequest(const char *str);
-void digitalWriteAllRequest(const char *str);
-void analogReadRequest(const char *str);
-void analogWriteRequest(const char *str);
-void softAnalogReadRequest(const char *str);
-void addSoftwareSerialRequest(const char *str);
-void removeSoftwareSerialRequest(const char *str);
-
-void pinTypeRequest(const char *str);
-void pinTypeChangeRequest(const char *str);
-
-void changeAToDThresholdRequest(const char *str);
+void handleSerialString(char *str);
+void dispatchRequest(const RequestTokenizer &request, void (*handler)(const RequestTokenizer &), const char *failureHeader = INVALID_HEADER);
+void digitalReadRequest(const RequestTokenizer &request);
+void softDigitalReadRequest(const RequestTokenizer &request);
+void digitalWriteRequest(const RequestTokenizer &request);
+void digitalWriteAllRequest(const RequestTokenizer &request);
+void digitalReadMultiRequest(const RequestTokenizer &request);
+void digitalWriteMultiRequest(const RequestTokenizer &request);
+void analogReadMultiRequest(const RequestTokenizer &request);
+void analogReadRequest(const RequestTokenizer &request);
+void analogWriteRequest(const RequestTokenizer &request);
+void softAnalogReadRequest(const RequestTokenizer &request);
+void addSoftwareSerialRequest(const RequestTokenizer &request);
+void removeSoftwareSerialRequest(const RequestTokenizer &request);
+
+void pinTypeRequest(const RequestTokenizer &request);
+void pinTypeChangeRequest(const RequestTokenizer &request);
+
+void changeAToDThresholdRequest(const RequestTokenizer &request);
 void currentAToDThresholdRequest();
 
 void arduinoTypeRequest();
@@ -96,6 +122,19 @@ void firmwareVersionRequest();
 void canBusEnabledRequest();
 void linBusEnabledRequest();
 void ioReportRequest();
+void ioReportDeltaRequest(const RequestTokenizer &request);
+void ioStreamRequest(const RequestTokenizer &request);
+void ioStreamUpdate();
+void ioDeadbandRequest(const RequestTokenizer &request);
+void clearReportedStates();
+void writeIOReport(Stream *stream, const char *header, bool changedOnly, bool skipIfUnchanged);
+int ioReportState(GPIO *gpioPin);
+uint16_t ioReportChecksum();
+void binaryModeRequest(const RequestTokenizer &request);
+void serviceSerialPort(Stream *stream, LineAssembler *lineAssembler, BinaryFrameAssembler *binaryFrameAssembler);
+void handleBinaryFrame(BinaryFrameAssembler *binaryFrameAssembler);
+void binaryIORequest(uint8_t opcode, const uint8_t *payload, uint8_t length);
+void printBinaryResult(uint8_t opcode, const uint8_t *payload, uint8_t length);
 void getPrintablePinType(int8_t pinNumber, char *out);
 
 Stream *getCurrentValidOutputStream();
@@ -108,7 +147,6 @@ bool isValidPwmPinIdentifier(const char *str);
 bool isValidPinTypeIdentifier(const char *str);
 
 bool checkValidIOChangeRequest(IOType ioType, int8_t pinNumber);
-bool checkValidRequestString(const char *header, const char *checkStr); 
 
 bool isValidDigitalOutputPin(int8_t pinNumber);
 bool isValidDigitalInputPin(int8_t pinNumber);
@@ -121,6 +159,7 @@ int parseToState(const char *str);
 int parseToAnalogState(const char *str);
 IOType parseIOType(const char *str);
 int parseToDigitalState(const char *str);
+long parseToUnsignedValue(const char *str);
 int8_t parsePin(const char *str);
 void initializeGpioMap();
 
@@ -129,39 +168,53 @@ int8_t getSerialPinIOTypeString(int8_t pinNumber, char *out, size_t maximumSize)
 int8_t analogPinFromNumber(int8_t number, char *out, size_t maximumSize);
 GPIO *gpioPinByPinNumber(int8_t pinNumber);
 bool pinInUseBySerialPort(int8_t pinNumber);
-size_t makeRequestString(const char *str, const char *header, char *out, size_t maximumSize);
-uint8_t analogPinArraySize();
-uint8_t generalPinArraySize();
-uint8_t pwmPinArraySize();
+int checkPinAvailable(int8_t pinNumber, bool (*isValidForRequest)(int8_t));
+int multiResultCode(uint8_t pinCount, uint8_t successCount);
 
 #if defined(ARDUINO_AVR_UNO)
-    static const PROGMEM int8_t AVAILABLE_ANALOG_PINS[]{A0, A1, A2, A3, A4, A5, -1};
-    static const PROGMEM int8_t AVAILABLE_GENERAL_PINS[]{2, 4, 7, 8, 12, 13, -1};
+    #define AVAILABLE_ANALOG_PIN_LIST A0, A1, A2, A3, A4, A5
+    #define AVAILABLE_GENERAL_PIN_LIST 2, 4, 7, 8, 12, 13
+    #define AVAILABLE_PWM_PIN_LIST 3, 5, 6, 9, 10, 11
+    #define AVAILABLE_DIGITAL_PIN_LIST AVAILABLE_PWM_PIN_LIST, AVAILABLE_GENERAL_PIN_LIST, AVAILABLE_ANALOG_PIN_LIST
     #define NUMBER_OF_ANALOG_PINS 6
     #define ANALOG_PIN_OFFSET 13
     #define NUMBER_OF_PINS 21
-    static const PROGMEM int8_t AVAILABLE_PWM_PINS[]{3, 5, 6, 9, 10, 11, -1};
 #elif defined(ARDUINO_AVR_NANO)
-    static const PROGMEM int8_t AVAILABLE_ANALOG_PINS[]{A0, A1, A2, A3, A4, A5, A6, A7, -1};                                                
-    static const PROGMEM int8_t AVAILABLE_GENERAL_PINS[]{2, 4, 7, 8, 12, 13, -1};
+    #define AVAILABLE_ANALOG_PIN_LIST A0, A1, A2, A3, A4, A5, A6, A7
+    #define AVAILABLE_GENERAL_PIN_LIST 2, 4, 7, 8, 12, 13
+    #define AVAILABLE_PWM_PIN_LIST 3, 5, 6, 9, 10, 11
+    //A6 and A7 are analog input only
+    #define AVAILABLE_DIGITAL_PIN_LIST AVAILABLE_PWM_PIN_LIST, AVAILABLE_GENERAL_PIN_LIST, A0, A1, A2, A3, A4, A5
     #define NUMBER_OF_ANALOG_PINS 8
     #define ANALOG_PIN_OFFSET 13
     #define NUMBER_OF_PINS 23
-    static const PROGMEM int8_t AVAILABLE_PWM_PINS[]{3, 5, 6, 9, 10, 11, -1};
 #elif defined(ARDUINO_AVR_MEGA1280) || defined(ARDUINO_AVR_MEGA2560)
-    static const PROGMEM int8_t AVAILABLE_ANALOG_PINS[]{A0, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15, -1};
-    static const PROGMEM int8_t AVAILABLE_GENERAL_PINS[]{14, 15, 16, 17, 18, 19, 20,21, 22, 23, 24, 
-                                                      25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37,
-                                                      38, 39, 40, 41, 42, 43, 47, 48, 49, 50, 51, 52, 53,-1};            
-
-    static const PROGMEM int8_t AVAILABLE_SERIAL_RX_PINS[]{10, 11, 12, 13, 14, 15, 50, 51, 52, 53,
-                                                           A8, A9, A10, A11, A12, A13, A14, A15};                                    
+    #define AVAILABLE_ANALOG_PIN_LIST A0, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15
+    #define AVAILABLE_GENERAL_PIN_LIST 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24,                      \
+                                       25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37,              \
+                                       38, 39, 40, 41, 42, 43, 47, 48, 49, 50, 51, 52, 53
+    #define AVAILABLE_PWM_PIN_LIST 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 44, 45, 46
+    #define AVAILABLE_DIGITAL_PIN_LIST AVAILABLE_PWM_PIN_LIST, AVAILABLE_GENERAL_PIN_LIST, AVAILABLE_ANALOG_PIN_LIST
+    //Pins with a pin change interrupt, which SoftwareSerial needs for RX
+    static const PROGMEM uint8_t SERIAL_RX_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(10, 11, 12, 13, 14, 15, 50, 51, 52, 53,
+                                                                            A8, A9, A10, A11, A12, A13, A14, A15);
     #define NUMBER_OF_ANALOG_PINS 16
     #define ANALOG_PIN_OFFSET 53
     #define NUMBER_OF_PINS 71
-    static const PROGMEM int8_t AVAILABLE_PWM_PINS[]{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 44, 45, 46, -1};
 #endif
 
+/* The lists are walked once, to set up the GPIO map; every check after that is a bit test on
+ * the masks built from the same lists (see include/pincapabilities.h) */
+static const PROGMEM int8_t AVAILABLE_ANALOG_PINS[]{AVAILABLE_ANALOG_PIN_LIST, -1};
+static const PROGMEM int8_t AVAILABLE_GENERAL_PINS[]{AVAILABLE_GENERAL_PIN_LIST, -1};
+static const PROGMEM int8_t AVAILABLE_PWM_PINS[]{AVAILABLE_PWM_PIN_LIST, -1};
+static const PROGMEM uint8_t ANALOG_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(AVAILABLE_ANALOG_PIN_LIST);
+static const PROGMEM uint8_t PWM_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(AVAILABLE_PWM_PIN_LIST);
+static const PROGMEM uint8_t DIGITAL_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(AVAILABLE_DIGITAL_PIN_LIST);
+static_assert(NUMBER_OF_PINS <= PIN_MASK_PINS, "Pin masks are too small for this board");
+static_assert(A0 == (ANALOG_PIN_OFFSET + 1), "Analog pins are numbered from ANALOG_PIN_OFFSET + 1");
+static_assert(ARRAY_SIZE(AVAILABLE_ANALOG_PINS) == (NUMBER_OF_ANALOG_PINS + 1), "NUMBER_OF_ANALOG_PINS does not match AVAILABLE_ANALOG_PIN_LIST");
+
 #if defined(__HAVE_CAN_BUS__)
     #ifndef INT32U
         #define INT32U unsigned long
@@ -172,12 +225,12 @@ uint8_t pwmPinArraySize();
     void canInitRequest();
     bool canInit();
     void canReadRequest(bool autoUp);
-    void canWriteRequest(const char *str, bool once);
-    void addNegativeCanMaskRequest(const char *str);
-    void removePositiveCanMaskRequest(const char *str);
-    void canLiveUpdateRequest(const char *str);
-    void clearCurrentMessageByIdRequest(const char *str);
-    void currentCachedCanMessageByIdRequest(const char *str);
+    void canWriteRequest(const RequestTokenizer &request, bool once);
+    void addNegativeCanMaskRequest(const RequestTokenizer &request);
+    void removePositiveCanMaskRequest(const RequestTokenizer &request);
+    void canLiveUpdateRequest(const RequestTokenizer &request);
+    void clearCurrentMessageByIdRequest(const RequestTokenizer &request);
+    void currentCachedCanMessageByIdRequest(const RequestTokenizer &request);
     void clearCanMessagesRequest();
     void currentPositiveCanMasksRequest();
     void currentNegativeCanMasksRequest();
@@ -187,9 +240,35 @@ uint8_t pwmPinArraySize();
     void clearCanMasksRequest();
     void currentCachedCanMessagesRequest();
     void clearAllCanMasksRequest();
+    void setPositiveCanMasksRequest(const RequestTokenizer &request);
+    void setNegativeCanMasksRequest(const RequestTokenizer &request);
+    void canReceiveOverflowsRequest();
+    void canBatchSizeRequest(const RequestTokenizer &request);
+    void forwardReceivedCanMessages();
+    void flushCanBatch();
+    char *appendHex(char *out, uint32_t value, uint8_t digits);
     void sendCanMessage(const CanMessage &msg);
+    void canReceiveInterrupt();
+    void serviceCanReceiveInterrupt();
+    void suspendCanReceiveInterrupt();
+    void resumeCanReceiveInterrupt();
     #define SPI_CS_PIN 9 
+    #define CAN_INTERRUPT_PIN 2
     MCP_CAN *canController{new MCP_CAN(SPI_CS_PIN)};
+    static CanReceiveRing canReceiveRing;
+
+    /* With live update on and a batch size above 1, received frames are gathered and pushed as
+     * one canbatch:count:id:data:...:result line, flushed when it holds canBatchSize frames or its
+     * oldest frame is CAN_BATCH_MAXIMUM_AGE ms old. An extended ID is always written as 8 digits */
+    #define CAN_BATCH_MAXIMUM_FRAMES 8
+    #define CAN_BATCH_MAXIMUM_AGE 5
+    #define CAN_STANDARD_ID_DIGITS 3
+    #define CAN_EXTENDED_ID_DIGITS 8
+    #define CAN_BATCH_LINE_SIZE 240
+    static uint8_t canBatchSize{1};
+    static CanReceiveRecord canBatch[CAN_BATCH_MAXIMUM_FRAMES];
+    static uint8_t canBatchCount{0};
+    static unsigned long canBatchStartTime{0};
     #define CAN_CONNECTION_TIMEOUT 1000
     #define CAN_WRITE_REQUEST_SIZE 10
     #define CAN_BUS_NOT_INITIALIZED -9
@@ -208,6 +287,13 @@ uint8_t pwmPinArraySize();
     uint8_t numberOfPositiveCanMasks();
     uint8_t numberOfNegativeCanMasks();
     void initializeCanMasks();
+    bool replaceCanMasks(uint32_t *masks, uint8_t maximumMasks, const RequestTokenizer &request);
+    #define MAX_STANDARD_CAN_ID 0x7FF
+    #define MAX_EXTENDED_CAN_ID 0x1FFFFFFF
+    static bool canHardwareFiltering{false};
+    void applyCanHardwareFilters();
+    void assignCanReceiveBuffer(uint8_t buffer, const uint32_t *ids, uint8_t idCount, INT8U extended, INT8U *maskExt, INT32U *masks, INT8U *filterExt, INT32U *filters);
+    bool canMessageAccepted(uint32_t canID);
     
     void addLastCanMessage(const CanMessage &msg);
     #define CAN_NORMAL_FRAME 0
@@ -265,6 +351,10 @@ uint8_t pwmPinArraySize();
 
 #endif
 static uint8_t softwareSerialPortIndex{0};
+static LineAssembler hardwareSerialLineAssemblers[NUMBER_OF_HARDWARE_SERIAL_PORTS];
+static LineAssembler softwareSerialLineAssemblers[MAXIMUM_SOFTWARE_SERIAL_PORTS];
+static BinaryFrameAssembler hardwareSerialBinaryFrameAssemblers[NUMBER_OF_HARDWARE_SERIAL_PORTS];
+static BinaryFrameAssembler softwareSerialBinaryFrameAssemblers[MAXIMUM_SOFTWARE_SERIAL_PORTS];
 static GPIO *gpioPins[NUMBER_OF_PINS];
 
 void initializeSerialPorts();
@@ -277,30 +367,28 @@ Stream *defaultNativePort{hardwareSerialPorts[0]};
 bool isValidSoftwareSerialAddition(int8_t rxPinNumber, int8_t txPinNumber);
 bool isValidHardwareSerialAddition(int8_t rxPinNumber, int8_t txPinNumber);
 
-template <typename Parameter> Stream &operator<<(Stream &lhs, const Parameter &parameter)
-{
-    lhs.print(parameter);
-    return lhs;
-}
-
 template <typename Header, typename PinNumber, typename State, typename ResultCode> inline void printResult(const Header &header, PinNumber pinNumber, State state, ResultCode resultCode)
-{    
-    *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << pinNumber << ITEM_SEPARATOR << state << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+{
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << header << ITEM_SEPARATOR << pinNumber << ITEM_SEPARATOR << state << ITEM_SEPARATOR << resultCode << LINE_ENDING;
 }
 
 template <typename Header, typename ResultCode> inline void printSingleResult(const Header &header, ResultCode resultCode)
 {
-    *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << header << ITEM_SEPARATOR << resultCode << LINE_ENDING;
 }
 
 template <typename Header, typename Type, typename ResultCode> inline void printTypeResult(const Header &header, Type type, ResultCode resultCode)
 {
-    *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << type << ITEM_SEPARATOR << resultCode << LINE_ENDING; 
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << header << ITEM_SEPARATOR << type << ITEM_SEPARATOR << resultCode << LINE_ENDING;
 }
 
 template <typename Parameter> inline void printString(const Parameter &parameter)
 {
-    *getCurrentValidOutputStream() << parameter << LINE_ENDING;
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << parameter << LINE_ENDING;
 }
 
 void setup() {
@@ -314,47 +402,23 @@ void setup() {
 
 void loop() {
     for (unsigned int i = 0; i < ARRAY_SIZE(hardwareSerialPorts); i++) {
-        Stream *it{nullptr};
-        if (hardwareSerialPorts + i) {
-            if (hardwareSerialPorts[i]) {
-                it = hardwareSerialPorts[i];
-            }
-        }
-        if (!it) {
-            continue;
-        }
-        if (it->available()) {
-            char buffer[MAXIMUM_SERIAL_READ_SIZE];
-            int serialRead{it->readBytesUntil(LINE_ENDING, buffer, MAXIMUM_SERIAL_READ_SIZE)};
-            if (serialRead > 0) {
-                currentSerialStream = it;
-                handleSerialString(buffer);
-            }
+        if (hardwareSerialPorts[i]) {
+            serviceSerialPort(hardwareSerialPorts[i], &hardwareSerialLineAssemblers[i], &hardwareSerialBinaryFrameAssemblers[i]);
         }
     }
     for (unsigned int i = 0; i < ARRAY_SIZE(softwareSerialPorts); i++) {
-        Stream *it{nullptr};
-        if (softwareSerialPorts + i) {
-            if (softwareSerialPorts[i]) {
-                it = softwareSerialPorts[i];
-            }
-        }
-        if (!it) {
-            continue;
-        }
-        if (it->available()) {
-            char buffer[MAXIMUM_SERIAL_READ_SIZE]; 
-            int serialRead{it->readBytesUntil(LINE_ENDING, buffer, MAXIMUM_SERIAL_READ_SIZE)};
-            if (serialRead > 0) {
-                currentSerialStream = it;
-                handleSerialString(buffer);
-            }
+        if (softwareSerialPorts[i]) {
+            serviceSerialPort(softwareSerialPorts[i], &softwareSerialLineAssemblers[i], &softwareSerialBinaryFrameAssemblers[i]);
         }
     }
+    if (ioStreamInterval != IO_STREAM_STOPPED) {
+        ioStreamUpdate();
+    }
     
     #if defined(__HAVE_CAN_BUS__)
+        serviceCanReceiveInterrupt();
         if (canLiveUpdate) {
-            canReadRequest(canLiveUpdate);
+            forwardReceivedCanMessages();
         }
         bool canSend{false};
         for (int i = 0; i < MAX_LAST_CAN_MESSAGES; i++) {
@@ -380,6 +444,26 @@ void loop() {
     doImAliveBlink();
 }
 
+/* Only takes the bytes the port already has, so a client that sends a line or a binary frame in
+ * pieces holds up nothing but its own request. A binary frame can only start where a text line
+ * could, and once started the port's bytes go to it until it is complete */
+void serviceSerialPort(Stream *stream, LineAssembler *lineAssembler, BinaryFrameAssembler *binaryFrameAssembler)
+{
+    if ((!binaryFrameAssembler->empty()) || (binaryFramingEnabled && lineAssembler->empty() && (stream->available()) && (stream->peek() == BINARY_FRAME_SYNC))) {
+        if (binaryFrameAssembler->poll(stream)) {
+            currentSerialStream = stream;
+            handleBinaryFrame(binaryFrameAssembler);
+            binaryFrameAssembler->clear();
+        }
+        return;
+    }
+    if (lineAssembler->poll(stream)) {
+        currentSerialStream = stream;
+        handleSerialString(lineAssembler->line());
+        lineAssembler->clear();
+    }
+}
+
 void doImAliveBlink()
 {
     #define LED_PIN 13
@@ -403,226 +487,185 @@ void doImAliveBlink()
     }
 }
 
-void handleSerialString(const char *str)
+void handleSerialString(char *str)
 {
     if ((!str) || (strlen(str)) == 0) {
         return;
     } 
     Serial.print("str = ");
     Serial.println(str);
-    char requestString[SMALL_BUFFER_SIZE];
-    int substringResult{0};
-    (void)substringResult;
-    if (startsWith(str, ANALOG_READ_HEADER)) {
-        if (checkValidRequestString(ANALOG_READ_HEADER, str)) {
-            substringResult = makeRequestString(str, ANALOG_READ_HEADER, requestString, SMALL_BUFFER_SIZE);
-            analogReadRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, CHANGE_A_TO_D_THRESHOLD_HEADER)) {
-        if (checkValidRequestString(CHANGE_A_TO_D_THRESHOLD_HEADER, str)) {
-            substringResult = makeRequestString(str, CHANGE_A_TO_D_THRESHOLD_HEADER, requestString, SMALL_BUFFER_SIZE);
-            changeAToDThresholdRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, ANALOG_WRITE_HEADER)) {
-        if (checkValidRequestString(ANALOG_WRITE_HEADER, str)) {
-            substringResult = makeRequestString(str, ANALOG_WRITE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            analogWriteRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, DIGITAL_READ_HEADER)) {
-        if (checkValidRequestString(DIGITAL_READ_HEADER, str)) {
-            substringResult = makeRequestString(str, DIGITAL_READ_HEADER, requestString, SMALL_BUFFER_SIZE);
-            digitalReadRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, DIGITAL_WRITE_ALL_HEADER)) {
-        if (checkValidRequestString(DIGITAL_WRITE_ALL_HEADER, str)) {
-            substringResult = makeRequestString(str, DIGITAL_WRITE_ALL_HEADER, requestString, SMALL_BUFFER_SIZE);
-            digitalWriteAllRequest(requestString);
-        } else {
-            printTypeResult(DIGITAL_WRITE_ALL_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, DIGITAL_WRITE_HEADER)) {
-        if (checkValidRequestString(DIGITAL_WRITE_HEADER, str)) {
-            substringResult = makeRequestString(str, DIGITAL_WRITE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            digitalWriteRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, PIN_TYPE_HEADER)) {
-        if (checkValidRequestString(PIN_TYPE_HEADER, str)) {
-            substringResult = makeRequestString(str, PIN_TYPE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            pinTypeRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, PIN_TYPE_CHANGE_HEADER)) {
-        if (checkValidRequestString(PIN_TYPE_CHANGE_HEADER, str)) {
-            substringResult = makeRequestString(str, PIN_TYPE_CHANGE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            pinTypeChangeRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, SOFT_DIGITAL_READ_HEADER)) {
-        if (checkValidRequestString(SOFT_DIGITAL_READ_HEADER, str)) {
-            substringResult = makeRequestString(str, SOFT_DIGITAL_READ_HEADER, requestString, SMALL_BUFFER_SIZE);
-            softDigitalReadRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, SOFT_ANALOG_READ_HEADER)) {
-        if (checkValidRequestString(SOFT_ANALOG_READ_HEADER, str)) {
-            substringResult = makeRequestString(str, SOFT_ANALOG_READ_HEADER, requestString, SMALL_BUFFER_SIZE);
-            softAnalogReadRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, FIRMWARE_VERSION_HEADER)) {
-        firmwareVersionRequest();
-    } else if (startsWith(str, IO_REPORT_HEADER)) {
-        ioReportRequest();
-    } else if (startsWith(str, CURRENT_A_TO_D_THRESHOLD_HEADER)) {
-        currentAToDThresholdRequest();
-    } else if (startsWith(str, ARDUINO_TYPE_HEADER)) {
-        arduinoTypeRequest();
-    } else if (startsWith(str, CAN_BUS_ENABLED_HEADER)) {
-        canBusEnabledRequest();
-    } else if (startsWith(str, LIN_BUS_ENABLED_HEADER)) {
-        linBusEnabledRequest();   
+    RequestType type{requestType(str)};
+    if (type == UNKNOWN_REQUEST) {
+        printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
+        return;
+    }
+    RequestTokenizer request{str, ITEM_SEPARATOR};
+    switch (type) {
+        case ANALOG_READ_MULTI_REQUEST:
+            dispatchRequest(request, analogReadMultiRequest);
+            break;
+        case ANALOG_READ_REQUEST:
+            dispatchRequest(request, analogReadRequest);
+            break;
+        case CHANGE_A_TO_D_THRESHOLD_REQUEST:
+            dispatchRequest(request, changeAToDThresholdRequest);
+            break;
+        case ANALOG_WRITE_REQUEST:
+            dispatchRequest(request, analogWriteRequest);
+            break;
+        case DIGITAL_READ_MULTI_REQUEST:
+            dispatchRequest(request, digitalReadMultiRequest);
+            break;
+        case DIGITAL_READ_REQUEST:
+            dispatchRequest(request, digitalReadRequest);
+            break;
+        case DIGITAL_WRITE_MULTI_REQUEST:
+            dispatchRequest(request, digitalWriteMultiRequest);
+            break;
+        case DIGITAL_WRITE_ALL_REQUEST:
+            dispatchRequest(request, digitalWriteAllRequest, DIGITAL_WRITE_ALL_HEADER);
+            break;
+        case DIGITAL_WRITE_REQUEST:
+            dispatchRequest(request, digitalWriteRequest);
+            break;
+        case PIN_TYPE_REQUEST:
+            dispatchRequest(request, pinTypeRequest);
+            break;
+        case PIN_TYPE_CHANGE_REQUEST:
+            dispatchRequest(request, pinTypeChangeRequest);
+            break;
+        case SOFT_DIGITAL_READ_REQUEST:
+            dispatchRequest(request, softDigitalReadRequest);
+            break;
+        case SOFT_ANALOG_READ_REQUEST:
+            dispatchRequest(request, softAnalogReadRequest);
+            break;
+        case BINARY_MODE_REQUEST:
+            dispatchRequest(request, binaryModeRequest);
+            break;
+        case FIRMWARE_VERSION_REQUEST:
+            firmwareVersionRequest();
+            break;
+        case IO_REPORT_DELTA_REQUEST:
+            ioReportDeltaRequest(request);
+            break;
+        case IO_DEADBAND_REQUEST:
+            dispatchRequest(request, ioDeadbandRequest);
+            break;
+        case IO_STREAM_REQUEST:
+            dispatchRequest(request, ioStreamRequest);
+            break;
+        case IO_REPORT_REQUEST:
+            ioReportRequest();
+            break;
+        case CURRENT_A_TO_D_THRESHOLD_REQUEST:
+            currentAToDThresholdRequest();
+            break;
+        case ARDUINO_TYPE_REQUEST:
+            arduinoTypeRequest();
+            break;
+        case CAN_BUS_ENABLED_REQUEST:
+            canBusEnabledRequest();
+            break;
+        case LIN_BUS_ENABLED_REQUEST:
+            linBusEnabledRequest();
+            break;
 #if defined(__HAVE_CAN_BUS__)
-    } else if (startsWith(str, CAN_INIT_HEADER)) {
-        canInitRequest();
-    } else if (startsWith(str, CAN_READ_HEADER)) {
-        canReadRequest(false);
-    } else if (startsWith(str, CAN_WRITE_ONCE_HEADER)) {
-        if (checkValidRequestString(CAN_WRITE_ONCE_HEADER, str)) {
-            substringResult = makeRequestString(str, CAN_WRITE_ONCE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            canWriteRequest(requestString, true);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    /*
-    } else if (startsWith(str, CAN_WRITE_HEADER)) {
-        if (checkValidRequestString(CAN_WRITE_HEADER, str)) {
-            substringResult = makeRequestString(str, CAN_WRITE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            canWriteRequest(requestString, false);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    */
-    } else if (startsWith(str, CAN_LIVE_UPDATE_HEADER)) {
-        if (checkValidRequestString(CAN_LIVE_UPDATE_HEADER, str)) {
-            substringResult = makeRequestString(str, CAN_LIVE_UPDATE_HEADER, requestString, SMALL_BUFFER_SIZE);
-            canLiveUpdateRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, CLEAR_CAN_MESSAGE_BY_ID_HEADER)) {
-        if (checkValidRequestString(CLEAR_CAN_MESSAGE_BY_ID_HEADER, str)) {
-            substringResult = makeRequestString(str, CLEAR_CAN_MESSAGE_BY_ID_HEADER, requestString, SMALL_BUFFER_SIZE);
-            clearCurrentMessageByIdRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, CURRENT_CAN_MESSAGE_BY_ID_HEADER)) {
-        if (checkValidRequestString(CURRENT_CAN_MESSAGE_BY_ID_HEADER, str)) {
-            substringResult = makeRequestString(str, CURRENT_CAN_MESSAGE_BY_ID_HEADER, requestString, SMALL_BUFFER_SIZE);
-            currentCachedCanMessageByIdRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, REMOVE_NEGATIVE_CAN_MASK_HEADER)) {
-        if (checkValidRequestString(REMOVE_NEGATIVE_CAN_MASK_HEADER, str)) {
-            substringResult = makeRequestString(str, REMOVE_NEGATIVE_CAN_MASK_HEADER, requestString, SMALL_BUFFER_SIZE);
-            removeNegativeCanMaskRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, REMOVE_POSITIVE_CAN_MASK_HEADER)) {
-        if (checkValidRequestString(REMOVE_POSITIVE_CAN_MASK_HEADER, str)) {
-            substringResult = makeRequestString(str, REMOVE_POSITIVE_CAN_MASK_HEADER, requestString, SMALL_BUFFER_SIZE);
-            removePositiveCanMaskRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, ADD_POSITIVE_CAN_MASK_HEADER)) {
-        if (checkValidRequestString(ADD_POSITIVE_CAN_MASK_HEADER, str)) {
-            substringResult = makeRequestString(str, ADD_POSITIVE_CAN_MASK_HEADER, requestString, SMALL_BUFFER_SIZE);
-            addPositiveCanMaskRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, ADD_NEGATIVE_CAN_MASK_HEADER)) {
-        if (checkValidRequestString(ADD_NEGATIVE_CAN_MASK_HEADER, str)) {
-            substringResult = makeRequestString(str, ADD_NEGATIVE_CAN_MASK_HEADER, requestString, SMALL_BUFFER_SIZE);
-            addNegativeCanMaskRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, CURRENT_CAN_MESSAGES_HEADER)) {
-        currentCachedCanMessagesRequest();
-    } else if (startsWith(str, CLEAR_CAN_MESSAGES_HEADER)) {
-        clearCanMessagesRequest();
-    } else if (startsWith(str, ALL_CURRENT_CAN_MASKS_HEADER)) {
-        allCurrentCanMasksRequest();
-    } else if (startsWith(str, CURRENT_POSITIVE_CAN_MASKS_HEADER)) {
-        currentPositiveCanMasksRequest();
-    } else if (startsWith(str, CURRENT_NEGATIVE_CAN_MASKS_HEADER)) {
-        currentNegativeCanMasksRequest();
-    } else if (startsWith(str, CLEAR_POSITIVE_CAN_MASKS_HEADER)) {
-        clearPositiveCanMasksRequest();
-    } else if (startsWith(str, CLEAR_NEGATIVE_CAN_MASKS_HEADER)) {
-        clearNegativeCanMasksRequest();
-    } else if (startsWith(str, CLEAR_ALL_CAN_MASKS_HEADER)) {
-        clearAllCanMasksRequest();
+        case CAN_INIT_REQUEST:
+            canInitRequest();
+            break;
+        case CAN_READ_REQUEST:
+            canReadRequest(false);
+            break;
+        case CAN_WRITE_ONCE_REQUEST:
+            dispatchRequest(request, [](const RequestTokenizer &request) { canWriteRequest(request, true); });
+            break;
+        case CAN_LIVE_UPDATE_REQUEST:
+            dispatchRequest(request, canLiveUpdateRequest);
+            break;
+        case CLEAR_CAN_MESSAGE_BY_ID_REQUEST:
+            dispatchRequest(request, clearCurrentMessageByIdRequest);
+            break;
+        case CURRENT_CAN_MESSAGE_BY_ID_REQUEST:
+            dispatchRequest(request, currentCachedCanMessageByIdRequest);
+            break;
+        case REMOVE_NEGATIVE_CAN_MASK_REQUEST:
+            dispatchRequest(request, removeNegativeCanMaskRequest);
+            break;
+        case REMOVE_POSITIVE_CAN_MASK_REQUEST:
+            dispatchRequest(request, removePositiveCanMaskRequest);
+            break;
+        case ADD_POSITIVE_CAN_MASK_REQUEST:
+            dispatchRequest(request, addPositiveCanMaskRequest);
+            break;
+        case ADD_NEGATIVE_CAN_MASK_REQUEST:
+            dispatchRequest(request, addNegativeCanMaskRequest);
+            break;
+        case SET_POSITIVE_CAN_MASKS_REQUEST:
+            dispatchRequest(request, setPositiveCanMasksRequest);
+            break;
+        case SET_NEGATIVE_CAN_MASKS_REQUEST:
+            dispatchRequest(request, setNegativeCanMasksRequest);
+            break;
+        case CURRENT_CAN_MESSAGES_REQUEST:
+            currentCachedCanMessagesRequest();
+            break;
+        case CLEAR_CAN_MESSAGES_REQUEST:
+            clearCanMessagesRequest();
+            break;
+        case ALL_CURRENT_CAN_MASKS_REQUEST:
+            allCurrentCanMasksRequest();
+            break;
+        case CURRENT_POSITIVE_CAN_MASKS_REQUEST:
+            currentPositiveCanMasksRequest();
+            break;
+        case CURRENT_NEGATIVE_CAN_MASKS_REQUEST:
+            currentNegativeCanMasksRequest();
+            break;
+        case CLEAR_POSITIVE_CAN_MASKS_REQUEST:
+            clearPositiveCanMasksRequest();
+            break;
+        case CLEAR_NEGATIVE_CAN_MASKS_REQUEST:
+            clearNegativeCanMasksRequest();
+            break;
+        case CLEAR_ALL_CAN_MASKS_REQUEST:
+            clearAllCanMasksRequest();
+            break;
+        case CAN_RECEIVE_OVERFLOWS_REQUEST:
+            canReceiveOverflowsRequest();
+            break;
+        case CAN_BATCH_SIZE_REQUEST:
+            dispatchRequest(request, canBatchSizeRequest);
+            break;
 #endif
 #if defined(__HAVE_LIN_BUS__)
 
 #endif
-    } else if (startsWith(str, ADD_SOFTWARE_SERIAL_HEADER)) {
-        if (checkValidRequestString(ADD_SOFTWARE_SERIAL_HEADER, str)) {
-            substringResult = makeRequestString(str, ADD_SOFTWARE_SERIAL_HEADER, requestString, SMALL_BUFFER_SIZE);
-            addSoftwareSerialRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else if (startsWith(str, REMOVE_SOFTWARE_SERIAL_HEADER)) {
-        if (checkValidRequestString(REMOVE_SOFTWARE_SERIAL_HEADER, str)) {
-            substringResult = makeRequestString(str, REMOVE_SOFTWARE_SERIAL_HEADER, requestString, SMALL_BUFFER_SIZE);
-            removeSoftwareSerialRequest(requestString);
-        } else {
-            printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
-        }
-    } else {
-        printTypeResult(INVALID_HEADER, str, OPERATION_FAILURE);
+        case ADD_SOFTWARE_SERIAL_REQUEST:
+            dispatchRequest(request, addSoftwareSerialRequest);
+            break;
+        case REMOVE_SOFTWARE_SERIAL_REQUEST:
+            dispatchRequest(request, removeSoftwareSerialRequest);
+            break;
+        default:
+            printTypeResult(INVALID_HEADER, request.header(), OPERATION_FAILURE);
+            break;
     }
-
 }
 
-size_t makeRequestString(const char *str, const char *header, char *out, size_t maximumSize)
+//Hands a request with arguments to handler, or reports it as failed if nothing follows the header
+void dispatchRequest(const RequestTokenizer &request, void (*handler)(const RequestTokenizer &), const char *failureHeader)
 {
-    int returnLength{substring(str, strlen(header) + 1, out, maximumSize)};
-    size_t stringLength{strlen(out)};
-    if ((out[stringLength - 1] == '\n') || (out[stringLength - 1] == '\r')) {
-        out[stringLength - 1] = '\0';
-        returnLength--;
+    if (request.hasArguments()) {
+        handler(request);
+    } else {
+        printTypeResult(failureHeader, request.header(), OPERATION_FAILURE);
     }
-    return returnLength;
 }
 
-void addSoftwareSerialRequest(const char *str)
+void addSoftwareSerialRequest(const RequestTokenizer &request)
 {
-    int foundPosition{positionOfSubstring(str, ITEM_SEPARATOR)};
-    char maybeRxPin[SMALL_BUFFER_SIZE];
-    int result{substring(str, 0, foundPosition, maybeRxPin, SMALL_BUFFER_SIZE)};
-    (void)result;
- 
+    const char *maybeRxPin{request.argument(0)};
     int8_t rxPinNumber{parsePin(maybeRxPin)};
     if (rxPinNumber == INVALID_PIN) {
         printResult(ADD_SOFTWARE_SERIAL_HEADER, maybeRxPin, STATE_FAILURE, OPERATION_FAILURE);
@@ -637,8 +680,7 @@ void addSoftwareSerialRequest(const char *str)
         return;
     }
 
-    char maybeTxPin[SMALL_BUFFER_SIZE];
-    result = substring(str, foundPosition+1, maybeTxPin, SMALL_BUFFER_SIZE);
+    const char *maybeTxPin{request.argument(1)};
     
     int8_t txPinNumber{parsePin(maybeTxPin)};
     if (txPinNumber == INVALID_PIN) {
@@ -665,6 +707,8 @@ void addSoftwareSerialRequest(const char *str)
     }
     if (isValidSoftwareSerialAddition(rxPinNumber, txPinNumber)) {
         softwareSerialPorts[softwareSerialPortIndex] = new SoftwareSerial{static_cast<uint8_t>(rxPinNumber), static_cast<uint8_t>(txPinNumber)};
+        softwareSerialLineAssemblers[softwareSerialPortIndex].clear();
+        softwareSerialBinaryFrameAssemblers[softwareSerialPortIndex].clear();
         softwareSerialPorts[softwareSerialPortIndex]->begin(SERIAL_BAUD);
         softwareSerialRxPins[softwareSerialPortIndex] = rxPinNumber;
         softwareSerialTxPins[softwareSerialPortIndex] = txPinNumber;
@@ -675,13 +719,9 @@ void addSoftwareSerialRequest(const char *str)
     }
 }
 
-void removeSoftwareSerialRequest(const char *str)
+void removeSoftwareSerialRequest(const RequestTokenizer &request)
 {
-    int foundPosition{positionOfSubstring(str, ITEM_SEPARATOR)};
-    char maybeRxPin[SMALL_BUFFER_SIZE];
-    int result{substring(str, 0, foundPosition, maybeRxPin, SMALL_BUFFER_SIZE)};
-    (void)result;
- 
+    const char *maybeRxPin{request.argument(0)};
     int8_t rxPinNumber{parsePin(maybeRxPin)};
     if (rxPinNumber == INVALID_PIN) {
         printResult(REMOVE_SOFTWARE_SERIAL_HEADER, maybeRxPin, STATE_FAILURE, OPERATION_INVALID_PIN);
@@ -695,8 +735,7 @@ void removeSoftwareSerialRequest(const char *str)
         printResult(REMOVE_SOFTWARE_SERIAL_HEADER, maybeRxPin, STATE_FAILURE, OPERATION_PIN_HAS_SECONDARY_FUNCTION);
         return;
     }
-    char maybeTxPin[SMALL_BUFFER_SIZE];
-    result = substring(str, foundPosition+1, maybeTxPin, SMALL_BUFFER_SIZE);
+    const char *maybeTxPin{request.argument(1)};
 
     int8_t txPinNumber{parsePin(maybeTxPin)};
     if (txPinNumber == INVALID_PIN) {
@@ -720,6 +759,8 @@ void removeSoftwareSerialRequest(const char *str)
                     //softwareSerialPorts[i]->setEnabled(false);
                     delete softwareSerialPorts[i];
                     softwareSerialPorts[i] = nullptr;
+                    softwareSerialLineAssemblers[i].clear();
+                    softwareSerialBinaryFrameAssemblers[i].clear();
                     softwareSerialRxPins[i] = SERIAL_PIN_NOT_IN_USE;
                     softwareSerialTxPins[i] = SERIAL_PIN_NOT_IN_USE;
                     printResult(REMOVE_SOFTWARE_SERIAL_HEADER, maybeRxPin, maybeTxPin, OPERATION_SUCCESS);
@@ -758,18 +799,7 @@ bool isValidSoftwareSerialAddition(int8_t rxPinNumber, int8_t txPinNumber)
             return false;
         } 
         
-        int i{0};
-        do {
-            int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_SERIAL_RX_PINS + i++)};
-            if (tempPinNumber < 0) {
-                break;
-            }
-            if (tempPinNumber == rxPinNumber) {
-                return true;
-            }
-        } while (true);
-
-        return false; 
+        return pinMaskTest(SERIAL_RX_PIN_MASK, rxPinNumber);
     #else
         return true;
     #endif
@@ -799,9 +829,9 @@ bool isValidHardwareSerialAddition(int rxPinNumber, int txPinNumber)
     #endif
 }
 
-void changeAToDThresholdRequest(const char *str)
+void changeAToDThresholdRequest(const RequestTokenizer &request)
 {
-    int maybeState{parseToAnalogState(str)};
+    int maybeState{parseToAnalogState(request.argument(0))};
     if (maybeState == OPERATION_FAILURE) {
         printTypeResult(CHANGE_A_TO_D_THRESHOLD_HEADER, STATE_FAILURE, OPERATION_INVALID_STATE);
         return;
@@ -817,21 +847,86 @@ void currentAToDThresholdRequest()
 
 void ioReportRequest()
 {
-    *getCurrentValidOutputStream() << IO_REPORT_HEADER << ITEM_SEPARATOR;
+    writeIOReport(getCurrentValidOutputStream(), IO_REPORT_HEADER, false, false);
+}
+
+/* Same layout as ioReportRequest, but only with the pins that changed since they were last
+ * reported (see GPIO::reportedStateChanged). A "1" argument forgets every reported state
+ * first, so the reply carries every pin and the host can rebuild its view from scratch */
+void ioReportDeltaRequest(const RequestTokenizer &request)
+{
+    if (request.hasArguments()) {
+        int resynchronize{parseToDigitalState(request.argument(0))};
+        if (resynchronize == OPERATION_FAILURE) {
+            printTypeResult(IO_REPORT_DELTA_HEADER, request.argument(0), OPERATION_INVALID_STATE);
+            return;
+        }
+        if (resynchronize == HIGH) {
+            clearReportedStates();
+        }
+    }
+    writeIOReport(getCurrentValidOutputStream(), IO_REPORT_DELTA_HEADER, true, false);
+}
+
+void clearReportedStates()
+{
+    for (int i = 0; i < NUMBER_OF_PINS; i++) {
+        GPIO *gpioPin{gpioPinByPinNumber(i)};
+        if (gpioPin) {
+            gpioPin->clearReportedState();
+        }
+    }
+}
+
+void ioDeadbandRequest(const RequestTokenizer &request)
+{
+    long deadband{parseToUnsignedValue(request.argument(0))};
+    if ((deadband == OPERATION_FAILURE) || (deadband > GPIO::ANALOG_MAX)) {
+        printTypeResult(IO_DEADBAND_HEADER, STATE_FAILURE, OPERATION_INVALID_STATE);
+        return;
+    }
+    GPIO::setAnalogReportDeadband(deadband);
+    printTypeResult(IO_DEADBAND_HEADER, GPIO::analogReportDeadband(), OPERATION_SUCCESS);
+}
+
+int ioReportState(GPIO *gpioPin)
+{
+    if ((gpioPin->ioType() == IOType::DIGITAL_INPUT) || (gpioPin->ioType() == IOType::DIGITAL_INPUT_PULLUP)) {
+        return gpioPin->g_digitalRead();
+    } else if (gpioPin->ioType() == IOType::DIGITAL_OUTPUT) {
+        return gpioPin->g_softDigitalRead();
+    } else if (gpioPin->ioType() == IOType::ANALOG_INPUT) {
+        return gpioPin->g_analogRead();
+    } else if (gpioPin->ioType() == IOType::ANALOG_OUTPUT) {
+        return gpioPin->g_softAnalogRead();
+    }
+    return 0;
+}
+
+/* Writes header followed by pin:type:state for every pin (or, if changedOnly, every pin whose
+ * state moved since it was last reported) and records what was sent as the new reported state.
+ * With skipIfUnchanged nothing at all is written when no pin qualifies */
+void writeIOReport(Stream *stream, const char *header, bool changedOnly, bool skipIfUnchanged)
+{
+    ResponseBuilder<Stream> response{stream};
+    bool headerWritten{false};
+    if (!skipIfUnchanged) {
+        response << header << ITEM_SEPARATOR;
+        headerWritten = true;
+    }
     for (int i = 0; i < NUMBER_OF_PINS; i++) {
         GPIO *gpioPin{gpioPinByPinNumber(i)};
         if (!gpioPin) {
             continue;
         }
-        int state{0};
-        if ((gpioPin->ioType() == IOType::DIGITAL_INPUT) || (gpioPin->ioType() == IOType::DIGITAL_INPUT_PULLUP)) {
-            state = gpioPin->g_digitalRead();
-        } else if (gpioPin->ioType() == IOType::DIGITAL_OUTPUT) {
-            state = gpioPin->g_softDigitalRead();
-        } else if (gpioPin->ioType() == IOType::ANALOG_INPUT) {
-            state = gpioPin->g_analogRead();
-        } else if (gpioPin->ioType() == IOType::ANALOG_OUTPUT) {
-            state = gpioPin->g_softAnalogRead();
+        int state{ioReportState(gpioPin)};
+        if ((changedOnly) && (!gpioPin->reportedStateChanged(state))) {
+            continue;
+        }
+        gpioPin->setReportedState(state);
+        if (!headerWritten) {
+            response << header << ITEM_SEPARATOR;
+            headerWritten = true;
         }
         if (isValidAnalogInputPin(gpioPin->pinNumber())) {
             char analogPinString[SMALL_BUFFER_SIZE];
@@ -840,20 +935,203 @@ void ioReportRequest()
             int8_t secondResult{getIOTypeString(gpioPin->ioType(), ioTypeString, SMALL_BUFFER_SIZE)};
             (void)result;
             (void)secondResult;
-            *getCurrentValidOutputStream() << ITEM_SEPARATOR << analogPinString << ITEM_SEPARATOR << ioTypeString << ITEM_SEPARATOR << state;
+            response << ITEM_SEPARATOR << analogPinString << ITEM_SEPARATOR << ioTypeString << ITEM_SEPARATOR << state;
         } else {
             char ioTypeString[SMALL_BUFFER_SIZE];
             int result{getIOTypeString(gpioPin->ioType(), ioTypeString, SMALL_BUFFER_SIZE)};
             (void)result;
-            *getCurrentValidOutputStream() << ITEM_SEPARATOR << gpioPin->pinNumber() << ITEM_SEPARATOR << ioTypeString << ITEM_SEPARATOR << state;
+            response << ITEM_SEPARATOR << gpioPin->pinNumber() << ITEM_SEPARATOR << ioTypeString << ITEM_SEPARATOR << state;
         }
     }
-    *getCurrentValidOutputStream() << ITEM_SEPARATOR << IO_REPORT_END_HEADER << LINE_ENDING;
+    if (headerWritten) {
+        response << ITEM_SEPARATOR << IO_REPORT_END_HEADER << LINE_ENDING;
+    }
 }
 
-void softDigitalReadRequest(const char *str)
+/* Fletcher-16 over every pin's type and state, so on change streaming can
+ * tell whether anything moved without keeping a copy of the last report */
+uint16_t ioReportChecksum()
 {
-    int8_t pinNumber{parsePin(str)};
+    uint16_t sumA{0};
+    uint16_t sumB{0};
+    for (int i = 0; i < NUMBER_OF_PINS; i++) {
+        GPIO *gpioPin{gpioPinByPinNumber(i)};
+        if (!gpioPin) {
+            continue;
+        }
+        int state{ioReportState(gpioPin)};
+        uint8_t bytes[3]{static_cast<uint8_t>(gpioPin->ioType()), static_cast<uint8_t>(state & 0xFF), static_cast<uint8_t>((state >> 8) & 0xFF)};
+        for (uint8_t j = 0; j < ARRAY_SIZE(bytes); j++) {
+            sumA = (sumA + bytes[j]) % 255;
+            sumB = (sumB + sumA) % 255;
+        }
+    }
+    return static_cast<uint16_t>((sumB << 8) | sumA);
+}
+
+/* Starts pushing unsolicited IO reports (IO_STREAM_HEADER instead of IO_REPORT_HEADER, same
+ * layout) to the requesting port every interval milliseconds, or stops them for an interval
+ * of 0. The optional second item selects the mode: IO_STREAM_PERIODIC sends every pin each time,
+ * IO_STREAM_ON_CHANGE skips a report when no pin type or state changed since the last one, and
+ * IO_STREAM_DELTA sends only the changed pins (nothing at all if none changed). A delta stream
+ * starts from a clean slate, so its first report carries every pin */
+void ioStreamRequest(const RequestTokenizer &request)
+{
+    const char *intervalString{request.argument(0)};
+    const char *modeString{request.argument(1)};
+    if (intervalString[0] == '\0') {
+        printResult(IO_STREAM_HEADER, STATE_FAILURE, STATE_FAILURE, OPERATION_INVALID_PARAMETER_COUNT);
+        return;
+    }
+    long interval{parseToUnsignedValue(intervalString)};
+    if ((interval == OPERATION_FAILURE) || ((interval != IO_STREAM_STOPPED) && ((interval < IO_STREAM_MINIMUM_INTERVAL) || (interval > IO_STREAM_MAXIMUM_INTERVAL)))) {
+        printResult(IO_STREAM_HEADER, intervalString, STATE_FAILURE, OPERATION_INVALID_STATE);
+        return;
+    }
+    long mode{IO_STREAM_PERIODIC};
+    if (modeString[0] != '\0') {
+        mode = parseToUnsignedValue(modeString);
+        if ((mode == OPERATION_FAILURE) || (mode > IO_STREAM_DELTA)) {
+            printResult(IO_STREAM_HEADER, intervalString, modeString, OPERATION_INVALID_STATE);
+            return;
+        }
+    }
+    ioStreamInterval = interval;
+    ioStreamMode = mode;
+    if (ioStreamMode == IO_STREAM_DELTA) {
+        clearReportedStates();
+    }
+    ioStreamReportSent = false;
+    ioStreamLastTime = millis() - interval;
+    ioStreamOutput = getCurrentValidOutputStream();
+    printResult(IO_STREAM_HEADER, interval, mode, OPERATION_SUCCESS);
+}
+
+void ioStreamUpdate()
+{
+    unsigned long now{millis()};
+    if ((now - ioStreamLastTime) < ioStreamInterval) {
+        return;
+    }
+    ioStreamLastTime = now;
+    if (ioStreamMode == IO_STREAM_DELTA) {
+        writeIOReport(ioStreamOutput, IO_STREAM_HEADER, true, true);
+        return;
+    }
+    if (ioStreamMode == IO_STREAM_ON_CHANGE) {
+        uint16_t checksum{ioReportChecksum()};
+        if (ioStreamReportSent && (checksum == ioStreamLastChecksum)) {
+            return;
+        }
+        ioStreamLastChecksum = checksum;
+        ioStreamReportSent = true;
+    }
+    writeIOReport(ioStreamOutput, IO_STREAM_HEADER, false, false);
+}
+
+void binaryModeRequest(const RequestTokenizer &request)
+{
+    int state{parseToDigitalState(request.argument(0))};
+    if (state == OPERATION_FAILURE) {
+        printTypeResult(BINARY_MODE_HEADER, STATE_FAILURE, OPERATION_INVALID_STATE);
+        return;
+    }
+    binaryFramingEnabled = state;
+    printTypeResult(BINARY_MODE_HEADER, state, OPERATION_SUCCESS);
+}
+
+void handleBinaryFrame(BinaryFrameAssembler *binaryFrameAssembler)
+{
+    uint8_t *frame{binaryFrameAssembler->frame()};
+    uint8_t opcode{frame[BinaryFrame::OPCODE_OFFSET]};
+    uint8_t length{frame[BinaryFrame::LENGTH_OFFSET]};
+    if (binaryFrameAssembler->oversized()) {
+        printBinaryResult(BinaryFrame::INVALID_OPCODE, &opcode, 1);
+        return;
+    }
+    if (!BinaryFrame::isValid(frame, binaryFrameAssembler->length())) {
+        printBinaryResult(BinaryFrame::INVALID_OPCODE, &opcode, 1);
+        return;
+    }
+    binaryIORequest(opcode, frame + BinaryFrame::PAYLOAD_OFFSET, length);
+}
+
+/* Binary IO requests carry the pin number as the first payload byte, followed by the state
+ * to write for write requests (one byte for digital, two for analog). Every reply is the pin,
+ * the state (one byte for digital, two for analog) and the signed result code */
+void binaryIORequest(uint8_t opcode, const uint8_t *payload, uint8_t length)
+{
+    bool analogState{(opcode == BinaryFrame::ANALOG_READ) || (opcode == BinaryFrame::ANALOG_WRITE) || (opcode == BinaryFrame::SOFT_ANALOG_READ)};
+    uint8_t expectedLength{1};
+    bool (*isValidForRequest)(int8_t){nullptr};
+    if ((opcode == BinaryFrame::DIGITAL_READ) || (opcode == BinaryFrame::SOFT_DIGITAL_READ)) {
+        isValidForRequest = isValidDigitalInputPin;
+    } else if (opcode == BinaryFrame::DIGITAL_WRITE) {
+        isValidForRequest = isValidDigitalOutputPin;
+        expectedLength = 2;
+    } else if (opcode == BinaryFrame::ANALOG_READ) {
+        isValidForRequest = isValidAnalogInputPin;
+    } else if (opcode == BinaryFrame::ANALOG_WRITE) {
+        isValidForRequest = isValidAnalogOutputPin;
+        expectedLength = 3;
+    } else if (opcode == BinaryFrame::SOFT_ANALOG_READ) {
+        isValidForRequest = isValidAnalogOutputPin;
+    } else {
+        printBinaryResult(BinaryFrame::INVALID_OPCODE, &opcode, 1);
+        return;
+    }
+    uint8_t response[4]{0, 0, 0, 0};
+    uint8_t resultOffset{static_cast<uint8_t>(analogState ? 3 : 2)};
+    response[0] = (length > 0) ? payload[0] : static_cast<uint8_t>(INVALID_PIN);
+    GPIO *gpioHandle{(length > 0) ? gpioPinByPinNumber(payload[0]) : nullptr};
+    int resultCode{OPERATION_SUCCESS};
+    if (length != expectedLength) {
+        resultCode = OPERATION_INVALID_PARAMETER_COUNT;
+    } else if (!gpioHandle) {
+        resultCode = OPERATION_INVALID_PIN;
+    } else {
+        resultCode = checkPinAvailable(payload[0], isValidForRequest);
+    }
+    if (resultCode == OPERATION_SUCCESS) {
+        int state{0};
+        if ((opcode == BinaryFrame::DIGITAL_READ) || (opcode == BinaryFrame::SOFT_DIGITAL_READ)) {
+            state = (gpioHandle->ioType() == IOType::DIGITAL_OUTPUT) ? gpioHandle->g_softDigitalRead() : gpioHandle->g_digitalRead();
+        } else if (opcode == BinaryFrame::DIGITAL_WRITE) {
+            state = (payload[1] != 0);
+            gpioHandle->g_digitalWrite(state);
+        } else if (opcode == BinaryFrame::ANALOG_READ) {
+            state = gpioHandle->g_analogRead();
+        } else if (opcode == BinaryFrame::ANALOG_WRITE) {
+            state = BinaryFrame::getUInt16(payload + 1);
+            if (state > GPIO::ANALOG_MAX) {
+                state = GPIO::ANALOG_MAX;
+            }
+            gpioHandle->g_analogWrite(state);
+        } else {
+            state = gpioHandle->g_softAnalogRead();
+        }
+        if (analogState) {
+            BinaryFrame::putUInt16(response + 1, static_cast<uint16_t>(state));
+        } else {
+            response[1] = static_cast<uint8_t>(state);
+        }
+    }
+    response[resultOffset] = static_cast<uint8_t>(static_cast<int8_t>(resultCode));
+    printBinaryResult(opcode | BINARY_RESPONSE_FLAG, response, resultOffset + 1);
+}
+
+void printBinaryResult(uint8_t opcode, const uint8_t *payload, uint8_t length)
+{
+    uint8_t frame[BINARY_FRAME_MAXIMUM_SIZE];
+    size_t frameSize{BinaryFrame::encode(opcode, payload, length, frame, BINARY_FRAME_MAXIMUM_SIZE)};
+    if (frameSize > 0) {
+        getCurrentValidOutputStream()->write(frame, frameSize);
+    }
+}
+
+void softDigitalReadRequest(const RequestTokenizer &request)
+{
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(SOFT_DIGITAL_READ_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
         return;
@@ -882,9 +1160,9 @@ void softDigitalReadRequest(const char *str)
     printResult(SOFT_DIGITAL_READ_HEADER, static_cast<int16_t>(pinNumber), state, OPERATION_SUCCESS);
 }
 
-void digitalReadRequest(const char *str)
+void digitalReadRequest(const RequestTokenizer &request)
 {
-    int8_t pinNumber{parsePin(str)};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(DIGITAL_READ_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
         return;
@@ -913,26 +1191,21 @@ void digitalReadRequest(const char *str)
     printResult(DIGITAL_READ_HEADER, static_cast<int16_t>(pinNumber), state, OPERATION_SUCCESS);
 }
 
-void digitalWriteRequest(const char *str)
+void digitalWriteRequest(const RequestTokenizer &request)
 {
-    char **splitString{calloc2D<char>(DIGITAL_WRITE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)};
-    int splitStringSize{split(str, splitString, ITEM_SEPARATOR, DIGITAL_WRITE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)};
-    if (splitStringSize != DIGITAL_WRITE_PARAMETER_COUNT) {
+    if (request.argumentCount() < DIGITAL_WRITE_PARAMETER_COUNT) {
         printResult(DIGITAL_WRITE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PARAMETER_COUNT);
-        free2D(splitString, DIGITAL_WRITE_PARAMETER_COUNT);
         return;
     }
-    int8_t pinNumber{parsePin(splitString[0])};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(DIGITAL_WRITE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
-        free2D(splitString, DIGITAL_WRITE_PARAMETER_COUNT);
         return;
     }
     char tempPin[5];
     getPrintablePinType(pinNumber, tempPin);
     if (pinInUseBySerialPort(pinNumber)) {
         printResult(DIGITAL_WRITE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_USED_BY_SERIAL_PORT);
-        free2D(splitString, DIGITAL_WRITE_PARAMETER_COUNT);
         return;
     }
     if (pinHasSecondaryFunction(pinNumber)) {
@@ -941,29 +1214,27 @@ void digitalWriteRequest(const char *str)
     }
     if (!isValidDigitalOutputPin(pinNumber)) {
         printResult(DIGITAL_WRITE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_TYPE_MISMATCH);
-        free2D(splitString, DIGITAL_WRITE_PARAMETER_COUNT);
         return;
     }
     
-    int state{parseToDigitalState(splitString[1])};
+    int state{parseToDigitalState(request.argument(1))};
     if (state == OPERATION_FAILURE) {
-        printResult(DIGITAL_WRITE_HEADER, tempPin, splitString[1], OPERATION_INVALID_STATE);
+        printResult(DIGITAL_WRITE_HEADER, tempPin, request.argument(1), OPERATION_INVALID_STATE);
     } else {
         gpioPinByPinNumber(pinNumber)->g_digitalWrite(state);
         printResult(DIGITAL_WRITE_HEADER, tempPin, state, OPERATION_SUCCESS);
     }
-    free2D(splitString, DIGITAL_WRITE_PARAMETER_COUNT);
 }
 
-void digitalWriteAllRequest(const char *str)
+void digitalWriteAllRequest(const RequestTokenizer &request)
 {
-    *getCurrentValidOutputStream() << DIGITAL_WRITE_ALL_HEADER << ITEM_SEPARATOR;
-    
-    int state{parseToDigitalState(str)};
+    int state{parseToDigitalState(request.argument(0))};
     if (state == OPERATION_FAILURE) {
         printTypeResult(DIGITAL_WRITE_ALL_HEADER, STATE_FAILURE, OPERATION_INVALID_STATE);
         return;
     }
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << DIGITAL_WRITE_ALL_HEADER << ITEM_SEPARATOR;
     for (int i = 0; i < NUMBER_OF_PINS; i++) {
         GPIO *gpioPin{gpioPinByPinNumber(i)};
         if (gpioPin) {
@@ -973,19 +1244,121 @@ void digitalWriteAllRequest(const char *str)
                     char analogPinString[SMALL_BUFFER_SIZE];
                     int8_t result{analogPinFromNumber(gpioPin->pinNumber(), analogPinString, SMALL_BUFFER_SIZE)};
                     (void)result;
-                    *getCurrentValidOutputStream() << ITEM_SEPARATOR << analogPinString;
+                    response << ITEM_SEPARATOR << analogPinString;
                 } else {
-                    *getCurrentValidOutputStream() << ITEM_SEPARATOR << gpioPin->pinNumber();
+                    response << ITEM_SEPARATOR << gpioPin->pinNumber();
                 }
             }
         }
     }
-    *getCurrentValidOutputStream() << ITEM_SEPARATOR << state << ITEM_SEPARATOR << OPERATION_SUCCESS << LINE_ENDING;
+    response << ITEM_SEPARATOR << state << ITEM_SEPARATOR << OPERATION_SUCCESS << LINE_ENDING;
+}
+
+int checkPinAvailable(int8_t pinNumber, bool (*isValidForRequest)(int8_t))
+{
+    if (pinInUseBySerialPort(pinNumber)) {
+        return OPERATION_PIN_USED_BY_SERIAL_PORT;
+    }
+    if (pinHasSecondaryFunction(pinNumber)) {
+        return OPERATION_PIN_HAS_SECONDARY_FUNCTION;
+    }
+    if (!isValidForRequest(pinNumber)) {
+        return OPERATION_PIN_TYPE_MISMATCH;
+    }
+    return OPERATION_SUCCESS;
+}
+
+int multiResultCode(uint8_t pinCount, uint8_t successCount)
+{
+    if ((pinCount == 0) || (successCount == 0)) {
+        return OPERATION_FAILURE;
+    } else if (successCount != pinCount) {
+        return OPERATION_KIND_OF_SUCCESS;
+    } else {
+        return OPERATION_SUCCESS;
+    }
+}
+
+/* Multi requests answer with one pin:state:result triplet per requested pin, in request
+ * order and with the pin echoed exactly as it was sent, followed by an overall result */
+void digitalReadMultiRequest(const RequestTokenizer &request)
+{
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << DIGITAL_READ_MULTI_HEADER;
+    uint8_t pinCount{0};
+    uint8_t successCount{0};
+    for (uint8_t i = 0; (i < request.argumentCount()) && (request.argument(i)[0] != '\0'); i++) {
+        const char *pinString{request.argument(i)};
+        pinCount++;
+        int8_t pinNumber{parsePin(pinString)};
+        int resultCode{(pinNumber == INVALID_PIN) ? OPERATION_INVALID_PIN : checkPinAvailable(pinNumber, isValidDigitalInputPin)};
+        if (resultCode != OPERATION_SUCCESS) {
+            response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << STATE_FAILURE << ITEM_SEPARATOR << resultCode;
+            continue;
+        }
+        GPIO *gpioHandle{gpioPinByPinNumber(pinNumber)};
+        bool state{(gpioHandle->ioType() == IOType::DIGITAL_OUTPUT) ? gpioHandle->g_softDigitalRead() : gpioHandle->g_digitalRead()};
+        response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << state << ITEM_SEPARATOR << OPERATION_SUCCESS;
+        successCount++;
+    }
+    response << ITEM_SEPARATOR << multiResultCode(pinCount, successCount) << LINE_ENDING;
+}
+
+void digitalWriteMultiRequest(const RequestTokenizer &request)
+{
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << DIGITAL_WRITE_MULTI_HEADER;
+    uint8_t pinCount{0};
+    uint8_t successCount{0};
+    for (uint8_t i = 0; (i < request.argumentCount()) && (request.argument(i)[0] != '\0'); i += 2) {
+        const char *pinString{request.argument(i)};
+        const char *stateString{request.argument(i + 1)};
+        pinCount++;
+        if (stateString[0] == '\0') {
+            response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << STATE_FAILURE << ITEM_SEPARATOR << OPERATION_INVALID_PARAMETER_COUNT;
+            break;
+        }
+        int8_t pinNumber{parsePin(pinString)};
+        int resultCode{(pinNumber == INVALID_PIN) ? OPERATION_INVALID_PIN : checkPinAvailable(pinNumber, isValidDigitalOutputPin)};
+        int state{parseToDigitalState(stateString)};
+        if ((resultCode == OPERATION_SUCCESS) && (state == OPERATION_FAILURE)) {
+            resultCode = OPERATION_INVALID_STATE;
+        }
+        if (resultCode != OPERATION_SUCCESS) {
+            response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << STATE_FAILURE << ITEM_SEPARATOR << resultCode;
+            continue;
+        }
+        gpioPinByPinNumber(pinNumber)->g_digitalWrite(state);
+        response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << state << ITEM_SEPARATOR << OPERATION_SUCCESS;
+        successCount++;
+    }
+    response << ITEM_SEPARATOR << multiResultCode(pinCount, successCount) << LINE_ENDING;
 }
 
-void analogReadRequest(const char *str)
+void analogReadMultiRequest(const RequestTokenizer &request)
 {
-    int8_t pinNumber{parsePin(str)};
+    ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+    response << ANALOG_READ_MULTI_HEADER;
+    uint8_t pinCount{0};
+    uint8_t successCount{0};
+    for (uint8_t i = 0; (i < request.argumentCount()) && (request.argument(i)[0] != '\0'); i++) {
+        const char *pinString{request.argument(i)};
+        pinCount++;
+        int8_t pinNumber{parsePin(pinString)};
+        int resultCode{(pinNumber == INVALID_PIN) ? OPERATION_INVALID_PIN : checkPinAvailable(pinNumber, isValidAnalogInputPin)};
+        if (resultCode != OPERATION_SUCCESS) {
+            response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << STATE_FAILURE << ITEM_SEPARATOR << resultCode;
+            continue;
+        }
+        response << ITEM_SEPARATOR << pinString << ITEM_SEPARATOR << gpioPinByPinNumber(pinNumber)->g_analogRead() << ITEM_SEPARATOR << OPERATION_SUCCESS;
+        successCount++;
+    }
+    response << ITEM_SEPARATOR << multiResultCode(pinCount, successCount) << LINE_ENDING;
+}
+
+void analogReadRequest(const RequestTokenizer &request)
+{
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(ANALOG_READ_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
         return;
@@ -1007,19 +1380,15 @@ void analogReadRequest(const char *str)
     printResult(ANALOG_READ_HEADER, tempPin, gpioPinByPinNumber(pinNumber)->g_analogRead(), OPERATION_SUCCESS);    
 }
 
-void analogWriteRequest(const char *str)
+void analogWriteRequest(const RequestTokenizer &request)
 {
-    char **splitString{calloc2D<char>(ANALOG_WRITE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)};
-    int splitStringSize{split(str, splitString, ITEM_SEPARATOR, ANALOG_WRITE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)};
-    if (splitStringSize != ANALOG_WRITE_PARAMETER_COUNT) {
+    if (request.argumentCount() < ANALOG_WRITE_PARAMETER_COUNT) {
         printResult(ANALOG_WRITE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PARAMETER_COUNT);
-        free2D(splitString, ANALOG_WRITE_PARAMETER_COUNT);
         return;
     }
-    int8_t pinNumber{parsePin(splitString[0])};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(ANALOG_WRITE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
-        free2D(splitString, ANALOG_WRITE_PARAMETER_COUNT);
         return;
     }
     char tempPin[5];
@@ -1030,28 +1399,25 @@ void analogWriteRequest(const char *str)
     }
     if (pinInUseBySerialPort(pinNumber)) {
         printResult(ANALOG_WRITE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_USED_BY_SERIAL_PORT);
-        free2D(splitString, ANALOG_WRITE_PARAMETER_COUNT);
         return;
     }
     if (!isValidAnalogOutputPin(pinNumber)) {
         printResult(ANALOG_WRITE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_TYPE_MISMATCH);
-        free2D(splitString, ANALOG_WRITE_PARAMETER_COUNT);
         return;
     }
     
-    int state{parseToAnalogState(splitString[1])};
+    int state{parseToAnalogState(request.argument(1))};
     if (state == OPERATION_FAILURE) {
-        printResult(ANALOG_WRITE_HEADER, tempPin, splitString[1], OPERATION_INVALID_STATE);
+        printResult(ANALOG_WRITE_HEADER, tempPin, request.argument(1), OPERATION_INVALID_STATE);
     } else {
         gpioPinByPinNumber(pinNumber)->g_analogWrite(state);
         printResult(ANALOG_WRITE_HEADER, tempPin, state, OPERATION_SUCCESS);
     }
-    free2D(splitString, ANALOG_WRITE_PARAMETER_COUNT);
 }
 
-void pinTypeRequest(const char *str)
+void pinTypeRequest(const RequestTokenizer &request)
 {
-    int8_t pinNumber{parsePin(str)};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(PIN_TYPE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
         return;
@@ -1082,36 +1448,30 @@ void pinTypeRequest(const char *str)
     printResult(PIN_TYPE_HEADER, tempPin, ioTypeString, OPERATION_SUCCESS);
 }
 
-void pinTypeChangeRequest(const char *str)
+void pinTypeChangeRequest(const RequestTokenizer &request)
 {   
-    char **splitString{calloc2D<char>(PIN_TYPE_CHANGE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)}; 
-    int splitStringSize{split(str, splitString, ITEM_SEPARATOR, PIN_TYPE_CHANGE_PARAMETER_COUNT, SMALL_BUFFER_SIZE)};
-    if (splitStringSize != PIN_TYPE_CHANGE_PARAMETER_COUNT) {
+    if (request.argumentCount() < PIN_TYPE_CHANGE_PARAMETER_COUNT) {
         printResult(PIN_TYPE_CHANGE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PARAMETER_COUNT);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
-    int8_t pinNumber{parsePin(splitString[0])};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(PIN_TYPE_CHANGE_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
     char tempPin[5];
     getPrintablePinType(pinNumber, tempPin);
     if (pinInUseBySerialPort(pinNumber)) {
         printResult(PIN_TYPE_CHANGE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_USED_BY_SERIAL_PORT);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
     if (pinHasSecondaryFunction(pinNumber)) {
         printResult(PIN_TYPE_CHANGE_HEADER, tempPin, STATE_FAILURE, OPERATION_PIN_HAS_SECONDARY_FUNCTION);
         return;
     }
-    IOType type{parseIOType(splitString[1])};
+    IOType type{parseIOType(request.argument(1))};
     if (type == IOType::UNSPECIFIED) {
-        printResult(PIN_TYPE_CHANGE_HEADER, tempPin, splitString[1], OPERATION_INVALID_IO_TYPE);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
+        printResult(PIN_TYPE_CHANGE_HEADER, tempPin, request.argument(1), OPERATION_INVALID_IO_TYPE);
         return;
     }
 
@@ -1119,28 +1479,24 @@ void pinTypeChangeRequest(const char *str)
     (void)getIOTypeString(type, ioTypeString, SMALL_BUFFER_SIZE);
     if (pinInUseBySerialPort(pinNumber)) {
         printResult(DIGITAL_WRITE_HEADER, tempPin, ioTypeString, OPERATION_PIN_USED_BY_SERIAL_PORT);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
     if (!checkValidIOChangeRequest(type, pinNumber)) {
         printResult(PIN_TYPE_CHANGE_HEADER, tempPin, ioTypeString, OPERATION_INVALID_IO_CHANGE);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
     GPIO *tempGpio{gpioPinByPinNumber(pinNumber)};
     if (!tempGpio) {
         printResult(PIN_TYPE_CHANGE_HEADER, tempPin, ioTypeString, OPERATION_INVALID_PIN);
-        free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
         return;
     }
     tempGpio->setIOType(type);
     printResult(PIN_TYPE_CHANGE_HEADER, tempPin, ioTypeString, OPERATION_SUCCESS);
-    free2D(splitString, PIN_TYPE_CHANGE_PARAMETER_COUNT);
 }
 
-void softAnalogReadRequest(const char *str)
+void softAnalogReadRequest(const RequestTokenizer &request)
 {
-    int8_t pinNumber{parsePin(str)};
+    int8_t pinNumber{parsePin(request.argument(0))};
     if (pinNumber == INVALID_PIN) {
         printResult(SOFT_ANALOG_READ_HEADER, INVALID_PIN, STATE_FAILURE, OPERATION_INVALID_PIN);
         return;
@@ -1237,14 +1593,6 @@ bool pinHasSecondaryFunction(int8_t pinNumber)
     return false;
 }
 
-bool checkValidRequestString(const char *header, const char *checkStr)
-{
-    if ((!header) || (!checkStr)) {
-        return false;
-    }
-    return (strlen(checkStr) > (strlen(header) + 1));
-}
-
 void getPrintablePinType(int8_t pinNumber, char *out)
 {
     if (isValidAnalogInputPin(pinNumber)) {
@@ -1257,14 +1605,7 @@ void getPrintablePinType(int8_t pinNumber, char *out)
 
 bool isValidDigitalOutputPin(int8_t pinNumber)
 {
-#if defined(ARDUINO_AVR_NANO)
-    if ((pinNumber == A6) || (pinNumber == A7)) {
-        return false;
-    }
-#endif
-    char temp[SMALL_BUFFER_SIZE];
-    snprintf(temp, SMALL_BUFFER_SIZE, "%i", pinNumber);
-    return isValidPinIdentifier(temp);
+    return (pinMaskTest(DIGITAL_PIN_MASK, pinNumber) && gpioPinByPinNumber(pinNumber));
 }
 
 bool isValidDigitalInputPin(int8_t pinNumber)
@@ -1274,30 +1615,12 @@ bool isValidDigitalInputPin(int8_t pinNumber)
 
 bool isValidAnalogOutputPin(int8_t pinNumber)
 {
-    uint8_t i{0};
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_PWM_PINS + i++)};
-        if (tempPinNumber < 0) {
-            return false;
-        }
-        if (tempPinNumber == pinNumber) {
-            return true;
-        }
-    } while (true);
+    return pinMaskTest(PWM_PIN_MASK, pinNumber);
 }
 
 bool isValidAnalogInputPin(int8_t pinNumber)
 {
-    uint8_t i{0};
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_ANALOG_PINS + i++)};
-        if (tempPinNumber < 0) {
-            return false;
-        }
-        if (tempPinNumber == pinNumber) {
-            return true;
-        }
-    } while (true);
+    return pinMaskTest(ANALOG_PIN_MASK, pinNumber);
 }
 
 bool checkValidIOChangeRequest(IOType ioType, int8_t pinNumber)
@@ -1406,6 +1729,20 @@ int parseToDigitalState(const char *str)
     return false;
 }
 
+/* Parses a plain decimal number, returning OPERATION_FAILURE for anything else */
+long parseToUnsignedValue(const char *str)
+{
+    if ((!str) || (str[0] == '\0')) {
+        return OPERATION_FAILURE;
+    }
+    for (size_t i = 0; str[i] != '\0'; i++) {
+        if (!isdigit(str[i])) {
+            return OPERATION_FAILURE;
+        }
+    }
+    return strtol(str, nullptr, 10);
+}
+
 int parseToAnalogState(const char *str)
 {
     if (!isValidAnalogStateIdentifier(str)) {
@@ -1423,72 +1760,26 @@ int parseToAnalogState(const char *str)
 
 bool isValidPinIdentifier(const char *str)
 {
-    for (int i = 0; i < NUMBER_OF_PINS; i++) {
-        GPIO *tempGpio{gpioPinByPinNumber(i)};
-        if (tempGpio) {
-            if (atoi(str) == static_cast<int>(tempGpio->pinNumber())) {
-                return true;
-            }
-        }
-    }
-
-    char *buffer = (char *)calloc(strlen(str) + 1, sizeof(char));
-    strncpy(buffer, str, strlen(str) + 1);
-
-    for (unsigned int i =  0; i < analogPinArraySize(); i++) {
-        if (startsWith(str, ANALOG_IDENTIFIER_CHAR)) {
-            buffer[0] = DIGITAL_STATE_LOW_IDENTIFIER;
-            if (atoi(buffer) == static_cast<int>(i)) {
-                free(buffer);
-                return ANALOG_PIN_OFFSET + i + 1;
-            }
-        }
+    if (startsWith(str, ANALOG_IDENTIFIER_CHAR)) {
+        int analogIndex{atoi(str + 1)};
+        return ((analogIndex >= 0) && (analogIndex < NUMBER_OF_ANALOG_PINS));
     }
-    free(buffer);
-    return false;
+    int pinNumber{atoi(str)};
+    return ((pinNumber >= 0) && (pinNumber < NUMBER_OF_PINS) && gpioPinByPinNumber(pinNumber));
 }
 
 bool isValidPwmPinIdentifier(const char *str)
 {
-    uint8_t i{0};
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_PWM_PINS + i++)};
-        if (tempPinNumber < 0) {
-            return false;
-        }
-        if (tempPinNumber == atoi(str)) {
-            return true;
-        }
-    } while (true);
+    return pinMaskTest(PWM_PIN_MASK, atoi(str));
 }
 
 bool isValidAnalogPinIdentifier(const char *str)
 {
-    uint8_t i{0};
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_ANALOG_PINS + i++)};
-        if (tempPinNumber < 0) {
-            break;
-        }
-        if (tempPinNumber == atoi(str)) {
-            return true;
-        }
-    } while (true);
-
-    char *buffer{static_cast<char *>(calloc(strlen(str) + 1, sizeof(char)))};
-    strncpy(buffer, str, (strlen(str) + 1));
-
-    for (unsigned int j = 0; j < analogPinArraySize(); j++) {
-        if (startsWith(str, ANALOG_IDENTIFIER_CHAR)) {
-            buffer[0] = DIGITAL_STATE_LOW_IDENTIFIER;
-            if (atoi(buffer) == static_cast<int>(j)) {
-                free(buffer);
-                return true;
-            }
-        }
+    if (startsWith(str, ANALOG_IDENTIFIER_CHAR)) {
+        int analogIndex{atoi(str + 1)};
+        return ((analogIndex >= 0) && (analogIndex < NUMBER_OF_ANALOG_PINS));
     }
-    free(buffer);
-    return false;
+    return pinMaskTest(ANALOG_PIN_MASK, atoi(str));
 }
 
 bool isValidPinTypeIdentifier(const char *str)
@@ -1517,14 +1808,16 @@ void broadcastString(const char *str)
     for (unsigned int i = 0; i < ARRAY_SIZE(hardwareSerialPorts); i++) {
         if (hardwareSerialPorts + i) {
             if (hardwareSerialPorts[i]) {
-                *(hardwareSerialPorts[i]) << str << LINE_ENDING;
+                ResponseBuilder<Stream> response{hardwareSerialPorts[i]};
+                response << str << LINE_ENDING;
             }
         }
     }
     for (unsigned int i = 0; i < ARRAY_SIZE(softwareSerialPorts); i++) {
         if (softwareSerialPorts + i) {
             if (softwareSerialPorts[i]) {
-                *(softwareSerialPorts[i]) << str << LINE_ENDING;   
+                ResponseBuilder<Stream> response{softwareSerialPorts[i]};
+                response << str << LINE_ENDING;
             }
         }
     }
@@ -1559,101 +1852,37 @@ GPIO *gpioPinByPinNumber(int8_t pinNumber)
     return ((gpioPins + pinNumber) ? gpioPins[pinNumber] : nullptr);
 }
 
-uint8_t analogPinArraySize()
-{
-    uint8_t arraySize{0};
-    while (true) {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_ANALOG_PINS + arraySize++)};
-        if (tempPinNumber < 0) {
-            arraySize--;
-            break;
-        }
-    }
-    return arraySize;
-}
-
-uint8_t generalPinArraySize()
-{
-    uint8_t arraySize{0};
-    while (true) {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_GENERAL_PINS + arraySize++)};
-        if (tempPinNumber < 0) {
-            arraySize--;
-            break;
-        }
-    }
-    return arraySize;
-}
-
-uint8_t pwmPinArraySize()
-{
-    size_t arraySize{0};
-    while (true) {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_PWM_PINS + arraySize++)};
-        if (tempPinNumber < 0) {
-            arraySize--;
-            break;
-        } 
-    }
-    return arraySize;
-}
-
 int8_t parseAnalogPin(const char *pinAlias)
 {
     if (!pinAlias) {
         return 0;
     }
-    char *buffer = (char *)calloc(strlen(pinAlias) + 1, sizeof(char));
-    strncpy(buffer, pinAlias, strlen(pinAlias) + 1);
-    for (unsigned int i =  0; i < analogPinArraySize(); i++) {
-        if (startsWith(pinAlias, ANALOG_IDENTIFIER_CHAR)) {
-            buffer[0] = DIGITAL_STATE_LOW_IDENTIFIER;
-            if (atoi(buffer) == static_cast<int>(i)) {
-                free(buffer);
-                return ANALOG_PIN_OFFSET + i + 1;
-            }
+    if (startsWith(pinAlias, ANALOG_IDENTIFIER_CHAR)) {
+        int analogIndex{atoi(pinAlias + 1)};
+        if ((analogIndex >= 0) && (analogIndex < NUMBER_OF_ANALOG_PINS)) {
+            return ANALOG_PIN_OFFSET + analogIndex + 1;
         }
     }
-    free(buffer);
-    uint8_t i{0};
     int8_t maybePinNumber{parsePin(pinAlias)};
     if (maybePinNumber == INVALID_PIN) {
         return INVALID_PIN;
     }
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_ANALOG_PINS + i++)};
-        if (tempPinNumber < 0) {
-            break;
-        }
-        if (tempPinNumber == maybePinNumber) {
-            return tempPinNumber;
-        }
-    } while (true);
-    return INVALID_PIN;
+    return (pinMaskTest(ANALOG_PIN_MASK, maybePinNumber) ? maybePinNumber : INVALID_PIN);
 }
 
 int8_t analogPinFromNumber(int8_t pinNumber, char *out, size_t maximumSize)
 {
-    if (!out) {
+    if ((!out) || (!pinMaskTest(ANALOG_PIN_MASK, pinNumber))) {
         return 0;
     }
-    uint8_t i{0};
-    do {
-        int8_t tempPinNumber{pgm_read_byte_near(AVAILABLE_ANALOG_PINS + i++)};
-        if (tempPinNumber < 0) {
-            return 0;
-        }
-        if (tempPinNumber == pinNumber) {
-            char tempNumber[SMALL_BUFFER_SIZE];
-            if (!toDecString(i-1, tempNumber, maximumSize)) {
-                return 0;
-            }
-            out[0] = ANALOG_IDENTIFIER_CHAR;
-            out[1] = '\0';
-            strcat(out, tempNumber);
-            return strlen(out);
-        }
-    } while (true);
+    char tempNumber[SMALL_BUFFER_SIZE];
+    if (!toDecString(pinNumber - (ANALOG_PIN_OFFSET + 1), tempNumber, maximumSize)) {
+        return 0;
+    }
+    out[0] = ANALOG_IDENTIFIER_CHAR;
+    out[1] = '\0';
+    strcat(out, tempNumber);
+    return strlen(out);
 }
 
 bool pinInUseBySerialPort(int8_t pinNumber)
@@ -1752,12 +1981,14 @@ Stream *getSoftwareCout(int coutIndex)
             for (int i = 0; i < NUMBER_OF_HARDWARE_SERIAL_PORTS; i++) {
                 if (hardwareSerialPorts + i) {
                     if (hardwareSerialPorts[i]) {
-                        *(hardwareSerialPorts[i]) << header << ITEM_SEPARATOR << str << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+                        ResponseBuilder<Stream> response{hardwareSerialPorts[i]};
+                        response << header << ITEM_SEPARATOR << str << ITEM_SEPARATOR << resultCode << LINE_ENDING;
                     }
                 }
             }            
         } else {
-            *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << str << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+            ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+            response << header << ITEM_SEPARATOR << str << ITEM_SEPARATOR << resultCode << LINE_ENDING;
         }
     }
     
@@ -1769,18 +2000,21 @@ Stream *getSoftwareCout(int coutIndex)
             for (int i = 0; i < NUMBER_OF_HARDWARE_SERIAL_PORTS; i++) {
                 if (hardwareSerialPorts + i) {
                     if (hardwareSerialPorts[i]) {
-                        *(hardwareSerialPorts[i]) << header << ITEM_SEPARATOR << temp << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+                        ResponseBuilder<Stream> response{hardwareSerialPorts[i]};
+                        response << header << ITEM_SEPARATOR << temp << ITEM_SEPARATOR << resultCode << LINE_ENDING;
                     }
                 }
             }
         } else {
-            *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << temp << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+            ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+            response << header << ITEM_SEPARATOR << temp << ITEM_SEPARATOR << resultCode << LINE_ENDING;
         }
     }
     
     void printBlankCanResult(const char *header, int resultCode) 
     { 
-        *getCurrentValidOutputStream() << header << ITEM_SEPARATOR << resultCode << LINE_ENDING;
+        ResponseBuilder<Stream> response{getCurrentValidOutputStream()};
+        response << header << ITEM_SEPARATOR << resultCode << LINE_ENDING;
     } 
 
     bool canInit()
@@ -1798,6 +2032,10 @@ Stream *getSoftwareCout(int coutIndex)
                 }
             }
             canBusInitialized = true;
+            pinMode(CAN_INTERRUPT_PIN, INPUT);
+            SPI.usingInterrupt(digitalPinToInterrupt(CAN_INTERRUPT_PIN));
+            attachInterrupt(digitalPinToInterrupt(CAN_INTERRUPT_PIN), canReceiveInterrupt, FALLING);
+            serviceCanReceiveInterrupt();
             return true;
         }
         return false;
@@ -1819,53 +2057,173 @@ Stream *getSoftwareCout(int coutIndex)
             printSingleResult(CAN_READ_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        //TODO: Extended frame
-        uint8_t receivedPacketLength{0};      
-        uint8_t rawReceivedMessage[SMALL_BUFFER_SIZE];
-        uint32_t canID{0};
-        uint8_t frameType{CAN_NORMAL_FRAME};
-        if (canController->checkReceive() == CAN_MSGAVAIL) {
-            if (canController->isExtendedFrame()) {
-                frameType = CAN_EXTENDED_FRAME;
-            }
-            canController->readMsgBufID(&canID, &receivedPacketLength, rawReceivedMessage);
-            if ((numberOfPositiveCanMasks() == 0) && (numberOfNegativeCanMasks() == 0)) {
-                CanMessage readMessage{canID, frameType, receivedPacketLength, rawReceivedMessage};
+        CanReceiveRecord record;
+        if (canReceiveRing.pop(&record)) {
+            if (canMessageAccepted(record.id)) {
+                CanMessage readMessage{record.id, record.frameType, record.length, record.data};
                 printCanResult(CAN_READ_HEADER, readMessage, OPERATION_SUCCESS, (autoUp ? BROADCAST : NO_BROADCAST));
-            } else {
-                if (numberOfPositiveCanMasks() == 0) {
-                    if (!negativeCanMaskExists(canID)) {
-                        CanMessage readMessage{canID, frameType, receivedPacketLength, rawReceivedMessage};
-                        printCanResult(CAN_READ_HEADER, readMessage, OPERATION_SUCCESS, (autoUp ? BROADCAST : NO_BROADCAST));
-                    }
-                }
-                if (numberOfNegativeCanMasks() == 0) {
-                    if (positiveCanMaskExists(canID)) {
-                        CanMessage readMessage{canID, frameType, receivedPacketLength, rawReceivedMessage};
-                        printCanResult(CAN_READ_HEADER, readMessage, OPERATION_SUCCESS, (autoUp ? BROADCAST : NO_BROADCAST));
-                    }
-                }
-                if (positiveCanMaskExists(canID)) {
-                    if (!negativeCanMaskExists(canID)) {
-                        CanMessage readMessage{canID, frameType, receivedPacketLength, rawReceivedMessage};
-                        printCanResult(CAN_READ_HEADER, readMessage, OPERATION_SUCCESS, (autoUp ? BROADCAST : NO_BROADCAST));
-                    }
-                }
+            } else if (!autoUp) {
+                printBlankCanResult(CAN_READ_HEADER, OPERATION_SUCCESS);
             }
-            CanMessage readMessage{canID, frameType, receivedPacketLength, rawReceivedMessage};
-            printCanResult(CAN_READ_HEADER, readMessage, OPERATION_SUCCESS, (autoUp ? BROADCAST : NO_BROADCAST));
         } else if (!autoUp) {
             printBlankCanResult(CAN_READ_HEADER, OPERATION_SUCCESS);
         }
     }
 
-    void canWriteRequest(const char *str, bool once)
+    /* Runs on the MCP2515's INT pin going low and moves every frame it is holding into
+     * canReceiveRing, so its two receive buffers are emptied even while loop() is busy handling a
+     * request. SPI.usingInterrupt() in canInit() keeps this from cutting into an SPI transaction
+     * that loop() has started, but readMsg() also overwrites the MCP_CAN members that a send or a
+     * filter change works through between transactions, so those suspend this interrupt */
+    void canReceiveInterrupt()
+    {
+        canReceiveRing.drain(canController);
+    }
+
+    //INT stays low while a frame is waiting, so a missed falling edge would stall reception for good
+    void serviceCanReceiveInterrupt()
+    {
+        if ((canBusInitialized) && (digitalRead(CAN_INTERRUPT_PIN) == LOW)) {
+            noInterrupts();
+            canReceiveRing.drain(canController);
+            interrupts();
+        }
+    }
+
+    /* Holds off canReceiveInterrupt() alone rather than every interrupt, since init_MasksAndFilts()
+     * calls delay(), which stalls with interrupts disabled */
+    void suspendCanReceiveInterrupt()
+    {
+        if (canBusInitialized) {
+            detachInterrupt(digitalPinToInterrupt(CAN_INTERRUPT_PIN));
+        }
+    }
+
+    //Frames that arrived while suspended left INT low without a new falling edge, so drain them here
+    void resumeCanReceiveInterrupt()
+    {
+        if (canBusInitialized) {
+            attachInterrupt(digitalPinToInterrupt(CAN_INTERRUPT_PIN), canReceiveInterrupt, FALLING);
+            serviceCanReceiveInterrupt();
+        }
+    }
+
+    //Replies with the frames dropped because canReceiveRing was full since the last request
+    void canReceiveOverflowsRequest()
+    {
+        if (!canInit()) {
+            printSingleResult(CAN_RECEIVE_OVERFLOWS_HEADER, CAN_BUS_NOT_INITIALIZED);
+            return;
+        }
+        printTypeResult(CAN_RECEIVE_OVERFLOWS_HEADER, canReceiveRing.takeOverflowCount(), OPERATION_SUCCESS);
+    }
+
+    //Sets how many frames live update packs into one line (canbsize:n), 1 sends each as a canread line
+    void canBatchSizeRequest(const RequestTokenizer &request)
+    {
+        const char *sizeString{request.argument(0)};
+        if (!canInit()) {
+            printSingleResult(CAN_BATCH_SIZE_HEADER, CAN_BUS_NOT_INITIALIZED);
+            return;
+        }
+        uint32_t batchSize{stringToUInt(sizeString)};
+        if ((batchSize < 1) || (batchSize > CAN_BATCH_MAXIMUM_FRAMES)) {
+            printTypeResult(CAN_BATCH_SIZE_HEADER, sizeString, OPERATION_FAILURE);
+            return;
+        }
+        flushCanBatch();
+        canBatchSize = static_cast<uint8_t>(batchSize);
+        printTypeResult(CAN_BATCH_SIZE_HEADER, static_cast<int>(canBatchSize), OPERATION_SUCCESS);
+    }
+
+    //Called from loop() while live update is on, moves frames from canReceiveRing to the host
+    void forwardReceivedCanMessages()
+    {
+        if (canBatchSize <= 1) {
+            for (uint8_t i = 0; (i < CAN_RECEIVE_RING_SIZE) && (!canReceiveRing.empty()); i++) {
+                canReadRequest(true);
+            }
+            return;
+        }
+        CanReceiveRecord record;
+        for (uint8_t i = 0; (i < CAN_RECEIVE_RING_SIZE) && (canReceiveRing.pop(&record)); i++) {
+            if (!canMessageAccepted(record.id)) {
+                continue;
+            }
+            if (canBatchCount == 0) {
+                canBatchStartTime = millis();
+            }
+            canBatch[canBatchCount++] = record;
+            if (canBatchCount >= canBatchSize) {
+                flushCanBatch();
+            }
+        }
+        if ((canBatchCount > 0) && ((millis() - canBatchStartTime) >= CAN_BATCH_MAXIMUM_AGE)) {
+            flushCanBatch();
+        }
+    }
+
+    //Builds the whole canbatch line first so each port gets it in a single write
+    void flushCanBatch()
+    {
+        if (canBatchCount == 0) {
+            return;
+        }
+        char line[CAN_BATCH_LINE_SIZE];
+        size_t headerLength{strlen(CAN_BATCH_HEADER)};
+        memcpy(line, CAN_BATCH_HEADER, headerLength);
+        char *position{line + headerLength};
+        *position++ = ITEM_SEPARATOR;
+        position = appendHex(position, canBatchCount, 1);
+        for (uint8_t i = 0; i < canBatchCount; i++) {
+            const CanReceiveRecord &record = canBatch[i];
+            *position++ = ITEM_SEPARATOR;
+            position = appendHex(position, record.id, ((record.frameType == CAN_EXTENDED_FRAME) ? CAN_EXTENDED_ID_DIGITS : CAN_STANDARD_ID_DIGITS));
+            *position++ = ITEM_SEPARATOR;
+            for (uint8_t j = 0; j < record.length; j++) {
+                position = appendHex(position, record.data[j], 2);
+            }
+        }
+        *position++ = ITEM_SEPARATOR;
+        *position++ = '0' + OPERATION_SUCCESS;
+        *position++ = LINE_ENDING;
+        for (int i = 0; i < NUMBER_OF_HARDWARE_SERIAL_PORTS; i++) {
+            if (hardwareSerialPorts[i]) {
+                hardwareSerialPorts[i]->write(line, position - line);
+            }
+        }
+        canBatchCount = 0;
+    }
+
+    char *appendHex(char *out, uint32_t value, uint8_t digits)
+    {
+        static const char HEX_DIGITS[]{"0123456789ABCDEF"};
+        for (int8_t shift = (digits - 1) * 4; shift >= 0; shift -= 4) {
+            *out++ = HEX_DIGITS[(value >> shift) & 0x0F];
+        }
+        return out;
+    }
+
+    //canwriteo:id:byte:byte:..., each number in any base strtoul() accepts ("0x1a", "26")
+    void canWriteRequest(const RequestTokenizer &request, bool once)
     {
         if (!canInit()) {
             printSingleResult((once ? CAN_WRITE_ONCE_HEADER : CAN_WRITE_HEADER), CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        CanMessage readMessage{CanMessage::parse(str, ITEM_SEPARATOR, SMALL_BUFFER_SIZE)};
+        //The ID is required, the data bytes after it are not
+        if (request.argumentCount() < 1) {
+            printSingleResult((once ? CAN_WRITE_ONCE_HEADER : CAN_WRITE_HEADER), OPERATION_FAILURE);
+            return;
+        }
+        uint8_t length{static_cast<uint8_t>(request.argumentCount() - 1)};
+        if (length > CanMessage::DEFAULT_MESSAGE_LENGTH) {
+            length = CanMessage::DEFAULT_MESSAGE_LENGTH;
+        }
+        CanMessage readMessage{static_cast<uint32_t>(strtoul(request.argument(0), nullptr, 0)), CanMessage::DEFAULT_FRAME_TYPE, length};
+        for (uint8_t i = 0; i < length; i++) {
+            readMessage.setMessageNthByte(i, static_cast<uint8_t>(strtoul(request.argument(i + 1), nullptr, 0)));
+        }
         char tempMessage[SMALL_BUFFER_SIZE];
         int resultLength{readMessage.toString(tempMessage, SMALL_BUFFER_SIZE)};
         if (!resultLength) {
@@ -1879,106 +2237,142 @@ Stream *getSoftwareCout(int coutIndex)
         printCanResult((once ? CAN_WRITE_ONCE_HEADER : CAN_WRITE_HEADER), tempMessage, OPERATION_SUCCESS, NO_BROADCAST);
     }
 
-    void addPositiveCanMaskRequest(const char *str)
+    void addPositiveCanMaskRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(ADD_POSITIVE_CAN_MASK_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         }
         int8_t result{addPositiveCanMask(maybeID)};
         if (result == -1) {
-            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         } else if (result) {
-            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, str, OPERATION_SUCCESS);
+            applyCanHardwareFilters();
+            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_SUCCESS);
         } else {
-            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, str, OPERATION_KIND_OF_SUCCESS);
+            printTypeResult(ADD_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_KIND_OF_SUCCESS);
         }
     }
 
-    void removePositiveCanMaskRequest(const char *str)
+    void removePositiveCanMaskRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(REMOVE_POSITIVE_CAN_MASK_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(REMOVE_POSITIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(REMOVE_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         }
         for (uint8_t i = 0; i < MAX_POSITIVE_CAN_MASKS; i++) {
             if (positiveCanMasks[i] == maybeID) {
                 positiveCanMasks[i] = EMPTY_CAN_MASK_SLOT;
             }
         }
-        printTypeResult(REMOVE_POSITIVE_CAN_MASK_HEADER, str, OPERATION_SUCCESS);
+        applyCanHardwareFilters();
+        printTypeResult(REMOVE_POSITIVE_CAN_MASK_HEADER, idString, OPERATION_SUCCESS);
     }
 
-    void addNegativeCanMaskRequest(const char *str)
+    void addNegativeCanMaskRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(ADD_NEGATIVE_CAN_MASK_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         }
         int8_t result{addNegativeCanMask(maybeID)};
         if (result == -1) {
-            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         } else if (result) {
-            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_SUCCESS);
+            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_SUCCESS);
         } else {
-            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_KIND_OF_SUCCESS);
+            printTypeResult(ADD_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_KIND_OF_SUCCESS);
         }
     }
 
-    void removeNegativeCanMaskRequest(const char *str)
+    void removeNegativeCanMaskRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(REMOVE_NEGATIVE_CAN_MASK_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(REMOVE_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(REMOVE_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_FAILURE);
         }
         for (uint8_t i = 0; i < MAX_NEGATIVE_CAN_MASKS; i++) {
             if (negativeCanMasks[i] == maybeID) {
                 negativeCanMasks[i] = EMPTY_CAN_MASK_SLOT;
             }
         }
-        printTypeResult(REMOVE_NEGATIVE_CAN_MASK_HEADER, str, OPERATION_SUCCESS);
+        printTypeResult(REMOVE_NEGATIVE_CAN_MASK_HEADER, idString, OPERATION_SUCCESS);
     }
 
-    void canLiveUpdateRequest(const char *str)
+    //Replaces the whole positive mask list in one request (setpcanmasks:id:id:...)
+    void setPositiveCanMasksRequest(const RequestTokenizer &request)
     {
+        if (!canInit()) {
+            printSingleResult(SET_POSITIVE_CAN_MASKS_HEADER, CAN_BUS_NOT_INITIALIZED);
+            return;
+        }
+        bool replaced{replaceCanMasks(positiveCanMasks, MAX_POSITIVE_CAN_MASKS, request)};
+        if (replaced) {
+            applyCanHardwareFilters();
+        }
+        printTypeResult(SET_POSITIVE_CAN_MASKS_HEADER, static_cast<int>(numberOfPositiveCanMasks()), (replaced ? OPERATION_SUCCESS : OPERATION_FAILURE));
+    }
+
+    //Replaces the whole negative mask list in one request (setncanmasks:id:id:...)
+    void setNegativeCanMasksRequest(const RequestTokenizer &request)
+    {
+        if (!canInit()) {
+            printSingleResult(SET_NEGATIVE_CAN_MASKS_HEADER, CAN_BUS_NOT_INITIALIZED);
+            return;
+        }
+        bool replaced{replaceCanMasks(negativeCanMasks, MAX_NEGATIVE_CAN_MASKS, request)};
+        printTypeResult(SET_NEGATIVE_CAN_MASKS_HEADER, static_cast<int>(numberOfNegativeCanMasks()), (replaced ? OPERATION_SUCCESS : OPERATION_FAILURE));
+    }
+
+    void canLiveUpdateRequest(const RequestTokenizer &request)
+    {
+        const char *stateString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(CAN_LIVE_UPDATE_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        int canState{parseToDigitalState(str)};
+        int canState{parseToDigitalState(stateString)};
         if (canState == OPERATION_FAILURE) {
-            printTypeResult(CAN_LIVE_UPDATE_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(CAN_LIVE_UPDATE_HEADER, stateString, OPERATION_FAILURE);
         } else {
             canLiveUpdate = canState;
-            printTypeResult(CAN_LIVE_UPDATE_HEADER, str, OPERATION_SUCCESS);
+            if (!canLiveUpdate) {
+                flushCanBatch();
+            }
+            printTypeResult(CAN_LIVE_UPDATE_HEADER, stateString, OPERATION_SUCCESS);
         }
     }
 
-    void currentCachedCanMessageByIdRequest(const char *str)
+    void currentCachedCanMessageByIdRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(CURRENT_CAN_MESSAGE_BY_ID_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(CURRENT_CAN_MESSAGE_BY_ID_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(CURRENT_CAN_MESSAGE_BY_ID_HEADER, idString, OPERATION_FAILURE);
         }
         for (uint8_t i = 0; i < MAX_LAST_CAN_MESSAGES; i++) {
             if (lastCanMessages[i].id() == maybeID) {
@@ -1989,22 +2383,23 @@ Stream *getSoftwareCout(int coutIndex)
         printBlankCanResult(CURRENT_CAN_MESSAGE_BY_ID_HEADER, OPERATION_FAILURE);
     }
 
-    void clearCurrentMessageByIdRequest(const char *str)
+    void clearCurrentMessageByIdRequest(const RequestTokenizer &request)
     {
+        const char *idString{request.argument(0)};
         if (!canInit()) {
             printSingleResult(CLEAR_CAN_MESSAGE_BY_ID_HEADER, CAN_BUS_NOT_INITIALIZED);
             return;
         }
-        uint32_t maybeID{stringToUInt(str)};
+        uint32_t maybeID{stringToUInt(idString)};
         if (maybeID == 0) {
-            printTypeResult(CLEAR_CAN_MESSAGE_BY_ID_HEADER, str, OPERATION_FAILURE);
+            printTypeResult(CLEAR_CAN_MESSAGE_BY_ID_HEADER, idString, OPERATION_FAILURE);
         }
         for (uint8_t i = 0; i < MAX_LAST_CAN_MESSAGES; i++) {
             if (lastCanMessages[i].id() == maybeID) {
                 lastCanMessages[i] = CanMessage{};
             }
         }
-        printTypeResult(CLEAR_CAN_MESSAGE_BY_ID_HEADER, str, OPERATION_SUCCESS);
+        printTypeResult(CLEAR_CAN_MESSAGE_BY_ID_HEADER, idString, OPERATION_SUCCESS);
     }
 
     void currentCachedCanMessagesRequest()
@@ -2071,6 +2466,7 @@ Stream *getSoftwareCout(int coutIndex)
         for (uint8_t i = 0; i < MAX_POSITIVE_CAN_MASKS; i++) {
             positiveCanMasks[i] = EMPTY_CAN_MASK_SLOT;
         }
+        applyCanHardwareFilters();
         printSingleResult(CLEAR_POSITIVE_CAN_MASKS_HEADER, OPERATION_SUCCESS);
     }
 
@@ -2098,6 +2494,7 @@ Stream *getSoftwareCout(int coutIndex)
         for (uint8_t i = 0; i < MAX_NEGATIVE_CAN_MASKS; i++) {
             negativeCanMasks[i] = EMPTY_CAN_MASK_SLOT;
         }
+        applyCanHardwareFilters();
         printSingleResult(CLEAR_ALL_CAN_MASKS_HEADER, OPERATION_SUCCESS);
     }
 
@@ -2152,7 +2549,9 @@ Stream *getSoftwareCout(int coutIndex)
 
     void sendCanMessage(const CanMessage &msg)
     {
+        suspendCanReceiveInterrupt();
         canController->sendMsgBuf(msg.id(), msg.frameType(), msg.length(), msg.message());
+        resumeCanReceiveInterrupt();
     }
 
     void initializeCanMasks()
@@ -2165,6 +2564,112 @@ Stream *getSoftwareCout(int coutIndex)
         }
     }
 
+    /* Fills masks with the IDs in the request's arguments, emptying the slots left over. The list
+     * is left alone unless every ID parses (0 marks an empty slot, so it is refused) and fits */
+    bool replaceCanMasks(uint32_t *masks, uint8_t maximumMasks, const RequestTokenizer &request)
+    {
+        uint8_t idCount{0};
+        while ((idCount < request.argumentCount()) && (request.argument(idCount)[0] != '\0')) {
+            if ((stringToUInt(request.argument(idCount)) == EMPTY_CAN_MASK_SLOT) || (++idCount > maximumMasks)) {
+                return false;
+            }
+        }
+        for (uint8_t i = 0; i < maximumMasks; i++) {
+            masks[i] = ((i < idCount) ? stringToUInt(request.argument(i)) : EMPTY_CAN_MASK_SLOT);
+        }
+        return true;
+    }
+
+    /* Compiles the positive mask list into the MCP2515's acceptance filters, so unwanted frames are
+     * dropped by the controller instead of being read over SPI and thrown away in canReadRequest.
+     * RXB0 checks mask 0 against filters 0-1 and RXB1 checks mask 1 against filters 2-5. All of a
+     * buffer's filters share its mask, and a standard frame is compared against the extended mask
+     * bits using its first two data bytes, so a buffer holds either standard or extended IDs, never
+     * both. When the list is empty or does not fit, both masks are opened (every frame is received)
+     * and the positive list is checked in software instead. Negative IDs are always software */
+    void applyCanHardwareFilters()
+    {
+        uint32_t standardIDs[MAX_POSITIVE_CAN_MASKS];
+        uint32_t extendedIDs[MAX_POSITIVE_CAN_MASKS];
+        uint8_t standardCount{0};
+        uint8_t extendedCount{0};
+        for (uint8_t i = 0; i < MAX_POSITIVE_CAN_MASKS; i++) {
+            if (positiveCanMasks[i] == EMPTY_CAN_MASK_SLOT) {
+                continue;
+            }
+            if (positiveCanMasks[i] <= MAX_STANDARD_CAN_ID) {
+                standardIDs[standardCount++] = positiveCanMasks[i];
+            } else {
+                extendedIDs[extendedCount++] = positiveCanMasks[i];
+            }
+        }
+        INT8U maskExt[MCP_N_MASKS]{0, 0};
+        INT32U masks[MCP_N_MASKS]{0, 0};
+        INT8U filterExt[MCP_N_FILTERS]{0, 0, 0, 0, 0, 0};
+        INT32U filters[MCP_N_FILTERS]{0, 0, 0, 0, 0, 0};
+        const uint8_t rxb1Filters{MCP_N_FILTERS - MCP_N_RXB0_FILTERS};
+        bool fits{true};
+        if ((standardCount + extendedCount) == 0) {
+            fits = false;
+        } else if ((extendedCount == 0) || (standardCount == 0)) {
+            //One kind only, so it is spread over all six filters (RXB1 takes whatever RXB0 has no room for)
+            const uint32_t *ids{(extendedCount == 0) ? standardIDs : extendedIDs};
+            uint8_t idCount{static_cast<uint8_t>(standardCount + extendedCount)};
+            INT8U extended{static_cast<INT8U>((extendedCount == 0) ? CAN_NORMAL_FRAME : CAN_EXTENDED_FRAME)};
+            if (idCount > MCP_N_FILTERS) {
+                fits = false;
+            } else if (idCount > MCP_N_RXB0_FILTERS) {
+                assignCanReceiveBuffer(0, ids, MCP_N_RXB0_FILTERS, extended, maskExt, masks, filterExt, filters);
+                assignCanReceiveBuffer(1, ids + MCP_N_RXB0_FILTERS, idCount - MCP_N_RXB0_FILTERS, extended, maskExt, masks, filterExt, filters);
+            } else {
+                assignCanReceiveBuffer(0, ids, idCount, extended, maskExt, masks, filterExt, filters);
+                assignCanReceiveBuffer(1, ids, idCount, extended, maskExt, masks, filterExt, filters);
+            }
+        } else if ((standardCount <= MCP_N_RXB0_FILTERS) && (extendedCount <= rxb1Filters)) {
+            assignCanReceiveBuffer(0, standardIDs, standardCount, CAN_NORMAL_FRAME, maskExt, masks, filterExt, filters);
+            assignCanReceiveBuffer(1, extendedIDs, extendedCount, CAN_EXTENDED_FRAME, maskExt, masks, filterExt, filters);
+        } else if ((extendedCount <= MCP_N_RXB0_FILTERS) && (standardCount <= rxb1Filters)) {
+            assignCanReceiveBuffer(0, extendedIDs, extendedCount, CAN_EXTENDED_FRAME, maskExt, masks, filterExt, filters);
+            assignCanReceiveBuffer(1, standardIDs, standardCount, CAN_NORMAL_FRAME, maskExt, masks, filterExt, filters);
+        } else {
+            fits = false;
+        }
+        if (!fits) {
+            for (uint8_t i = 0; i < MCP_N_MASKS; i++) {
+                maskExt[i] = 0;
+                masks[i] = 0;
+            }
+        }
+        suspendCanReceiveInterrupt();
+        canHardwareFiltering = (fits && (canController->init_MasksAndFilts(maskExt, masks, filterExt, filters) == MCP2515_OK));
+        resumeCanReceiveInterrupt();
+    }
+
+    //Points every filter of one receive buffer at ids, repeating them when there are fewer IDs than filters
+    void assignCanReceiveBuffer(uint8_t buffer, const uint32_t *ids, uint8_t idCount, INT8U extended, INT8U *maskExt, INT32U *masks, INT8U *filterExt, INT32U *filters)
+    {
+        uint8_t firstFilter{static_cast<uint8_t>((buffer == 0) ? 0 : MCP_N_RXB0_FILTERS)};
+        uint8_t lastFilter{static_cast<uint8_t>((buffer == 0) ? MCP_N_RXB0_FILTERS : MCP_N_FILTERS)};
+        maskExt[buffer] = extended;
+        masks[buffer] = (extended ? MAX_EXTENDED_CAN_ID : MAX_STANDARD_CAN_ID);
+        for (uint8_t i = firstFilter; i < lastFilter; i++) {
+            filterExt[i] = extended;
+            filters[i] = ids[(i - firstFilter) % idCount];
+        }
+    }
+
+    //The controller has already applied the positive list when canHardwareFiltering is set
+    bool canMessageAccepted(uint32_t canID)
+    {
+        if ((numberOfNegativeCanMasks() != 0) && (negativeCanMaskExists(canID))) {
+            return false;
+        }
+        if ((canHardwareFiltering) || (numberOfPositiveCanMasks() == 0)) {
+            return true;
+        }
+        return positiveCanMaskExists(canID);
+    }
+
     uint8_t numberOfPositiveCanMasks()
     {
         uint8_t returnLength{0};
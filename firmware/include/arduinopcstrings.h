@@ -6,81 +6,93 @@
 namespace ArduinoPCStrings
 {
 #if defined(ARDUINO_AVR_UNO)
-    const char * const ARDUINO_TYPE{"arduino_uno"};
+    constexpr const char *ARDUINO_TYPE{"arduino_uno"};
 #elif defined(ARDUINO_AVR_NANO)
-    const char * const ARDUINO_TYPE{"arduino_nano"};
+    constexpr const char *ARDUINO_TYPE{"arduino_nano"};
 #elif defined(ARDUINO_AVR_MEGA1280) || defined(ARDUINO_AVR_MEGA2560)
-    const char * const ARDUINO_TYPE{"arduino_mega"};
+    constexpr const char *ARDUINO_TYPE{"arduino_mega"};
 #endif
 
 #if defined(__HAVE_CAN_BUS__)
-    const char * const CLEAR_NEGATIVE_CAN_MASKS_HEADER{"clearncanmasks"};
-    const char * const CURRENT_NEGATIVE_CAN_MASKS_HEADER{"curncanmasks"};
-    const char * const CURRENT_POSITIVE_CAN_MASKS_HEADER{"curpcanmasks"};
-    const char * const CLEAR_ALL_CAN_MASKS_HEADER{"clearallcanmasks"};
-    const char * const CAN_INIT_HEADER{"caninit"};
-    const char * const CAN_READ_HEADER{"canread"};
-    const char * const CAN_WRITE_HEADER{"canwrite"};
-    const char * const CAN_WRITE_ONCE_HEADER{"canwriteo"};
-    const char * const CAN_LIVE_UPDATE_HEADER{"canlup"};
-    const char * const CLEAR_CAN_MESSAGES_HEADER{"clearcanmsgs"};
-    const char * const CLEAR_CAN_MESSAGE_BY_ID_HEADER{"clearcanmsgid"};
-    const char * const CURRENT_CAN_MESSAGES_HEADER{"curcanmsgs"};
-    const char * const CURRENT_CAN_MESSAGE_BY_ID_HEADER{"curcanmsgid"};
-    const char * const CLEAR_POSITIVE_CAN_MASKS_HEADER{"clearpcanmasks"};
+    constexpr const char *CLEAR_NEGATIVE_CAN_MASKS_HEADER{"clearncanmasks"};
+    constexpr const char *CURRENT_NEGATIVE_CAN_MASKS_HEADER{"curncanmasks"};
+    constexpr const char *CURRENT_POSITIVE_CAN_MASKS_HEADER{"curpcanmasks"};
+    constexpr const char *CLEAR_ALL_CAN_MASKS_HEADER{"clearallcanmasks"};
+    constexpr const char *CAN_INIT_HEADER{"caninit"};
+    constexpr const char *CAN_READ_HEADER{"canread"};
+    constexpr const char *CAN_WRITE_HEADER{"canwrite"};
+    constexpr const char *CAN_WRITE_ONCE_HEADER{"canwriteo"};
+    constexpr const char *CAN_LIVE_UPDATE_HEADER{"canlup"};
+    constexpr const char *CLEAR_CAN_MESSAGES_HEADER{"clearcanmsgs"};
+    constexpr const char *CLEAR_CAN_MESSAGE_BY_ID_HEADER{"clearcanmsgid"};
+    constexpr const char *CURRENT_CAN_MESSAGES_HEADER{"curcanmsgs"};
+    constexpr const char *CURRENT_CAN_MESSAGE_BY_ID_HEADER{"curcanmsgid"};
+    constexpr const char *CLEAR_POSITIVE_CAN_MASKS_HEADER{"clearpcanmasks"};
     
-    const char * const ADD_POSITIVE_CAN_MASK_HEADER{"addpcanmask"};
-    const char * const ADD_NEGATIVE_CAN_MASK_HEADER{"addncanmask"};
-    const char * const ALL_CURRENT_CAN_MASKS_HEADER{"allcanmasks"};
+    constexpr const char *ADD_POSITIVE_CAN_MASK_HEADER{"addpcanmask"};
+    constexpr const char *ADD_NEGATIVE_CAN_MASK_HEADER{"addncanmask"};
+    constexpr const char *ALL_CURRENT_CAN_MASKS_HEADER{"allcanmasks"};
     
-    const char * const REMOVE_POSITIVE_CAN_MASK_HEADER{"rempcanmask"};
-    const char * const REMOVE_NEGATIVE_CAN_MASK_HEADER{"remncanmask"};
+    constexpr const char *REMOVE_POSITIVE_CAN_MASK_HEADER{"rempcanmask"};
+    constexpr const char *REMOVE_NEGATIVE_CAN_MASK_HEADER{"remncanmask"};
+    constexpr const char *SET_POSITIVE_CAN_MASKS_HEADER{"setpcanmasks"};
+    constexpr const char *SET_NEGATIVE_CAN_MASKS_HEADER{"setncanmasks"};
+    constexpr const char *CAN_RECEIVE_OVERFLOWS_HEADER{"canrxovf"};
+    constexpr const char *CAN_BATCH_SIZE_HEADER{"canbsize"};
+    constexpr const char *CAN_BATCH_HEADER{"canbatch"};
 #endif
 
 #if defined(__HAVE_LIN_BUS__)
 
 #endif
 
-    const char * const HARDWARE_SERIAL_RX_PIN_TYPE{"hardserialrx"};
-    const char * const HARDWARE_SERIAL_TX_PIN_TYPE{"hardserialtx"};
-    const char * const SOFTWARE_SERIAL_RX_PIN_TYPE{"softserialrx"};
-    const char * const SOFTWARE_SERIAL_TX_PIN_TYPE{"softserialtx"};
+    constexpr const char *HARDWARE_SERIAL_RX_PIN_TYPE{"hardserialrx"};
+    constexpr const char *HARDWARE_SERIAL_TX_PIN_TYPE{"hardserialtx"};
+    constexpr const char *SOFTWARE_SERIAL_RX_PIN_TYPE{"softserialrx"};
+    constexpr const char *SOFTWARE_SERIAL_TX_PIN_TYPE{"softserialtx"};
 
-    const char * const INITIALIZATION_HEADER{"arduinopc-firmware"};
+    constexpr const char *INITIALIZATION_HEADER{"arduinopc-firmware"};
 
-    const char * const ARDUINO_TYPE_HEADER{"ardtype"};
-    const char * const ANALOG_READ_HEADER{"aread"};
-    const char * const ANALOG_WRITE_HEADER{"awrite"};
-    const char * const CHANGE_A_TO_D_THRESHOLD_HEADER{"atodchange"};
-    const char * const CURRENT_A_TO_D_THRESHOLD_HEADER{"atodthresh"};
-    const char * const ADD_SOFTWARE_SERIAL_HEADER{"addsoftserial"};
-    const char * const REMOVE_SOFTWARE_SERIAL_HEADER{"remsoftserial"};
+    constexpr const char *ARDUINO_TYPE_HEADER{"ardtype"};
+    constexpr const char *ANALOG_READ_HEADER{"aread"};
+    constexpr const char *ANALOG_READ_MULTI_HEADER{"areadmulti"};
+    constexpr const char *ANALOG_WRITE_HEADER{"awrite"};
+    constexpr const char *CHANGE_A_TO_D_THRESHOLD_HEADER{"atodchange"};
+    constexpr const char *CURRENT_A_TO_D_THRESHOLD_HEADER{"atodthresh"};
+    constexpr const char *ADD_SOFTWARE_SERIAL_HEADER{"addsoftserial"};
+    constexpr const char *REMOVE_SOFTWARE_SERIAL_HEADER{"remsoftserial"};
     
-    const char * const CAN_BUS_ENABLED_HEADER{"canbus"};
-    const char * const LIN_BUS_ENABLED_HEADER{"linbus"};
+    constexpr const char *CAN_BUS_ENABLED_HEADER{"canbus"};
+    constexpr const char *LIN_BUS_ENABLED_HEADER{"linbus"};
     
-    const char * const DIGITAL_READ_HEADER{"dread"};
-    const char * const DIGITAL_WRITE_HEADER{"dwrite"};
-    const char * const DIGITAL_WRITE_ALL_HEADER{"dwriteall"};
+    constexpr const char *DIGITAL_READ_HEADER{"dread"};
+    constexpr const char *DIGITAL_WRITE_HEADER{"dwrite"};
+    constexpr const char *DIGITAL_WRITE_ALL_HEADER{"dwriteall"};
+    constexpr const char *DIGITAL_READ_MULTI_HEADER{"dreadmulti"};
+    constexpr const char *DIGITAL_WRITE_MULTI_HEADER{"dwritemulti"};
     
-    const char * const IO_REPORT_HEADER{"ioreport"};
+    constexpr const char *IO_REPORT_HEADER{"ioreport"};
+    constexpr const char *IO_REPORT_DELTA_HEADER{"ioreportdelta"};
+    constexpr const char *IO_STREAM_HEADER{"iostream"};
+    constexpr const char *IO_DEADBAND_HEADER{"iodeadband"};
     
-    const char * const PIN_TYPE_HEADER{"ptype"};
-    const char * const PIN_TYPE_CHANGE_HEADER{"ptchange"};
+    constexpr const char *PIN_TYPE_HEADER{"ptype"};
+    constexpr const char *PIN_TYPE_CHANGE_HEADER{"ptchange"};
     
-    const char * const SOFT_DIGITAL_READ_HEADER{"sdread"};
-    const char * const SOFT_ANALOG_READ_HEADER{"saread"};
+    constexpr const char *SOFT_DIGITAL_READ_HEADER{"sdread"};
+    constexpr const char *SOFT_ANALOG_READ_HEADER{"saread"};
 
-    const char * const FIRMWARE_VERSION_HEADER{"version"};
-    const char * const IO_REPORT_END_HEADER{"ioreportend"};
-    const char * const DIGITAL_INPUT_IDENTIFIER{"din"};
-    const char * const DIGITAL_OUTPUT_IDENTIFIER{"dout"};
-    const char * const DIGITAL_INPUT_PULLUP_IDENTIFIER{"dinpup"};
-    const char * const ANALOG_INPUT_IDENTIFIER{"ain"};
-    const char * const ANALOG_OUTPUT_IDENTIFIER{"aout"};
-    const char * const UNSPECIFIED_IO_TYPE_IDENTIFIER{"unspecified"};
-    const char * const INVALID_HEADER{"invalid"};
-    const char * const FIRMWARE_VERSION{"0.50"};   
+    constexpr const char *FIRMWARE_VERSION_HEADER{"version"};
+    constexpr const char *BINARY_MODE_HEADER{"binmode"};
+    constexpr const char *IO_REPORT_END_HEADER{"ioreportend"};
+    constexpr const char *DIGITAL_INPUT_IDENTIFIER{"din"};
+    constexpr const char *DIGITAL_OUTPUT_IDENTIFIER{"dout"};
+    constexpr const char *DIGITAL_INPUT_PULLUP_IDENTIFIER{"dinpup"};
+    constexpr const char *ANALOG_INPUT_IDENTIFIER{"ain"};
+    constexpr const char *ANALOG_OUTPUT_IDENTIFIER{"aout"};
+    constexpr const char *UNSPECIFIED_IO_TYPE_IDENTIFIER{"unspecified"};
+    constexpr const char *INVALID_HEADER{"invalid"};
+    constexpr const char *FIRMWARE_VERSION{"0.50"};   
 }
 
 #endif //ARDUINOPC_ARDUINOPCSTRINGS_H
\ No newline at end of file
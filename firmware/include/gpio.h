@@ -31,10 +31,16 @@ public:
     void setPinNumber(int pinNumber);
 
     int getIOAgnosticState();
+
+    bool reportedStateChanged(int state) const;
+    void setReportedState(int state);
+    void clearReportedState();
     
     static const int ANALOG_MAX;
     static void setAnalogToDigitalThreshold(int threshold);
     static int analogToDigitalThreshold();
+    static void setAnalogReportDeadband(int deadband);
+    static int analogReportDeadband();
 
     friend bool operator==(const GPIO &lhs, const GPIO &rhs)
     {
@@ -52,8 +58,12 @@ private:
     IOType m_ioType;
     bool m_logicState;
     int m_analogState;
+    int m_reportedState;
+    IOType m_reportedIOType;
+    bool m_stateReported;
 
     static int s_analogToDigitalThreshold;
+    static int s_analogReportDeadband;
 };
 
 #endif //ARDUINOPC_GPIO_H
\ No newline at end of file
@@ -0,0 +1,48 @@
+#ifndef ARDUINOPC_PINCAPABILITIES_H
+#define ARDUINOPC_PINCAPABILITIES_H
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/* Pin capability masks, one bit per pin number, worked out by the compiler from the per-board pin
+ * lists. Asking whether a pin is analog, PWM and so on is then one flash byte read and one bit
+ * test, instead of a pgm_read_byte_near() walk of the list to its -1 terminator. The masks cover
+ * pins 0 to 71, which holds the Mega's highest (A15, 69) */
+namespace PinCapabilities
+{
+    constexpr uint8_t PIN_MASK_SIZE{9};
+    constexpr int PIN_MASK_PINS{PIN_MASK_SIZE * 8};
+
+    constexpr uint8_t pinMaskBit(uint8_t byteIndex, int pinNumber)
+    {
+        return (((pinNumber >= 0) && (pinNumber < PIN_MASK_PINS) && ((pinNumber >> 3) == byteIndex)) ? static_cast<uint8_t>(1 << (pinNumber & 7)) : 0);
+    }
+
+    constexpr uint8_t pinMaskByte(uint8_t)
+    {
+        return 0;
+    }
+
+    template <typename... Pins>
+    constexpr uint8_t pinMaskByte(uint8_t byteIndex, int pinNumber, Pins... pins)
+    {
+        return (pinMaskBit(byteIndex, pinNumber) | pinMaskByte(byteIndex, pins...));
+    }
+
+    //mask must be a PIN_MASK_SIZE byte table in PROGMEM
+    inline bool pinMaskTest(const uint8_t *mask, int pinNumber)
+    {
+        return ((pinNumber >= 0) && (pinNumber < PIN_MASK_PINS) && ((pgm_read_byte_near(mask + (pinNumber >> 3)) & (1 << (pinNumber & 7))) != 0));
+    }
+}
+
+//Initializer for a PIN_MASK_SIZE byte table holding every pin in the list
+#define PIN_MASK(...) {                                                                            \
+    PinCapabilities::pinMaskByte(0, __VA_ARGS__), PinCapabilities::pinMaskByte(1, __VA_ARGS__),    \
+    PinCapabilities::pinMaskByte(2, __VA_ARGS__), PinCapabilities::pinMaskByte(3, __VA_ARGS__),    \
+    PinCapabilities::pinMaskByte(4, __VA_ARGS__), PinCapabilities::pinMaskByte(5, __VA_ARGS__),    \
+    PinCapabilities::pinMaskByte(6, __VA_ARGS__), PinCapabilities::pinMaskByte(7, __VA_ARGS__),    \
+    PinCapabilities::pinMaskByte(8, __VA_ARGS__)                                                   \
+}
+
+#endif //ARDUINOPC_PINCAPABILITIES_H
@@ -0,0 +1,162 @@
+#ifndef ARDUINOPC_REQUESTDISPATCH_H
+#define ARDUINOPC_REQUESTDISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "arduinopcstrings.h"
+
+/* Resolves the header of a request (everything before the first ':') to a RequestType in
+ * O(header length): one pass hashes the header, a switch on the hash picks the only header it can
+ * be, and one compare confirms it. The case labels are the hashes of the ArduinoPCStrings headers,
+ * worked out by the compiler, which lays the switch out as a compare tree in flash. Two headers
+ * hashing to the same value are duplicate case labels, so the hash stays perfect over the header
+ * set or the firmware does not build. Headers match whole, so "dread" no longer needs to be tried
+ * after "dreadmulti" the way the startsWith chain needed */
+namespace RequestDispatch
+{
+    enum RequestType : uint8_t
+    {
+        UNKNOWN_REQUEST,
+        ANALOG_READ_REQUEST,
+        ANALOG_READ_MULTI_REQUEST,
+        CHANGE_A_TO_D_THRESHOLD_REQUEST,
+        ANALOG_WRITE_REQUEST,
+        DIGITAL_READ_REQUEST,
+        DIGITAL_READ_MULTI_REQUEST,
+        DIGITAL_WRITE_REQUEST,
+        DIGITAL_WRITE_ALL_REQUEST,
+        DIGITAL_WRITE_MULTI_REQUEST,
+        PIN_TYPE_REQUEST,
+        PIN_TYPE_CHANGE_REQUEST,
+        SOFT_DIGITAL_READ_REQUEST,
+        SOFT_ANALOG_READ_REQUEST,
+        BINARY_MODE_REQUEST,
+        FIRMWARE_VERSION_REQUEST,
+        IO_REPORT_REQUEST,
+        IO_REPORT_DELTA_REQUEST,
+        IO_DEADBAND_REQUEST,
+        IO_STREAM_REQUEST,
+        CURRENT_A_TO_D_THRESHOLD_REQUEST,
+        ARDUINO_TYPE_REQUEST,
+        CAN_BUS_ENABLED_REQUEST,
+        LIN_BUS_ENABLED_REQUEST,
+        ADD_SOFTWARE_SERIAL_REQUEST,
+        REMOVE_SOFTWARE_SERIAL_REQUEST,
+#if defined(__HAVE_CAN_BUS__)
+        CAN_INIT_REQUEST,
+        CAN_READ_REQUEST,
+        CAN_WRITE_ONCE_REQUEST,
+        CAN_LIVE_UPDATE_REQUEST,
+        CLEAR_CAN_MESSAGE_BY_ID_REQUEST,
+        CURRENT_CAN_MESSAGE_BY_ID_REQUEST,
+        REMOVE_NEGATIVE_CAN_MASK_REQUEST,
+        REMOVE_POSITIVE_CAN_MASK_REQUEST,
+        ADD_POSITIVE_CAN_MASK_REQUEST,
+        ADD_NEGATIVE_CAN_MASK_REQUEST,
+        SET_POSITIVE_CAN_MASKS_REQUEST,
+        SET_NEGATIVE_CAN_MASKS_REQUEST,
+        CURRENT_CAN_MESSAGES_REQUEST,
+        CLEAR_CAN_MESSAGES_REQUEST,
+        ALL_CURRENT_CAN_MASKS_REQUEST,
+        CURRENT_POSITIVE_CAN_MASKS_REQUEST,
+        CURRENT_NEGATIVE_CAN_MASKS_REQUEST,
+        CLEAR_POSITIVE_CAN_MASKS_REQUEST,
+        CLEAR_NEGATIVE_CAN_MASKS_REQUEST,
+        CLEAR_ALL_CAN_MASKS_REQUEST,
+        CAN_RECEIVE_OVERFLOWS_REQUEST,
+        CAN_BATCH_SIZE_REQUEST,
+#endif
+        REQUEST_TYPE_COUNT
+    };
+
+    //djb2, kept to 16 bits so each step is a few shifts and adds on the AVR
+    constexpr uint16_t REQUEST_HEADER_HASH_SEED{5381};
+
+    constexpr uint16_t nextRequestHeaderHash(uint16_t hash, char c)
+    {
+        return static_cast<uint16_t>((hash << 5) + hash + static_cast<uint8_t>(c));
+    }
+
+    constexpr uint16_t requestHeaderHash(const char *header, uint16_t hash = REQUEST_HEADER_HASH_SEED)
+    {
+        return ((*header == '\0') ? hash : requestHeaderHash(header + 1, nextRequestHeaderHash(hash, *header)));
+    }
+
+    inline bool isRequestHeaderEnd(char c)
+    {
+        return ((c == '\0') || (c == ':') || (c == '\r') || (c == '\n'));
+    }
+
+    inline RequestType confirmRequestHeader(const char *str, size_t headerLength, const char *header, RequestType requestType)
+    {
+        return (((strncmp(str, header, headerLength) == 0) && (header[headerLength] == '\0')) ? requestType : UNKNOWN_REQUEST);
+    }
+
+    inline RequestType requestType(const char *str)
+    {
+        using namespace ArduinoPCStrings;
+        if (!str) {
+            return UNKNOWN_REQUEST;
+        }
+        uint16_t hash{REQUEST_HEADER_HASH_SEED};
+        size_t headerLength{0};
+        while (!isRequestHeaderEnd(str[headerLength])) {
+            hash = nextRequestHeaderHash(hash, str[headerLength++]);
+        }
+        switch (hash) {
+            case requestHeaderHash(ANALOG_READ_HEADER): return confirmRequestHeader(str, headerLength, ANALOG_READ_HEADER, ANALOG_READ_REQUEST);
+            case requestHeaderHash(ANALOG_READ_MULTI_HEADER): return confirmRequestHeader(str, headerLength, ANALOG_READ_MULTI_HEADER, ANALOG_READ_MULTI_REQUEST);
+            case requestHeaderHash(CHANGE_A_TO_D_THRESHOLD_HEADER): return confirmRequestHeader(str, headerLength, CHANGE_A_TO_D_THRESHOLD_HEADER, CHANGE_A_TO_D_THRESHOLD_REQUEST);
+            case requestHeaderHash(ANALOG_WRITE_HEADER): return confirmRequestHeader(str, headerLength, ANALOG_WRITE_HEADER, ANALOG_WRITE_REQUEST);
+            case requestHeaderHash(DIGITAL_READ_HEADER): return confirmRequestHeader(str, headerLength, DIGITAL_READ_HEADER, DIGITAL_READ_REQUEST);
+            case requestHeaderHash(DIGITAL_READ_MULTI_HEADER): return confirmRequestHeader(str, headerLength, DIGITAL_READ_MULTI_HEADER, DIGITAL_READ_MULTI_REQUEST);
+            case requestHeaderHash(DIGITAL_WRITE_HEADER): return confirmRequestHeader(str, headerLength, DIGITAL_WRITE_HEADER, DIGITAL_WRITE_REQUEST);
+            case requestHeaderHash(DIGITAL_WRITE_ALL_HEADER): return confirmRequestHeader(str, headerLength, DIGITAL_WRITE_ALL_HEADER, DIGITAL_WRITE_ALL_REQUEST);
+            case requestHeaderHash(DIGITAL_WRITE_MULTI_HEADER): return confirmRequestHeader(str, headerLength, DIGITAL_WRITE_MULTI_HEADER, DIGITAL_WRITE_MULTI_REQUEST);
+            case requestHeaderHash(PIN_TYPE_HEADER): return confirmRequestHeader(str, headerLength, PIN_TYPE_HEADER, PIN_TYPE_REQUEST);
+            case requestHeaderHash(PIN_TYPE_CHANGE_HEADER): return confirmRequestHeader(str, headerLength, PIN_TYPE_CHANGE_HEADER, PIN_TYPE_CHANGE_REQUEST);
+            case requestHeaderHash(SOFT_DIGITAL_READ_HEADER): return confirmRequestHeader(str, headerLength, SOFT_DIGITAL_READ_HEADER, SOFT_DIGITAL_READ_REQUEST);
+            case requestHeaderHash(SOFT_ANALOG_READ_HEADER): return confirmRequestHeader(str, headerLength, SOFT_ANALOG_READ_HEADER, SOFT_ANALOG_READ_REQUEST);
+            case requestHeaderHash(BINARY_MODE_HEADER): return confirmRequestHeader(str, headerLength, BINARY_MODE_HEADER, BINARY_MODE_REQUEST);
+            case requestHeaderHash(FIRMWARE_VERSION_HEADER): return confirmRequestHeader(str, headerLength, FIRMWARE_VERSION_HEADER, FIRMWARE_VERSION_REQUEST);
+            case requestHeaderHash(IO_REPORT_HEADER): return confirmRequestHeader(str, headerLength, IO_REPORT_HEADER, IO_REPORT_REQUEST);
+            case requestHeaderHash(IO_REPORT_DELTA_HEADER): return confirmRequestHeader(str, headerLength, IO_REPORT_DELTA_HEADER, IO_REPORT_DELTA_REQUEST);
+            case requestHeaderHash(IO_DEADBAND_HEADER): return confirmRequestHeader(str, headerLength, IO_DEADBAND_HEADER, IO_DEADBAND_REQUEST);
+            case requestHeaderHash(IO_STREAM_HEADER): return confirmRequestHeader(str, headerLength, IO_STREAM_HEADER, IO_STREAM_REQUEST);
+            case requestHeaderHash(CURRENT_A_TO_D_THRESHOLD_HEADER): return confirmRequestHeader(str, headerLength, CURRENT_A_TO_D_THRESHOLD_HEADER, CURRENT_A_TO_D_THRESHOLD_REQUEST);
+            case requestHeaderHash(ARDUINO_TYPE_HEADER): return confirmRequestHeader(str, headerLength, ARDUINO_TYPE_HEADER, ARDUINO_TYPE_REQUEST);
+            case requestHeaderHash(CAN_BUS_ENABLED_HEADER): return confirmRequestHeader(str, headerLength, CAN_BUS_ENABLED_HEADER, CAN_BUS_ENABLED_REQUEST);
+            case requestHeaderHash(LIN_BUS_ENABLED_HEADER): return confirmRequestHeader(str, headerLength, LIN_BUS_ENABLED_HEADER, LIN_BUS_ENABLED_REQUEST);
+            case requestHeaderHash(ADD_SOFTWARE_SERIAL_HEADER): return confirmRequestHeader(str, headerLength, ADD_SOFTWARE_SERIAL_HEADER, ADD_SOFTWARE_SERIAL_REQUEST);
+            case requestHeaderHash(REMOVE_SOFTWARE_SERIAL_HEADER): return confirmRequestHeader(str, headerLength, REMOVE_SOFTWARE_SERIAL_HEADER, REMOVE_SOFTWARE_SERIAL_REQUEST);
+#if defined(__HAVE_CAN_BUS__)
+            case requestHeaderHash(CAN_INIT_HEADER): return confirmRequestHeader(str, headerLength, CAN_INIT_HEADER, CAN_INIT_REQUEST);
+            case requestHeaderHash(CAN_READ_HEADER): return confirmRequestHeader(str, headerLength, CAN_READ_HEADER, CAN_READ_REQUEST);
+            case requestHeaderHash(CAN_WRITE_ONCE_HEADER): return confirmRequestHeader(str, headerLength, CAN_WRITE_ONCE_HEADER, CAN_WRITE_ONCE_REQUEST);
+            case requestHeaderHash(CAN_LIVE_UPDATE_HEADER): return confirmRequestHeader(str, headerLength, CAN_LIVE_UPDATE_HEADER, CAN_LIVE_UPDATE_REQUEST);
+            case requestHeaderHash(CLEAR_CAN_MESSAGE_BY_ID_HEADER): return confirmRequestHeader(str, headerLength, CLEAR_CAN_MESSAGE_BY_ID_HEADER, CLEAR_CAN_MESSAGE_BY_ID_REQUEST);
+            case requestHeaderHash(CURRENT_CAN_MESSAGE_BY_ID_HEADER): return confirmRequestHeader(str, headerLength, CURRENT_CAN_MESSAGE_BY_ID_HEADER, CURRENT_CAN_MESSAGE_BY_ID_REQUEST);
+            case requestHeaderHash(REMOVE_NEGATIVE_CAN_MASK_HEADER): return confirmRequestHeader(str, headerLength, REMOVE_NEGATIVE_CAN_MASK_HEADER, REMOVE_NEGATIVE_CAN_MASK_REQUEST);
+            case requestHeaderHash(REMOVE_POSITIVE_CAN_MASK_HEADER): return confirmRequestHeader(str, headerLength, REMOVE_POSITIVE_CAN_MASK_HEADER, REMOVE_POSITIVE_CAN_MASK_REQUEST);
+            case requestHeaderHash(ADD_POSITIVE_CAN_MASK_HEADER): return confirmRequestHeader(str, headerLength, ADD_POSITIVE_CAN_MASK_HEADER, ADD_POSITIVE_CAN_MASK_REQUEST);
+            case requestHeaderHash(ADD_NEGATIVE_CAN_MASK_HEADER): return confirmRequestHeader(str, headerLength, ADD_NEGATIVE_CAN_MASK_HEADER, ADD_NEGATIVE_CAN_MASK_REQUEST);
+            case requestHeaderHash(SET_POSITIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, SET_POSITIVE_CAN_MASKS_HEADER, SET_POSITIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(SET_NEGATIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, SET_NEGATIVE_CAN_MASKS_HEADER, SET_NEGATIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CURRENT_CAN_MESSAGES_HEADER): return confirmRequestHeader(str, headerLength, CURRENT_CAN_MESSAGES_HEADER, CURRENT_CAN_MESSAGES_REQUEST);
+            case requestHeaderHash(CLEAR_CAN_MESSAGES_HEADER): return confirmRequestHeader(str, headerLength, CLEAR_CAN_MESSAGES_HEADER, CLEAR_CAN_MESSAGES_REQUEST);
+            case requestHeaderHash(ALL_CURRENT_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, ALL_CURRENT_CAN_MASKS_HEADER, ALL_CURRENT_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CURRENT_POSITIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, CURRENT_POSITIVE_CAN_MASKS_HEADER, CURRENT_POSITIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CURRENT_NEGATIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, CURRENT_NEGATIVE_CAN_MASKS_HEADER, CURRENT_NEGATIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CLEAR_POSITIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, CLEAR_POSITIVE_CAN_MASKS_HEADER, CLEAR_POSITIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CLEAR_NEGATIVE_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, CLEAR_NEGATIVE_CAN_MASKS_HEADER, CLEAR_NEGATIVE_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CLEAR_ALL_CAN_MASKS_HEADER): return confirmRequestHeader(str, headerLength, CLEAR_ALL_CAN_MASKS_HEADER, CLEAR_ALL_CAN_MASKS_REQUEST);
+            case requestHeaderHash(CAN_RECEIVE_OVERFLOWS_HEADER): return confirmRequestHeader(str, headerLength, CAN_RECEIVE_OVERFLOWS_HEADER, CAN_RECEIVE_OVERFLOWS_REQUEST);
+            case requestHeaderHash(CAN_BATCH_SIZE_HEADER): return confirmRequestHeader(str, headerLength, CAN_BATCH_SIZE_HEADER, CAN_BATCH_SIZE_REQUEST);
+#endif
+            default: return UNKNOWN_REQUEST;
+        }
+    }
+}
+
+#endif //ARDUINOPC_REQUESTDISPATCH_H
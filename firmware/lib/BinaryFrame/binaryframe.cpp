@@ -0,0 +1,57 @@
+#include "binaryframe.h"
+
+namespace BinaryFrame
+{
+    uint8_t crc8(const uint8_t *data, size_t length, uint8_t crc)
+    {
+        for (size_t i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    size_t frameSize(uint8_t payloadLength)
+    {
+        return BINARY_FRAME_HEADER_SIZE + payloadLength + BINARY_FRAME_CRC_SIZE;
+    }
+
+    size_t encode(uint8_t opcode, const uint8_t *payload, uint8_t length, uint8_t *out, size_t maximumSize)
+    {
+        if ((length > BINARY_FRAME_MAXIMUM_PAYLOAD) || (frameSize(length) > maximumSize)) {
+            return 0;
+        }
+        out[SYNC_OFFSET] = BINARY_FRAME_SYNC;
+        out[OPCODE_OFFSET] = opcode;
+        out[LENGTH_OFFSET] = length;
+        for (uint8_t i = 0; i < length; i++) {
+            out[PAYLOAD_OFFSET + i] = payload[i];
+        }
+        out[PAYLOAD_OFFSET + length] = crc8(out + OPCODE_OFFSET, length + 2);
+        return frameSize(length);
+    }
+
+    bool isValid(const uint8_t *frame, size_t length)
+    {
+        if ((length < BINARY_FRAME_HEADER_SIZE + BINARY_FRAME_CRC_SIZE) || (frame[SYNC_OFFSET] != BINARY_FRAME_SYNC)) {
+            return false;
+        }
+        if ((frame[LENGTH_OFFSET] > BINARY_FRAME_MAXIMUM_PAYLOAD) || (frameSize(frame[LENGTH_OFFSET]) != length)) {
+            return false;
+        }
+        return (crc8(frame + OPCODE_OFFSET, frame[LENGTH_OFFSET] + 2) == frame[PAYLOAD_OFFSET + frame[LENGTH_OFFSET]]);
+    }
+
+    void putUInt16(uint8_t *out, uint16_t value)
+    {
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+    }
+
+    uint16_t getUInt16(const uint8_t *in)
+    {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+}
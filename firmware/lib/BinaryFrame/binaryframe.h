@@ -0,0 +1,42 @@
+#ifndef ARDUINOPC_BINARYFRAME_H
+#define ARDUINOPC_BINARYFRAME_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Binary frame layout, all multi byte values little endian:
+ *   [SYNC][OPCODE][LENGTH][PAYLOAD (LENGTH bytes)][CRC8]
+ * The CRC (polynomial 0x07, initial value 0) covers OPCODE, LENGTH and PAYLOAD.
+ * Responses use the request opcode with BINARY_RESPONSE_FLAG set. The sync byte
+ * is never the first byte of an ASCII request, so both protocols share a port */
+#define BINARY_FRAME_SYNC 0xA5
+#define BINARY_FRAME_HEADER_SIZE 3
+#define BINARY_FRAME_CRC_SIZE 1
+#define BINARY_FRAME_MAXIMUM_PAYLOAD 32
+#define BINARY_FRAME_MAXIMUM_SIZE (BINARY_FRAME_HEADER_SIZE + BINARY_FRAME_MAXIMUM_PAYLOAD + BINARY_FRAME_CRC_SIZE)
+#define BINARY_RESPONSE_FLAG 0x80
+
+namespace BinaryFrame
+{
+    enum Opcode : uint8_t
+    {
+        DIGITAL_READ = 0x01,
+        DIGITAL_WRITE = 0x02,
+        ANALOG_READ = 0x03,
+        ANALOG_WRITE = 0x04,
+        SOFT_DIGITAL_READ = 0x05,
+        SOFT_ANALOG_READ = 0x06,
+        INVALID_OPCODE = 0x7F
+    };
+
+    enum FrameOffset { SYNC_OFFSET, OPCODE_OFFSET, LENGTH_OFFSET, PAYLOAD_OFFSET };
+
+    uint8_t crc8(const uint8_t *data, size_t length, uint8_t crc = 0);
+    size_t encode(uint8_t opcode, const uint8_t *payload, uint8_t length, uint8_t *out, size_t maximumSize);
+    bool isValid(const uint8_t *frame, size_t length);
+    size_t frameSize(uint8_t payloadLength);
+    void putUInt16(uint8_t *out, uint16_t value);
+    uint16_t getUInt16(const uint8_t *in);
+}
+
+#endif //ARDUINOPC_BINARYFRAME_H
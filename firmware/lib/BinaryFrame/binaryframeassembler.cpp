@@ -0,0 +1,61 @@
+#include "binaryframeassembler.h"
+
+BinaryFrameAssembler::BinaryFrameAssembler() :
+    m_buffer{},
+    m_length{0},
+    m_complete{false}
+{
+
+}
+
+//Returns true once a frame is complete, after which bytes are refused until clear()
+bool BinaryFrameAssembler::append(uint8_t byte)
+{
+    if (this->m_complete) {
+        return true;
+    }
+    if ((this->m_length == 0) && (byte != BINARY_FRAME_SYNC)) {
+        return false;
+    }
+    this->m_buffer[this->m_length++] = byte;
+    if (this->m_length < BINARY_FRAME_HEADER_SIZE) {
+        return false;
+    }
+    if ((this->oversized()) || (this->m_length == BinaryFrame::frameSize(this->m_buffer[BinaryFrame::LENGTH_OFFSET]))) {
+        this->m_complete = true;
+    }
+    return this->m_complete;
+}
+
+bool BinaryFrameAssembler::complete() const
+{
+    return this->m_complete;
+}
+
+//Nothing of a frame has arrived yet, so the next byte decides between a frame and a text line
+bool BinaryFrameAssembler::empty() const
+{
+    return (this->m_length == 0);
+}
+
+//The header asks for more payload than a frame can carry, so the rest of it is never read
+bool BinaryFrameAssembler::oversized() const
+{
+    return ((this->m_length >= BINARY_FRAME_HEADER_SIZE) && (this->m_buffer[BinaryFrame::LENGTH_OFFSET] > BINARY_FRAME_MAXIMUM_PAYLOAD));
+}
+
+uint8_t *BinaryFrameAssembler::frame()
+{
+    return this->m_buffer;
+}
+
+uint8_t BinaryFrameAssembler::length() const
+{
+    return this->m_length;
+}
+
+void BinaryFrameAssembler::clear()
+{
+    this->m_length = 0;
+    this->m_complete = false;
+}
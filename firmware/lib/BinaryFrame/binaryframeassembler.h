@@ -0,0 +1,49 @@
+#ifndef ARDUINOPC_BINARYFRAMEASSEMBLER_H
+#define ARDUINOPC_BINARYFRAMEASSEMBLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "binaryframe.h"
+
+/* Builds one binary frame per serial port out of whatever bytes have already arrived, the
+ * binary counterpart of LineAssembler. The first byte taken has to be BINARY_FRAME_SYNC. Once
+ * the header is in, the length byte says how many more bytes make up the frame, and poll()
+ * never takes a byte past that, so the next request stays in the port. A header whose length
+ * is over BINARY_FRAME_MAXIMUM_PAYLOAD completes the frame early with oversized() set, so the
+ * caller can refuse it. The finished frame stays in frame() until clear() is called */
+class BinaryFrameAssembler
+{
+public:
+    BinaryFrameAssembler();
+
+    bool append(uint8_t byte);
+    bool complete() const;
+    bool empty() const;
+    bool oversized() const;
+    uint8_t *frame();
+    uint8_t length() const;
+    void clear();
+
+    /* Reads the bytes the stream already has until a frame is complete and says whether one is.
+     * Input is Stream on the board and a fake in the tests; read() is only called after
+     * available() reports a byte, so this never blocks */
+    template <typename Input>
+    bool poll(Input *stream)
+    {
+        while ((!this->m_complete) && (stream->available() > 0)) {
+            int byteRead{stream->read()};
+            if (byteRead < 0) {
+                break;
+            }
+            this->append(static_cast<uint8_t>(byteRead));
+        }
+        return this->m_complete;
+    }
+
+private:
+    uint8_t m_buffer[BINARY_FRAME_MAXIMUM_SIZE];
+    uint8_t m_length;
+    bool m_complete;
+};
+
+#endif //ARDUINOPC_BINARYFRAMEASSEMBLER_H
@@ -0,0 +1,84 @@
+#include "canreceivering.h"
+
+#if defined(__AVR__)
+#    include <util/atomic.h>
+#    define CAN_RECEIVE_RING_ATOMIC ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#else
+#    define CAN_RECEIVE_RING_ATOMIC
+#endif
+
+CanReceiveRing::CanReceiveRing() :
+    m_records{},
+    m_head{0},
+    m_tail{0},
+    m_overflowCount{0}
+{
+
+}
+
+//Producer side, called from the interrupt handler
+bool CanReceiveRing::push(uint32_t id, uint8_t frameType, uint8_t length, const uint8_t *data)
+{
+    uint8_t head{this->m_head};
+    if (static_cast<uint8_t>(head - this->m_tail) >= CAN_RECEIVE_RING_SIZE) {
+        if (this->m_overflowCount < CAN_RECEIVE_RING_MAXIMUM_OVERFLOWS) {
+            this->m_overflowCount = this->m_overflowCount + 1;
+        }
+        return false;
+    }
+    CanReceiveRecord &record = this->m_records[head & (CAN_RECEIVE_RING_SIZE - 1)];
+    if (length > CAN_RECEIVE_RECORD_DATA_SIZE) {
+        length = CAN_RECEIVE_RECORD_DATA_SIZE;
+    }
+    record.id = id;
+    record.frameType = frameType;
+    record.length = length;
+    memcpy(record.data, data, length);
+    CAN_RECEIVE_RING_BARRIER();
+    this->m_head = static_cast<uint8_t>(head + 1);
+    return true;
+}
+
+//Consumer side, called from loop()
+bool CanReceiveRing::pop(CanReceiveRecord *record)
+{
+    uint8_t tail{this->m_tail};
+    if (tail == this->m_head) {
+        return false;
+    }
+    CAN_RECEIVE_RING_BARRIER();
+    *record = this->m_records[tail & (CAN_RECEIVE_RING_SIZE - 1)];
+    CAN_RECEIVE_RING_BARRIER();
+    this->m_tail = static_cast<uint8_t>(tail + 1);
+    return true;
+}
+
+bool CanReceiveRing::empty() const
+{
+    return (this->m_head == this->m_tail);
+}
+
+uint8_t CanReceiveRing::size() const
+{
+    return static_cast<uint8_t>(this->m_head - this->m_tail);
+}
+
+uint16_t CanReceiveRing::overflowCount() const
+{
+    uint16_t overflowCount{0};
+    CAN_RECEIVE_RING_ATOMIC {
+        overflowCount = this->m_overflowCount;
+    }
+    return overflowCount;
+}
+
+//Returns the frames dropped since the last call and starts counting again from zero
+uint16_t CanReceiveRing::takeOverflowCount()
+{
+    uint16_t overflowCount{0};
+    CAN_RECEIVE_RING_ATOMIC {
+        overflowCount = this->m_overflowCount;
+        this->m_overflowCount = 0;
+    }
+    return overflowCount;
+}
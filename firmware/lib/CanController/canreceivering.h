@@ -0,0 +1,73 @@
+#ifndef ARDUINOPC_CANRECEIVERING_H
+#define ARDUINOPC_CANRECEIVERING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef CAN_OK
+#    define CAN_OK (0)
+#endif
+
+//Must be a power of two no larger than 128, so the free running 8 bit indices wrap cleanly
+#ifndef CAN_RECEIVE_RING_SIZE
+#    define CAN_RECEIVE_RING_SIZE 16
+#endif
+
+#define CAN_RECEIVE_RECORD_DATA_SIZE 8
+#define CAN_RECEIVE_RING_MAXIMUM_OVERFLOWS 0xFFFF
+
+//Keeps the compiler from moving the record copy past the index store that publishes it
+#define CAN_RECEIVE_RING_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+/* A received frame as it comes off the controller. CanMessage no longer allocates, but a plain
+ * record keeps the interrupt handler and the ring down to straight field copies, with none of
+ * CanMessage's zeroing and length clamping in the handler */
+struct CanReceiveRecord
+{
+    uint32_t id;
+    uint8_t frameType;
+    uint8_t length;
+    uint8_t data[CAN_RECEIVE_RECORD_DATA_SIZE];
+};
+
+/* Single producer, single consumer ring between the CAN interrupt handler (push, drain) and
+ * loop() (pop). Each side only ever writes its own 8 bit index, and an 8 bit store is atomic on
+ * AVR, so neither side needs to disable interrupts. A frame that arrives while the ring is full
+ * is dropped and counted, and the count is collected with takeOverflowCount() */
+class CanReceiveRing
+{
+public:
+    CanReceiveRing();
+
+    bool push(uint32_t id, uint8_t frameType, uint8_t length, const uint8_t *data);
+    bool pop(CanReceiveRecord *record);
+    bool empty() const;
+    uint8_t size() const;
+    uint16_t overflowCount() const;
+    uint16_t takeOverflowCount();
+
+    /* Moves every frame the controller is holding into the ring and returns how many were read.
+     * readMsgBufID() answers CAN_NOMSG once both receive buffers are empty, so this costs no extra
+     * status read per frame. Controller is MCP_CAN on the board and a simulated one in the tests */
+    template <typename Controller>
+    uint8_t drain(Controller *controller)
+    {
+        uint8_t drained{0};
+        uint32_t id{0};
+        uint8_t length{0};
+        uint8_t data[CAN_RECEIVE_RECORD_DATA_SIZE];
+        while (controller->readMsgBufID(&id, &length, data) == CAN_OK) {
+            this->push(id, controller->isExtendedFrame(), length, data);
+            drained++;
+        }
+        return drained;
+    }
+
+private:
+    CanReceiveRecord m_records[CAN_RECEIVE_RING_SIZE];
+    volatile uint8_t m_head;
+    volatile uint8_t m_tail;
+    volatile uint16_t m_overflowCount;
+};
+
+#endif //ARDUINOPC_CANRECEIVERING_H
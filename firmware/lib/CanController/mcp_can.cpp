@@ -753,11 +753,62 @@ INT8U MCP_CAN::init_Filt(INT8U num, INT8U ext, INT32U ulData)
     return res;
 }
 
+/*********************************************************************************************************
+** Function name:           init_MasksAndFilts
+** Descriptions:            init both masks and all six filters with a single pass through
+**                          configuration mode, instead of one pass (and its delays) per register
+*********************************************************************************************************/
+INT8U MCP_CAN::init_MasksAndFilts(const INT8U *maskExt, const INT32U *masks,
+                                  const INT8U *filtExt, const INT32U *filts)
+{
+    const INT8U maskAddresses[MCP_N_MASKS] = { MCP_RXM0SIDH, MCP_RXM1SIDH };
+    const INT8U filtAddresses[MCP_N_FILTERS] = { MCP_RXF0SIDH, MCP_RXF1SIDH, MCP_RXF2SIDH,
+                                                 MCP_RXF3SIDH, MCP_RXF4SIDH, MCP_RXF5SIDH };
+    INT8U res = MCP2515_OK;
+    INT8U i;
+#if DEBUG_MODE
+    Serial.print("Begin to set Masks and Filters!!\r\n");
+#endif
+    res = mcp2515_setCANCTRL_Mode(MODE_CONFIG);
+    if(res > 0)
+    {
+#if DEBUG_MODE
+    Serial.print("Enter setting mode fall\r\n"); 
+#else
+    delay(10);
+#endif
+    return res;
+    }
+
+    for (i=0; i<MCP_N_MASKS; i++) {
+        mcp2515_write_id(maskAddresses[i], maskExt[i], masks[i]);
+    }
+    for (i=0; i<MCP_N_FILTERS; i++) {
+        mcp2515_write_id(filtAddresses[i], filtExt[i], filts[i]);
+    }
+
+    res = mcp2515_setCANCTRL_Mode(MODE_NORMAL);
+    if(res > 0)
+    {
+#if DEBUG_MODE
+    Serial.print("Enter normal mode fall\r\nSet Masks and Filters fail!!\r\n"); 
+#else
+    delay(10);
+#endif
+    return res;
+    }
+#if DEBUG_MODE
+    Serial.print("set Masks and Filters success!!\r\n");
+#endif
+
+    return res;
+}
+
 /*********************************************************************************************************
 ** Function name:           setMsg
 ** Descriptions:            set can message, such as dlc, id, dta[] and so on
 *********************************************************************************************************/
-INT8U MCP_CAN::setMsg(INT32U id, INT8U ext, INT8U len, INT8U rtr, INT8U *pData)
+INT8U MCP_CAN::setMsg(INT32U id, INT8U ext, INT8U len, INT8U rtr, const INT8U *pData)
 {
     m_nExtFlg = ext;
     m_nID     = id;
@@ -775,7 +826,7 @@ INT8U MCP_CAN::setMsg(INT32U id, INT8U ext, INT8U len, INT8U rtr, INT8U *pData)
 ** Function name:           setMsg
 ** Descriptions:            set can message, such as dlc, id, dta[] and so on
 *********************************************************************************************************/
-INT8U MCP_CAN::setMsg(INT32U id, INT8U ext, INT8U len, INT8U *pData)
+INT8U MCP_CAN::setMsg(INT32U id, INT8U ext, INT8U len, const INT8U *pData)
 {
     return setMsg( id, ext, len, 0, pData );
 }
@@ -836,7 +887,7 @@ INT8U MCP_CAN::sendMsg()
 ** Function name:           sendMsgBuf
 ** Descriptions:            send buf
 *********************************************************************************************************/
-INT8U MCP_CAN::sendMsgBuf(INT32U id, INT8U ext, INT8U rtr, INT8U len, INT8U *buf)
+INT8U MCP_CAN::sendMsgBuf(INT32U id, INT8U ext, INT8U rtr, INT8U len, const INT8U *buf)
 {
     setMsg(id, ext, len, rtr, buf);
     return sendMsg();
@@ -846,7 +897,7 @@ INT8U MCP_CAN::sendMsgBuf(INT32U id, INT8U ext, INT8U rtr, INT8U len, INT8U *buf
 ** Function name:           sendMsgBuf
 ** Descriptions:            send buf
 *********************************************************************************************************/
-INT8U MCP_CAN::sendMsgBuf(INT32U id, INT8U ext, INT8U len, INT8U *buf)
+INT8U MCP_CAN::sendMsgBuf(INT32U id, INT8U ext, INT8U len, const INT8U *buf)
 {
     setMsg(id, ext, len, buf);
     return sendMsg();
@@ -346,6 +346,9 @@
 #define MCPDEBUG        (0)
 #define MCPDEBUG_TXBUF  (0)
 #define MCP_N_TXBUFFERS (3)
+#define MCP_N_MASKS     (2)
+#define MCP_N_FILTERS   (6)
+#define MCP_N_RXB0_FILTERS (2)                                          /* RXB0 uses filters 0-1, RXB1 2-5 */
 
 #define MCP_RXBUF_0 (MCP_RXB0SIDH)
 #define MCP_RXBUF_1 (MCP_RXB1SIDH)
@@ -472,8 +475,8 @@ private:
 *  can operator function
 */    
 
-    INT8U setMsg(INT32U id, INT8U ext, INT8U len, INT8U rtr, INT8U *pData); /* set message                  */  
-    INT8U setMsg(INT32U id, INT8U ext, INT8U len, INT8U *pData); /* set message                  */  
+    INT8U setMsg(INT32U id, INT8U ext, INT8U len, INT8U rtr, const INT8U *pData); /* set message                  */  
+    INT8U setMsg(INT32U id, INT8U ext, INT8U len, const INT8U *pData); /* set message                  */  
     INT8U clearMsg();                                               /* clear all message to zero    */
     INT8U readMsg();                                                /* read message                 */
     INT8U sendMsg();                                                /* send message                 */
@@ -483,9 +486,11 @@ public:
     INT8U begin(INT8U speedset);                                    /* init can                     */
     INT8U init_Mask(INT8U num, INT8U ext, INT32U ulData);           /* init Masks                   */
     INT8U init_Filt(INT8U num, INT8U ext, INT32U ulData);           /* init filters                 */
+    INT8U init_MasksAndFilts(const INT8U *maskExt, const INT32U *masks,
+                             const INT8U *filtExt, const INT32U *filts); /* init all masks and filters */
     INT8U sendMsg(const CanMessage &message);
-    INT8U sendMsgBuf(INT32U id, INT8U ext, INT8U rtr, INT8U len, INT8U *buf);   /* send buf*/
-    INT8U sendMsgBuf(INT32U id, INT8U ext, INT8U len, INT8U *buf);   /* send buf                     */
+    INT8U sendMsgBuf(INT32U id, INT8U ext, INT8U rtr, INT8U len, const INT8U *buf);   /* send buf*/
+    INT8U sendMsgBuf(INT32U id, INT8U ext, INT8U len, const INT8U *buf);   /* send buf                     */
     INT8U readMsgBuf(INT8U *len, INT8U *buf);                       /* read buf                     */
     INT8U readMsgBufID(INT32U *ID, INT8U *len, INT8U *buf);         /* read buf with object ID      */
     CanMessage readMsg(INT8U *readStatus = nullptr);
@@ -0,0 +1,70 @@
+#include "lineassembler.h"
+
+LineAssembler::LineAssembler(char lineEnding) :
+    m_buffer{},
+    m_length{0},
+    m_lineEnding{lineEnding},
+    m_complete{false},
+    m_discarding{false}
+{
+
+}
+
+//Returns true once a line is complete, after which bytes are refused until clear()
+bool LineAssembler::append(char byte)
+{
+    if (this->m_complete) {
+        return true;
+    }
+    if (byte == this->m_lineEnding) {
+        if (this->m_discarding) {
+            this->m_discarding = false;
+            return false;
+        }
+        if (this->m_length == 0) {
+            return false;
+        }
+        this->m_buffer[this->m_length] = '\0';
+        this->m_complete = true;
+        return true;
+    }
+    if (this->m_discarding) {
+        return false;
+    }
+    if (this->m_length >= (LINE_ASSEMBLER_BUFFER_SIZE - 1)) {
+        this->m_length = 0;
+        this->m_discarding = true;
+        return false;
+    }
+    this->m_buffer[this->m_length++] = byte;
+    return false;
+}
+
+bool LineAssembler::complete() const
+{
+    return this->m_complete;
+}
+
+//Nothing of a line has arrived yet, so the next byte starts a new one
+bool LineAssembler::empty() const
+{
+    return ((this->m_length == 0) && (!this->m_discarding));
+}
+
+char *LineAssembler::line()
+{
+    return this->m_buffer;
+}
+
+uint8_t LineAssembler::length() const
+{
+    return this->m_length;
+}
+
+void LineAssembler::clear()
+{
+    this->m_length = 0;
+    this->m_complete = false;
+    this->m_discarding = false;
+    this->m_buffer[0] = '\0';
+}
@@ -0,0 +1,56 @@
+#ifndef ARDUINOPC_LINEASSEMBLER_H
+#define ARDUINOPC_LINEASSEMBLER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//Longest request line a port can take, including the terminating '\0'
+#ifndef LINE_ASSEMBLER_BUFFER_SIZE
+#    define LINE_ASSEMBLER_BUFFER_SIZE 175
+#endif
+
+#define LINE_ASSEMBLER_DEFAULT_LINE_ENDING '\n'
+
+/* Builds one request line per serial port out of whatever bytes have already arrived, so loop()
+ * never waits on a port the way Stream::readBytesUntil() does (up to the stream timeout for a
+ * line that arrives in pieces). poll() takes only the bytes that are available and stops at the
+ * first line ending; the finished line stays in line() until clear() is called. A line that
+ * does not fit the buffer is dropped along with everything up to its line ending, and empty
+ * lines are skipped */
+class LineAssembler
+{
+public:
+    explicit LineAssembler(char lineEnding = LINE_ASSEMBLER_DEFAULT_LINE_ENDING);
+
+    bool append(char byte);
+    bool complete() const;
+    bool empty() const;
+    char *line();
+    uint8_t length() const;
+    void clear();
+
+    /* Reads the bytes the stream already has until a line is complete and says whether one is.
+     * Input is Stream on the board and a fake in the tests; read() is only called after
+     * available() reports a byte, so this never blocks */
+    template <typename Input>
+    bool poll(Input *stream)
+    {
+        while ((!this->m_complete) && (stream->available() > 0)) {
+            int byteRead{stream->read()};
+            if (byteRead < 0) {
+                break;
+            }
+            this->append(static_cast<char>(byteRead));
+        }
+        return this->m_complete;
+    }
+
+private:
+    char m_buffer[LINE_ASSEMBLER_BUFFER_SIZE];
+    uint8_t m_length;
+    char m_lineEnding;
+    bool m_complete;
+    bool m_discarding;
+};
+
+#endif //ARDUINOPC_LINEASSEMBLER_H
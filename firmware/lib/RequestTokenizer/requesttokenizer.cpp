@@ -0,0 +1,76 @@
+#include "requesttokenizer.h"
+
+const char RequestTokenizer::EMPTY_FIELD[]{""};
+
+RequestTokenizer::RequestTokenizer(char *request, char separator) :
+    m_request{request},
+    m_offsets{},
+    m_fieldCount{0},
+    m_truncated{false}
+{
+    if (!request) {
+        return;
+    }
+    size_t length{strlen(request)};
+    if (length > REQUEST_TOKENIZER_MAXIMUM_LENGTH) {
+        length = REQUEST_TOKENIZER_MAXIMUM_LENGTH;
+        request[length] = '\0';
+        this->m_truncated = true;
+    }
+    while ((length > 0) && ((request[length - 1] == '\r') || (request[length - 1] == '\n'))) {
+        request[--length] = '\0';
+    }
+    this->m_offsets[this->m_fieldCount++] = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (request[i] != separator) {
+            continue;
+        }
+        if (this->m_fieldCount >= REQUEST_TOKENIZER_MAXIMUM_FIELDS) {
+            this->m_truncated = true;
+            break;
+        }
+        request[i] = '\0';
+        this->m_offsets[this->m_fieldCount++] = static_cast<uint8_t>(i + 1);
+    }
+}
+
+uint8_t RequestTokenizer::fieldCount() const
+{
+    return this->m_fieldCount;
+}
+
+uint8_t RequestTokenizer::argumentCount() const
+{
+    return ((this->m_fieldCount > 0) ? (this->m_fieldCount - 1) : 0);
+}
+
+uint8_t RequestTokenizer::offset(uint8_t index) const
+{
+    return ((index < this->m_fieldCount) ? this->m_offsets[index] : 0);
+}
+
+const char *RequestTokenizer::field(uint8_t index) const
+{
+    return ((index < this->m_fieldCount) ? (this->m_request + this->m_offsets[index]) : EMPTY_FIELD);
+}
+
+const char *RequestTokenizer::argument(uint8_t index) const
+{
+    return ((index < this->argumentCount()) ? this->field(index + 1) : EMPTY_FIELD);
+}
+
+const char *RequestTokenizer::header() const
+{
+    return this->field(0);
+}
+
+//True if anything at all follows "header:"
+bool RequestTokenizer::hasArguments() const
+{
+    return ((this->m_fieldCount > 2) || (this->argument(0)[0] != '\0'));
+}
+
+bool RequestTokenizer::truncated() const
+{
+    return this->m_truncated;
+}
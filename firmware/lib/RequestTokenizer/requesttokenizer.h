@@ -0,0 +1,43 @@
+#ifndef ARDUINOPC_REQUESTTOKENIZER_H
+#define ARDUINOPC_REQUESTTOKENIZER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Offsets are one byte, so lines are cut at REQUEST_TOKENIZER_MAXIMUM_LENGTH. A field and its
+ * separator take at least two characters, so any line that fits the firmware's receive buffer
+ * (LINE_ASSEMBLER_BUFFER_SIZE, 175) has at most 88 fields. Past that the rest of the line is left
+ * unsplit in the last field, and truncated() says so */
+#define REQUEST_TOKENIZER_MAXIMUM_LENGTH 255
+#define REQUEST_TOKENIZER_MAXIMUM_FIELDS 88
+
+/* Splits a request line into fields where it lies in the receive buffer. Every separator is
+ * overwritten with '\0' and the offset of each field is recorded, so a field is a plain C string
+ * pointing into the line: nothing is copied and nothing is allocated. Field 0 is the header and
+ * the arguments follow it. A trailing "\r" or "\n" is dropped first. Fields past the end read
+ * as "", so a handler can index a missing argument safely */
+class RequestTokenizer
+{
+public:
+    RequestTokenizer(char *request, char separator);
+
+    uint8_t fieldCount() const;
+    uint8_t argumentCount() const;
+    uint8_t offset(uint8_t index) const;
+    const char *field(uint8_t index) const;
+    const char *argument(uint8_t index) const;
+    const char *header() const;
+    bool hasArguments() const;
+    bool truncated() const;
+
+private:
+    char *m_request;
+    uint8_t m_offsets[REQUEST_TOKENIZER_MAXIMUM_FIELDS];
+    uint8_t m_fieldCount;
+    bool m_truncated;
+
+    static const char EMPTY_FIELD[];
+};
+
+#endif //ARDUINOPC_REQUESTTOKENIZER_H
@@ -0,0 +1,33 @@
+#include "responsebuilder.h"
+
+namespace ResponseFormat
+{
+    uint8_t unsignedDecimal(unsigned long value, char *out)
+    {
+        char digits[RESPONSE_FORMAT_MAXIMUM_DIGITS];
+        uint8_t count{0};
+        while (value > 0xFFFFUL) {
+            digits[count++] = static_cast<char>('0' + (value % 10));
+            value /= 10;
+        }
+        uint16_t smallValue{static_cast<uint16_t>(value)};
+        do {
+            digits[count++] = static_cast<char>('0' + (smallValue % 10));
+            smallValue /= 10;
+        } while (smallValue > 0);
+        for (uint8_t i = 0; i < count; i++) {
+            out[i] = digits[count - 1 - i];
+        }
+        return count;
+    }
+
+    uint8_t signedDecimal(long value, char *out)
+    {
+        if (value >= 0) {
+            return unsignedDecimal(static_cast<unsigned long>(value), out);
+        }
+        //Negate as unsigned so the most negative value does not overflow
+        out[0] = '-';
+        return 1 + unsignedDecimal(0UL - static_cast<unsigned long>(value), out + 1);
+    }
+}
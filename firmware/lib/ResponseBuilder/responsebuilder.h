@@ -0,0 +1,132 @@
+#ifndef ARDUINOPC_RESPONSEBUILDER_H
+#define ARDUINOPC_RESPONSEBUILDER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+//Enough for any single result line; longer replies (io reports, multi requests) go out in pieces of this size
+#ifndef RESPONSE_BUILDER_CAPACITY
+#    define RESPONSE_BUILDER_CAPACITY 64
+#endif
+
+//"-2147483648"
+#define RESPONSE_FORMAT_MAXIMUM_DIGITS 11
+
+namespace ResponseFormat
+{
+    /* Write the decimal digits of value to out (no '\0') and return how many there were. Print
+     * goes through a 32 bit division per digit; most values here are pins, states and result
+     * codes, so the digits are taken with 16 bit arithmetic once the value fits */
+    uint8_t unsignedDecimal(unsigned long value, char *out);
+    uint8_t signedDecimal(long value, char *out);
+}
+
+/* Formats a whole reply into a fixed buffer and hands it to the output with one write(), instead
+ * of one Stream::print() per field. Values print the way Print prints them: char as a character,
+ * every other integer in decimal. If the buffer fills, what is there is written and building
+ * carries on. Whatever is left is written by flush() or when the builder goes out of scope, so
+ * a handler can return early without losing its reply. Output is Stream on the board and a stub
+ * in the benchmark */
+template <typename Output>
+class ResponseBuilder
+{
+public:
+    explicit ResponseBuilder(Output *output) :
+        m_output{output},
+        m_buffer{},
+        m_length{0}
+    {
+
+    }
+
+    ~ResponseBuilder()
+    {
+        this->flush();
+    }
+
+    ResponseBuilder(const ResponseBuilder &) = delete;
+    ResponseBuilder &operator=(const ResponseBuilder &) = delete;
+
+    ResponseBuilder &operator<<(const char *str)
+    {
+        if (str) {
+            this->append(str, strlen(str));
+        }
+        return *this;
+    }
+
+    ResponseBuilder &operator<<(char c)
+    {
+        if (this->m_length >= RESPONSE_BUILDER_CAPACITY) {
+            this->flush();
+        }
+        this->m_buffer[this->m_length++] = c;
+        return *this;
+    }
+
+    ResponseBuilder &operator<<(unsigned char value) { return this->appendUnsigned(value); }
+    ResponseBuilder &operator<<(unsigned int value) { return this->appendUnsigned(value); }
+    ResponseBuilder &operator<<(unsigned long value) { return this->appendUnsigned(value); }
+    ResponseBuilder &operator<<(int value) { return this->appendSigned(value); }
+    ResponseBuilder &operator<<(long value) { return this->appendSigned(value); }
+
+    void append(const char *data, size_t length)
+    {
+        while (length > 0) {
+            if (this->m_length >= RESPONSE_BUILDER_CAPACITY) {
+                this->flush();
+            }
+            size_t room{static_cast<size_t>(RESPONSE_BUILDER_CAPACITY - this->m_length)};
+            size_t count{(length < room) ? length : room};
+            memcpy(this->m_buffer + this->m_length, data, count);
+            this->m_length += count;
+            data += count;
+            length -= count;
+        }
+    }
+
+    void flush()
+    {
+        if ((this->m_length > 0) && (this->m_output)) {
+            this->m_output->write(reinterpret_cast<const uint8_t *>(this->m_buffer), this->m_length);
+        }
+        this->m_length = 0;
+    }
+
+    const char *data() const
+    {
+        return this->m_buffer;
+    }
+
+    uint8_t length() const
+    {
+        return this->m_length;
+    }
+
+private:
+    Output *m_output;
+    char m_buffer[RESPONSE_BUILDER_CAPACITY];
+    uint8_t m_length;
+
+    //Numbers are formatted straight into the buffer, so make room for the longest one first
+    ResponseBuilder &appendUnsigned(unsigned long value)
+    {
+        if ((RESPONSE_BUILDER_CAPACITY - this->m_length) < RESPONSE_FORMAT_MAXIMUM_DIGITS) {
+            this->flush();
+        }
+        this->m_length += ResponseFormat::unsignedDecimal(value, this->m_buffer + this->m_length);
+        return *this;
+    }
+
+    ResponseBuilder &appendSigned(long value)
+    {
+        if ((RESPONSE_BUILDER_CAPACITY - this->m_length) < RESPONSE_FORMAT_MAXIMUM_DIGITS) {
+            this->flush();
+        }
+        this->m_length += ResponseFormat::signedDecimal(value, this->m_buffer + this->m_length);
+        return *this;
+    }
+};
+
+#endif //ARDUINOPC_RESPONSEBUILDER_H
@@ -2,12 +2,16 @@
 
 const int GPIO::ANALOG_MAX{1023};
 int GPIO::s_analogToDigitalThreshold{510};
+int GPIO::s_analogReportDeadband{4};
 
 GPIO::GPIO(int pinNumber, IOType ioType) :
     m_pinNumber{pinNumber},
     m_ioType{ioType},
     m_logicState{false},
-    m_analogState{0}
+    m_analogState{0},
+    m_reportedState{0},
+    m_reportedIOType{ioType},
+    m_stateReported{false}
 {
     setIOType(this->m_ioType);
 }
@@ -32,6 +36,44 @@ int GPIO::analogToDigitalThreshold()
     return GPIO::s_analogToDigitalThreshold;
 }
 
+void GPIO::setAnalogReportDeadband(int deadband)
+{
+    if (deadband < 0) {
+        deadband = 0;
+    }
+    GPIO::s_analogReportDeadband = deadband;
+}
+
+int GPIO::analogReportDeadband()
+{
+    return GPIO::s_analogReportDeadband;
+}
+
+/* True if state (or the pin type) differs from what was last reported: any change
+ * for digital pins, a move of more than the analog report deadband for analog pins */
+bool GPIO::reportedStateChanged(int state) const
+{
+    if ((!this->m_stateReported) || (this->m_reportedIOType != this->m_ioType)) {
+        return true;
+    }
+    if ((this->m_ioType == IOType::ANALOG_INPUT) || (this->m_ioType == IOType::ANALOG_OUTPUT)) {
+        return (abs(state - this->m_reportedState) > GPIO::s_analogReportDeadband);
+    }
+    return (state != this->m_reportedState);
+}
+
+void GPIO::setReportedState(int state)
+{
+    this->m_reportedState = state;
+    this->m_reportedIOType = this->m_ioType;
+    this->m_stateReported = true;
+}
+
+void GPIO::clearReportedState()
+{
+    this->m_stateReported = false;
+}
+
 void GPIO::setPinNumber(int pinNumber)
 {
     this->m_pinNumber = pinNumber;
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <vector>
+#include "binaryframe.h"
+#include "binaryframeassembler.h"
+
+/* Runs the firmware's per port binary frame assembler against a fake serial port that only
+ * holds the bytes that have "arrived" so far, the way loop() sees a slow client */
+
+static int failures{0};
+
+static void check(bool condition, const char *description)
+{
+    std::cout << (condition ? "PASS: " : "FAIL: ") << description << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+class FakeStream
+{
+public:
+    void arrive(const uint8_t *bytes, size_t length) { this->m_pending.insert(this->m_pending.end(), bytes, bytes + length); }
+    int available() const { return static_cast<int>(this->m_pending.size()); }
+    int read()
+    {
+        if (this->m_pending.empty()) {
+            this->m_blockingReads++;
+            return -1;
+        }
+        int byteRead{this->m_pending[0]};
+        this->m_pending.erase(this->m_pending.begin());
+        return byteRead;
+    }
+    int blockingReads() const { return this->m_blockingReads; }
+
+private:
+    std::vector<uint8_t> m_pending;
+    int m_blockingReads{0};
+};
+
+static size_t digitalWriteFrame(uint8_t *frame)
+{
+    uint8_t payload[2]{13, 1};
+    return BinaryFrame::encode(BinaryFrame::DIGITAL_WRITE, payload, 2, frame, BINARY_FRAME_MAXIMUM_SIZE);
+}
+
+static void partialFrameWaitsWithoutBlocking()
+{
+    FakeStream stream;
+    BinaryFrameAssembler binaryFrameAssembler;
+    uint8_t frame[BINARY_FRAME_MAXIMUM_SIZE];
+    size_t frameSize{digitalWriteFrame(frame)};
+    stream.arrive(frame, 2);
+    check(!binaryFrameAssembler.poll(&stream), "partial: half a header is not a frame");
+    check((stream.available() == 0) && (stream.blockingReads() == 0), "partial: the bytes that arrived are taken, nothing more is waited for");
+    stream.arrive(frame + 2, 2);
+    check(!binaryFrameAssembler.poll(&stream) && (binaryFrameAssembler.length() == 4), "partial: the header and part of the payload are appended");
+    stream.arrive(frame + 4, frameSize - 4);
+    check(binaryFrameAssembler.poll(&stream) && (binaryFrameAssembler.length() == frameSize), "partial: complete once the CRC arrives");
+    check(BinaryFrame::isValid(binaryFrameAssembler.frame(), binaryFrameAssembler.length()), "partial: the assembled frame passes its CRC");
+    binaryFrameAssembler.clear();
+    check(binaryFrameAssembler.empty() && !binaryFrameAssembler.complete(), "partial: empty again after clear()");
+}
+
+static void oneFramePerPoll()
+{
+    FakeStream stream;
+    BinaryFrameAssembler binaryFrameAssembler;
+    uint8_t frame[BINARY_FRAME_MAXIMUM_SIZE];
+    size_t frameSize{digitalWriteFrame(frame)};
+    stream.arrive(frame, frameSize);
+    stream.arrive(frame, frameSize);
+    check(binaryFrameAssembler.poll(&stream) && (binaryFrameAssembler.length() == frameSize), "burst: the first frame is complete");
+    check(stream.available() == static_cast<int>(frameSize), "burst: the next frame is left in the port");
+    binaryFrameAssembler.clear();
+    check(binaryFrameAssembler.poll(&stream) && (stream.available() == 0), "burst: and assembled on the next pass");
+}
+
+static void oversizedFramesAreFlagged()
+{
+    FakeStream stream;
+    BinaryFrameAssembler binaryFrameAssembler;
+    uint8_t header[BINARY_FRAME_HEADER_SIZE]{BINARY_FRAME_SYNC, BinaryFrame::DIGITAL_READ, BINARY_FRAME_MAXIMUM_PAYLOAD + 1};
+    uint8_t extra[2]{0x01, 0x02};
+    stream.arrive(header, BINARY_FRAME_HEADER_SIZE);
+    stream.arrive(extra, 2);
+    check(binaryFrameAssembler.poll(&stream) && binaryFrameAssembler.oversized(), "oversized: a header asking for too much payload completes at once");
+    check(stream.available() == 2, "oversized: nothing past the header is taken");
+    binaryFrameAssembler.clear();
+    check(!binaryFrameAssembler.oversized(), "oversized: cleared with clear()");
+}
+
+static void framesStartAtTheSyncByte()
+{
+    BinaryFrameAssembler binaryFrameAssembler;
+    check(!binaryFrameAssembler.append('v') && binaryFrameAssembler.empty(), "sync: a byte other than the sync byte does not start a frame");
+    check(!binaryFrameAssembler.append(BINARY_FRAME_SYNC) && !binaryFrameAssembler.empty(), "sync: the sync byte does");
+}
+
+int main()
+{
+    partialFrameWaitsWithoutBlocking();
+    oneFramePerPoll();
+    oversizedFramesAreFlagged();
+    framesStartAtTheSyncByte();
+    std::cout << ((failures == 0) ? "All tests passed" : "Some tests failed") << std::endl;
+    return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,122 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "canmessage.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#    define HAVE_CYCLE_COUNTER 1
+#endif
+
+/* Compares CanMessage::toString() (table driven hex) with the snprintf based version it replaced,
+ * reproduced below, on the host. Both must produce the same text for every frame; the timings
+ * show how much the format string building and parsing cost per frame */
+
+static const int ITERATIONS{200000};
+static const int FRAME_COUNT{64};
+
+static size_t legacyToFixedWidthHex(char *out, size_t bufferLength, uint32_t input, size_t fixedWidth, bool includeZeroX = true)
+{
+    char duplicateChar[4];
+    char formatMessage[10];
+    if (includeZeroX) {
+        strcpy(formatMessage, "0x%0");
+    } else {
+        strcpy(formatMessage, "%0");
+    }
+    snprintf(duplicateChar, 4, "%li", static_cast<long>(fixedWidth));
+    strcat(formatMessage, duplicateChar);
+    strcat(formatMessage, "x");
+    snprintf(out, bufferLength, formatMessage, input);
+    return strlen(out);
+}
+
+static int legacyToString(const CanMessage &message, char *out, size_t maximumLength)
+{
+    if (maximumLength == 0) {
+        return -1;
+    }
+    out[0] = '\0';
+    char tempHexString[SMALL_BUFFER_SIZE];
+    legacyToFixedWidthHex(tempHexString, SMALL_BUFFER_SIZE, message.id(), 3, true);
+    //Appends with snprintf rather than strncat, so every write is bounded by the space left in out
+    size_t length{0};
+    length += snprintf(out + length, maximumLength - length, "%s : ", tempHexString);
+    for (int i = 0; (i < message.length()) && (length < maximumLength); i++) {
+        memset(tempHexString, '\0', SMALL_BUFFER_SIZE);
+        legacyToFixedWidthHex(tempHexString, SMALL_BUFFER_SIZE, message.nthByte(i), 2, true);
+        length += snprintf(out + length, maximumLength - length, "%s%s", tempHexString, (i != (message.length() - 1)) ? " : " : "");
+    }
+    return strlen(out);
+}
+
+static unsigned long long cycleCount()
+{
+#if defined(HAVE_CYCLE_COUNTER)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+template <typename Formatter>
+static void runBenchmark(const char *title, CanMessage *frames, Formatter formatter)
+{
+    volatile unsigned int sink{0};
+    char out[SMALL_BUFFER_SIZE];
+    auto startTime = std::chrono::steady_clock::now();
+    unsigned long long startCycles{cycleCount()};
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink = sink + formatter(frames[i % FRAME_COUNT], out, SMALL_BUFFER_SIZE);
+    }
+    unsigned long long endCycles{cycleCount()};
+    auto endTime = std::chrono::steady_clock::now();
+    double nanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+
+    std::cout << title << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << nanoseconds << "ns/frame";
+#if defined(HAVE_CYCLE_COUNTER)
+    std::cout << ", " << static_cast<double>(endCycles - startCycles) / ITERATIONS << " cycles/frame";
+#else
+    (void)startCycles;
+    (void)endCycles;
+#endif
+    std::cout << std::endl << std::endl;
+}
+
+int main()
+{
+    CanMessage frames[FRAME_COUNT];
+    srand(1);
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        uint8_t data[8];
+        for (int j = 0; j < 8; j++) {
+            data[j] = static_cast<uint8_t>(rand());
+        }
+        uint32_t id{(i % 4 == 0) ? (static_cast<uint32_t>(rand()) & 0x1FFFFFFF) : (static_cast<uint32_t>(rand()) & 0x7FF)};
+        frames[i] = CanMessage{id, CanMessage::DEFAULT_FRAME_TYPE, static_cast<uint8_t>(1 + (i % 8)), data};
+    }
+
+    int mismatches{0};
+    for (int i = 0; i < FRAME_COUNT; i++) {
+        char legacy[SMALL_BUFFER_SIZE];
+        char tableDriven[SMALL_BUFFER_SIZE];
+        int legacyLength{legacyToString(frames[i], legacy, SMALL_BUFFER_SIZE)};
+        int tableDrivenLength{frames[i].toString(tableDriven, SMALL_BUFFER_SIZE)};
+        if ((legacyLength != tableDrivenLength) || (strcmp(legacy, tableDriven) != 0)) {
+            std::cout << "MISMATCH: \"" << legacy << "\" != \"" << tableDriven << "\"" << std::endl;
+            mismatches++;
+        }
+    }
+    char sample[SMALL_BUFFER_SIZE];
+    frames[1].toString(sample, SMALL_BUFFER_SIZE);
+    std::cout << "CanMessage::toString() (e.g. \"" << sample << "\"), " << (FRAME_COUNT - mismatches) << "/" << FRAME_COUNT << " frames identical to the snprintf version" << std::endl << std::endl;
+
+    runBenchmark("snprintf format string per field", frames, legacyToString);
+    runBenchmark("table driven hex", frames, [](const CanMessage &message, char *out, size_t maximumLength) { return message.toString(out, maximumLength); });
+    return ((mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,154 @@
+#include <iostream>
+#include <cstdlib>
+#include "canreceivering.h"
+#include "mcp2515model.h"
+
+/* Runs the firmware's CAN receive ring against a simulated MCP2515. Each case feeds frames in
+ * from the bus side while loop() is "busy" (not reading), then checks what reached loop() */
+
+static Mcp2515Model *controller{nullptr};
+static CanReceiveRing *canReceiveRing{nullptr};
+static int failures{0};
+
+static void canReceiveInterrupt()
+{
+    canReceiveRing->drain(controller);
+}
+
+static void check(bool condition, const char *description)
+{
+    std::cout << (condition ? "PASS: " : "FAIL: ") << description << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+static void receiveFrame(uint32_t id)
+{
+    uint8_t data[8]{static_cast<uint8_t>(id), static_cast<uint8_t>(id >> 8), 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF};
+    controller->receive(id, ((id > 0x7FF) ? 1 : 0), 8, data);
+}
+
+static bool popMatches(uint32_t id)
+{
+    CanReceiveRecord record;
+    if (!canReceiveRing->pop(&record)) {
+        return false;
+    }
+    return ((record.id == id) && (record.frameType == ((id > 0x7FF) ? 1 : 0)) && (record.length == 8) &&
+            (record.data[0] == static_cast<uint8_t>(id)) && (record.data[1] == static_cast<uint8_t>(id >> 8)) && (record.data[7] == 0xFF));
+}
+
+static void reset(bool interruptDriven)
+{
+    delete controller;
+    delete canReceiveRing;
+    controller = new Mcp2515Model{};
+    canReceiveRing = new CanReceiveRing{};
+    if (interruptDriven) {
+        controller->attachInterrupt(canReceiveInterrupt);
+    }
+}
+
+static void pollingLosesFramesWhileBusy()
+{
+    reset(false);
+    for (uint32_t id = 0x100; id < 0x10C; id++) {
+        receiveFrame(id);
+    }
+    check(controller->dropped() == 10, "polling: 12 frames during a busy loop() overflow the 2 controller buffers, 10 lost");
+}
+
+static void interruptKeepsFramesWhileBusy()
+{
+    reset(true);
+    for (uint32_t id = 0x100; id < 0x10C; id++) {
+        receiveFrame(id);
+    }
+    check(controller->dropped() == 0, "interrupt: no frames lost in the controller during a busy loop()");
+    check(canReceiveRing->size() == 12, "interrupt: all 12 frames are waiting in the ring");
+    bool inOrder{true};
+    for (uint32_t id = 0x100; id < 0x10C; id++) {
+        inOrder = inOrder && popMatches(id);
+    }
+    check(inOrder, "interrupt: frames come out of the ring in arrival order with their data");
+    check(canReceiveRing->empty(), "interrupt: ring is empty once loop() has forwarded everything");
+    check(canReceiveRing->takeOverflowCount() == 0, "interrupt: no ring overflows");
+}
+
+static void ringOverflowIsCounted()
+{
+    reset(true);
+    const uint32_t frameCount{CAN_RECEIVE_RING_SIZE + 24};
+    for (uint32_t id = 0x200; id < (0x200 + frameCount); id++) {
+        receiveFrame(id);
+    }
+    check(controller->dropped() == 0, "overflow: the controller itself still drops nothing");
+    check(canReceiveRing->size() == CAN_RECEIVE_RING_SIZE, "overflow: ring holds CAN_RECEIVE_RING_SIZE frames");
+    check(canReceiveRing->overflowCount() == 24, "overflow: the 24 frames that did not fit are counted");
+    check(popMatches(0x200), "overflow: the oldest frames are kept, the newest dropped");
+    check(canReceiveRing->takeOverflowCount() == 24, "overflow: takeOverflowCount() returns the count");
+    check(canReceiveRing->takeOverflowCount() == 0, "overflow: and then starts again from zero");
+}
+
+static void wrapsAroundManyTimes()
+{
+    reset(true);
+    uint32_t nextID{0x10};
+    uint32_t expectedID{0x10};
+    bool inOrder{true};
+    srand(1);
+    for (int i = 0; i < 10000; i++) {
+        int arrivals{rand() % 5};
+        for (int j = 0; (j < arrivals) && (canReceiveRing->size() < CAN_RECEIVE_RING_SIZE); j++) {
+            receiveFrame(nextID);
+            nextID = ((nextID == 0x1FFFFFFF) ? 0x10 : (nextID * 3 + 1) & 0x1FFFFFFF);
+        }
+        int reads{rand() % 5};
+        for (int j = 0; (j < reads) && (!canReceiveRing->empty()); j++) {
+            inOrder = inOrder && popMatches(expectedID);
+            expectedID = ((expectedID == 0x1FFFFFFF) ? 0x10 : (expectedID * 3 + 1) & 0x1FFFFFFF);
+        }
+    }
+    check(inOrder, "wrap: order, frame type and data survive many trips around the ring");
+    check(canReceiveRing->takeOverflowCount() == 0, "wrap: no overflows when loop() keeps up");
+}
+
+static void missedEdgeIsRecovered()
+{
+    reset(true);
+    controller->setInterruptsEnabled(false);
+    receiveFrame(0x300);
+    receiveFrame(0x301);
+    controller->setInterruptsEnabled(true);
+    receiveFrame(0x302);
+    check(canReceiveRing->empty() && (controller->dropped() == 1), "missed edge: INT already low, so no falling edge and no interrupt");
+    if (controller->interruptAsserted()) {
+        canReceiveRing->drain(controller);
+    }
+    check(popMatches(0x300) && popMatches(0x301), "missed edge: loop() drains the controller when it sees INT held low");
+    receiveFrame(0x303);
+    check(popMatches(0x303), "missed edge: interrupts fire again once the buffers are empty");
+}
+
+static void drainCostsOneStatusReadPerFrame()
+{
+    reset(false);
+    receiveFrame(0x400);
+    receiveFrame(0x401);
+    unsigned long before{controller->spiTransactions()};
+    uint8_t drained{canReceiveRing->drain(controller)};
+    check((drained == 2) && ((controller->spiTransactions() - before) == 7), "drain: 2 frames cost 7 SPI transactions (no checkReceive() per frame)");
+}
+
+int main()
+{
+    pollingLosesFramesWhileBusy();
+    interruptKeepsFramesWhileBusy();
+    ringOverflowIsCounted();
+    wrapsAroundManyTimes();
+    missedEdgeIsRecovered();
+    drainCostsOneStatusReadPerFrame();
+    std::cout << ((failures == 0) ? "All tests passed" : "Some tests failed") << std::endl;
+    return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,127 @@
+#ifndef ARDUINOPC_MCP2515MODEL_H
+#define ARDUINOPC_MCP2515MODEL_H
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef CAN_OK
+#    define CAN_OK (0)
+#endif
+#define CAN_MSGAVAIL (3)
+#define CAN_NOMSG (4)
+#define MCP2515_MODEL_RECEIVE_BUFFERS 2
+
+/* Stands in for MCP_CAN on the host. It models the parts of the MCP2515 the receive path depends
+ * on: two receive buffers filled RXB0 first with rollover into RXB1, frames lost (and counted, as
+ * the RX1OVR flag would) when both are full, an active low INT line that stays asserted while any
+ * buffer holds a frame, and the SPI transactions each call would cost on the board. A frame that
+ * pulls INT low runs the attached handler straight away, the way the ISR would preempt loop() */
+class Mcp2515Model
+{
+public:
+    typedef void (*InterruptHandler)();
+
+    Mcp2515Model() :
+        m_buffers{},
+        m_full{false, false},
+        m_lastExtended{0},
+        m_interruptHandler{nullptr},
+        m_interruptsEnabled{true},
+        m_dropped{0},
+        m_spiTransactions{0}
+    {
+
+    }
+
+    void attachInterrupt(InterruptHandler interruptHandler)
+    {
+        this->m_interruptHandler = interruptHandler;
+    }
+
+    void setInterruptsEnabled(bool interruptsEnabled)
+    {
+        this->m_interruptsEnabled = interruptsEnabled;
+    }
+
+    //A frame arriving off the bus
+    void receive(uint32_t id, uint8_t extended, uint8_t length, const uint8_t *data)
+    {
+        bool wasAsserted{this->interruptAsserted()};
+        int buffer{(!this->m_full[0]) ? 0 : ((!this->m_full[1]) ? 1 : -1)};
+        if (buffer == -1) {
+            this->m_dropped++;
+            return;
+        }
+        this->m_buffers[buffer].id = id;
+        this->m_buffers[buffer].extended = extended;
+        this->m_buffers[buffer].length = length;
+        memcpy(this->m_buffers[buffer].data, data, length);
+        this->m_full[buffer] = true;
+        if ((!wasAsserted) && (this->m_interruptsEnabled) && (this->m_interruptHandler)) {
+            this->m_interruptHandler();
+        }
+    }
+
+    bool interruptAsserted() const
+    {
+        return (this->m_full[0] || this->m_full[1]);
+    }
+
+    //Same contract as MCP_CAN::readMsgBufID(): one status read, then the buffer read and flag clear
+    uint8_t readMsgBufID(uint32_t *id, uint8_t *length, uint8_t *data)
+    {
+        this->m_spiTransactions++;
+        int buffer{this->m_full[0] ? 0 : (this->m_full[1] ? 1 : -1)};
+        if (buffer == -1) {
+            *length = 0;
+            return CAN_NOMSG;
+        }
+        this->m_spiTransactions += 2;
+        *id = this->m_buffers[buffer].id;
+        *length = this->m_buffers[buffer].length;
+        memcpy(data, this->m_buffers[buffer].data, this->m_buffers[buffer].length);
+        this->m_lastExtended = this->m_buffers[buffer].extended;
+        this->m_full[buffer] = false;
+        return CAN_OK;
+    }
+
+    uint8_t checkReceive()
+    {
+        this->m_spiTransactions++;
+        return (this->interruptAsserted() ? CAN_MSGAVAIL : CAN_NOMSG);
+    }
+
+    uint8_t isExtendedFrame() const
+    {
+        return this->m_lastExtended;
+    }
+
+    unsigned long dropped() const
+    {
+        return this->m_dropped;
+    }
+
+    unsigned long spiTransactions() const
+    {
+        return this->m_spiTransactions;
+    }
+
+private:
+    struct ReceiveBuffer
+    {
+        uint32_t id;
+        uint8_t extended;
+        uint8_t length;
+        uint8_t data[8];
+    };
+
+    ReceiveBuffer m_buffers[MCP2515_MODEL_RECEIVE_BUFFERS];
+    bool m_full[MCP2515_MODEL_RECEIVE_BUFFERS];
+    uint8_t m_lastExtended;
+    InterruptHandler m_interruptHandler;
+    bool m_interruptsEnabled;
+    unsigned long m_dropped;
+    unsigned long m_spiTransactions;
+};
+
+#endif //ARDUINOPC_MCP2515MODEL_H
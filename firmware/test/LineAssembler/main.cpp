@@ -0,0 +1,128 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "lineassembler.h"
+
+/* Runs the firmware's per port line assembler against fake serial ports that only hold the
+ * bytes that have "arrived" so far, the way loop() sees a slow client */
+
+static int failures{0};
+
+static void check(bool condition, const char *description)
+{
+    std::cout << (condition ? "PASS: " : "FAIL: ") << description << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+class FakeStream
+{
+public:
+    void arrive(const char *bytes) { this->m_pending += bytes; }
+    int available() const { return static_cast<int>(this->m_pending.size()); }
+    int read()
+    {
+        if (this->m_pending.empty()) {
+            this->m_blockingReads++;
+            return -1;
+        }
+        int byteRead{static_cast<unsigned char>(this->m_pending[0])};
+        this->m_pending.erase(0, 1);
+        return byteRead;
+    }
+    int blockingReads() const { return this->m_blockingReads; }
+
+private:
+    std::string m_pending;
+    int m_blockingReads{0};
+};
+
+//What loop() does for one port on one pass, with the dispatched line appended to dispatched
+static bool servicePort(FakeStream *stream, LineAssembler *lineAssembler, std::string *dispatched)
+{
+    if (!lineAssembler->poll(stream)) {
+        return false;
+    }
+    *dispatched = lineAssembler->line();
+    lineAssembler->clear();
+    return true;
+}
+
+static void partialLineWaitsWithoutBlocking()
+{
+    FakeStream stream;
+    LineAssembler lineAssembler;
+    std::string dispatched;
+    stream.arrive("dwri");
+    check(!servicePort(&stream, &lineAssembler, &dispatched), "partial: half a line is not dispatched");
+    check((stream.available() == 0) && (stream.blockingReads() == 0), "partial: the bytes that arrived are taken, nothing more is waited for");
+    stream.arrive("te:13:1");
+    check(!servicePort(&stream, &lineAssembler, &dispatched) && (lineAssembler.length() == 11), "partial: later pieces are appended");
+    stream.arrive("\n");
+    check(servicePort(&stream, &lineAssembler, &dispatched) && (dispatched == "dwrite:13:1"), "partial: dispatched once the line ending arrives");
+    check(lineAssembler.empty(), "partial: empty again after clear()");
+}
+
+static void slowPortDoesNotStallOthers()
+{
+    FakeStream usb;
+    FakeStream bluetooth;
+    LineAssembler usbLineAssembler;
+    LineAssembler bluetoothLineAssembler;
+    std::string usbLine;
+    std::string bluetoothLine;
+    int usbDispatched{0};
+    bluetooth.arrive("aread:");
+    for (int pass = 0; pass < 10; pass++) {
+        usb.arrive("dread:2\n");
+        servicePort(&bluetooth, &bluetoothLineAssembler, &bluetoothLine);
+        if (servicePort(&usb, &usbLineAssembler, &usbLine)) {
+            usbDispatched++;
+        }
+    }
+    check((usbDispatched == 10) && (usbLine == "dread:2"), "stall: the USB port gets a line through on every pass while Bluetooth is mid line");
+    bluetooth.arrive("A0\r\n");
+    check(servicePort(&bluetooth, &bluetoothLineAssembler, &bluetoothLine) && (bluetoothLine == "aread:A0\r"), "stall: the Bluetooth line completes later, \\r left for the tokenizer");
+    check((usb.blockingReads() == 0) && (bluetooth.blockingReads() == 0), "stall: no port was ever read with nothing available");
+}
+
+static void oneLinePerPoll()
+{
+    FakeStream stream;
+    LineAssembler lineAssembler;
+    std::string dispatched;
+    stream.arrive("\n\nver\nheartbeat\n");
+    check(servicePort(&stream, &lineAssembler, &dispatched) && (dispatched == "ver"), "burst: empty lines are skipped, the first line is dispatched");
+    check(stream.available() == 10, "burst: the next line is left in the port");
+    check(servicePort(&stream, &lineAssembler, &dispatched) && (dispatched == "heartbeat"), "burst: and dispatched on the next pass");
+    stream.arrive("x");
+    lineAssembler.poll(&stream);
+    check(!lineAssembler.empty() && !lineAssembler.complete(), "burst: a started line is not empty, so it cannot be taken for a binary frame");
+}
+
+static void longLinesAreDropped()
+{
+    FakeStream stream;
+    LineAssembler lineAssembler;
+    std::string dispatched;
+    std::string tooLong(LINE_ASSEMBLER_BUFFER_SIZE + 20, 'a');
+    stream.arrive(tooLong.c_str());
+    check(!servicePort(&stream, &lineAssembler, &dispatched) && !lineAssembler.empty(), "overflow: an overlong line is being discarded");
+    stream.arrive("aaaa\nver\n");
+    check(servicePort(&stream, &lineAssembler, &dispatched) && (dispatched == "ver"), "overflow: nothing of it is dispatched, the next line is");
+    std::string longest(LINE_ASSEMBLER_BUFFER_SIZE - 1, 'b');
+    stream.arrive((longest + "\n").c_str());
+    check(servicePort(&stream, &lineAssembler, &dispatched) && (dispatched == longest), "overflow: a line of LINE_ASSEMBLER_BUFFER_SIZE - 1 characters still fits");
+}
+
+int main()
+{
+    partialLineWaitsWithoutBlocking();
+    slowPortDoesNotStallOthers();
+    oneLinePerPoll();
+    longLinesAreDropped();
+    std::cout << ((failures == 0) ? "All tests passed" : "Some tests failed") << std::endl;
+    return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,8 @@
+#ifndef PINCAPABILITIES_TEST_PGMSPACE_H
+#define PINCAPABILITIES_TEST_PGMSPACE_H
+
+//Flash and RAM are one address space on the host
+#define PROGMEM
+#define pgm_read_byte_near(address) (*(address))
+
+#endif //PINCAPABILITIES_TEST_PGMSPACE_H
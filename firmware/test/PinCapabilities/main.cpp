@@ -0,0 +1,113 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include "pincapabilities.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#    define HAVE_CYCLE_COUNTER 1
+#endif
+
+/* Checks the compile time pin masks against the -1 terminated pin lists the firmware used to
+ * walk on every request, for each board's lists, and times one check both ways on the host */
+
+using namespace PinCapabilities;
+
+static const int ITERATIONS{2000000};
+
+#define MEGA_ANALOG_PIN_LIST 54, 55, 56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69
+#define MEGA_PWM_PIN_LIST 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 44, 45, 46
+#define MEGA_GENERAL_PIN_LIST 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, \
+                              38, 39, 40, 41, 42, 43, 47, 48, 49, 50, 51, 52, 53
+#define NANO_ANALOG_PIN_LIST 14, 15, 16, 17, 18, 19, 20, 21
+#define NANO_PWM_PIN_LIST 3, 5, 6, 9, 10, 11
+
+static const PROGMEM int8_t MEGA_ANALOG_PINS[]{MEGA_ANALOG_PIN_LIST, -1};
+static const PROGMEM int8_t MEGA_PWM_PINS[]{MEGA_PWM_PIN_LIST, -1};
+static const PROGMEM int8_t MEGA_GENERAL_PINS[]{MEGA_GENERAL_PIN_LIST, -1};
+static const PROGMEM int8_t NANO_ANALOG_PINS[]{NANO_ANALOG_PIN_LIST, -1};
+static const PROGMEM int8_t NANO_PWM_PINS[]{NANO_PWM_PIN_LIST, -1};
+static const PROGMEM uint8_t MEGA_ANALOG_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(MEGA_ANALOG_PIN_LIST);
+static const PROGMEM uint8_t MEGA_PWM_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(MEGA_PWM_PIN_LIST);
+static const PROGMEM uint8_t MEGA_GENERAL_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(MEGA_GENERAL_PIN_LIST);
+static const PROGMEM uint8_t NANO_ANALOG_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(NANO_ANALOG_PIN_LIST);
+static const PROGMEM uint8_t NANO_PWM_PIN_MASK[PIN_MASK_SIZE] PIN_MASK(NANO_PWM_PIN_LIST);
+
+//The firmware's old isValidAnalogInputPin() and friends
+static bool legacyPinListContains(const int8_t *pins, int pinNumber)
+{
+    uint8_t i{0};
+    do {
+        int8_t tempPinNumber{static_cast<int8_t>(pgm_read_byte_near(pins + i++))};
+        if (tempPinNumber < 0) {
+            return false;
+        }
+        if (tempPinNumber == pinNumber) {
+            return true;
+        }
+    } while (true);
+}
+
+static unsigned long long cycleCount()
+{
+#if defined(HAVE_CYCLE_COUNTER)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int checkSame(const char *title, const int8_t *pins, const uint8_t *mask)
+{
+    int mismatches{0};
+    for (int pinNumber = -8; pinNumber < PIN_MASK_PINS + 8; pinNumber++) {
+        if (legacyPinListContains(pins, pinNumber) != pinMaskTest(mask, pinNumber)) {
+            std::cout << "MISMATCH: " << title << " pin " << pinNumber << std::endl;
+            mismatches++;
+        }
+    }
+    std::cout << title << ": " << ((mismatches == 0) ? "mask matches the list for every pin" : "FAILED") << std::endl;
+    return mismatches;
+}
+
+template <typename Check>
+static void runBenchmark(const char *title, Check check)
+{
+    volatile unsigned int sink{0};
+    auto startTime = std::chrono::steady_clock::now();
+    unsigned long long startCycles{cycleCount()};
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink = sink + (check(i % 72) ? 1 : 0);
+    }
+    unsigned long long endCycles{cycleCount()};
+    auto endTime = std::chrono::steady_clock::now();
+    double nanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+
+    std::cout << title << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << nanoseconds << "ns/check";
+#if defined(HAVE_CYCLE_COUNTER)
+    std::cout << ", " << static_cast<double>(endCycles - startCycles) / ITERATIONS << " cycles/check";
+#else
+    (void)startCycles;
+    (void)endCycles;
+#endif
+    std::cout << std::endl << std::endl;
+}
+
+int main()
+{
+    int mismatches{0};
+    mismatches += checkSame("Mega analog", MEGA_ANALOG_PINS, MEGA_ANALOG_PIN_MASK);
+    mismatches += checkSame("Mega PWM", MEGA_PWM_PINS, MEGA_PWM_PIN_MASK);
+    mismatches += checkSame("Mega general", MEGA_GENERAL_PINS, MEGA_GENERAL_PIN_MASK);
+    mismatches += checkSame("Nano analog", NANO_ANALOG_PINS, NANO_ANALOG_PIN_MASK);
+    mismatches += checkSame("Nano PWM", NANO_PWM_PINS, NANO_PWM_PIN_MASK);
+    std::cout << std::endl;
+
+    runBenchmark("Mega general pins, list walk", [](int pinNumber) { return legacyPinListContains(MEGA_GENERAL_PINS, pinNumber); });
+    runBenchmark("Mega general pins, mask bit", [](int pinNumber) { return pinMaskTest(MEGA_GENERAL_PIN_MASK, pinNumber); });
+    return ((mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,163 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "requestdispatch.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#    define HAVE_CYCLE_COUNTER 1
+#endif
+
+/* Compares RequestDispatch::requestType() with the startsWith chain handleSerialString() used
+ * before it, reproduced below in the same order, on the host. Every request must resolve to the
+ * same handler both ways; the timings are cycles per dispatch averaged over one request of each
+ * kind, so the chain pays for how deep in the list each header sits */
+
+using namespace ArduinoPCStrings;
+using namespace RequestDispatch;
+
+static const int ITERATIONS{20000};
+
+struct LegacyEntry
+{
+    const char *header;
+    RequestType requestType;
+};
+
+static const LegacyEntry LEGACY_CHAIN[]{
+    {ANALOG_READ_MULTI_HEADER, ANALOG_READ_MULTI_REQUEST},
+    {ANALOG_READ_HEADER, ANALOG_READ_REQUEST},
+    {CHANGE_A_TO_D_THRESHOLD_HEADER, CHANGE_A_TO_D_THRESHOLD_REQUEST},
+    {ANALOG_WRITE_HEADER, ANALOG_WRITE_REQUEST},
+    {DIGITAL_READ_MULTI_HEADER, DIGITAL_READ_MULTI_REQUEST},
+    {DIGITAL_READ_HEADER, DIGITAL_READ_REQUEST},
+    {DIGITAL_WRITE_MULTI_HEADER, DIGITAL_WRITE_MULTI_REQUEST},
+    {DIGITAL_WRITE_ALL_HEADER, DIGITAL_WRITE_ALL_REQUEST},
+    {DIGITAL_WRITE_HEADER, DIGITAL_WRITE_REQUEST},
+    {PIN_TYPE_HEADER, PIN_TYPE_REQUEST},
+    {PIN_TYPE_CHANGE_HEADER, PIN_TYPE_CHANGE_REQUEST},
+    {SOFT_DIGITAL_READ_HEADER, SOFT_DIGITAL_READ_REQUEST},
+    {SOFT_ANALOG_READ_HEADER, SOFT_ANALOG_READ_REQUEST},
+    {BINARY_MODE_HEADER, BINARY_MODE_REQUEST},
+    {FIRMWARE_VERSION_HEADER, FIRMWARE_VERSION_REQUEST},
+    {IO_REPORT_DELTA_HEADER, IO_REPORT_DELTA_REQUEST},
+    {IO_DEADBAND_HEADER, IO_DEADBAND_REQUEST},
+    {IO_STREAM_HEADER, IO_STREAM_REQUEST},
+    {IO_REPORT_HEADER, IO_REPORT_REQUEST},
+    {CURRENT_A_TO_D_THRESHOLD_HEADER, CURRENT_A_TO_D_THRESHOLD_REQUEST},
+    {ARDUINO_TYPE_HEADER, ARDUINO_TYPE_REQUEST},
+    {CAN_BUS_ENABLED_HEADER, CAN_BUS_ENABLED_REQUEST},
+    {LIN_BUS_ENABLED_HEADER, LIN_BUS_ENABLED_REQUEST},
+    {CAN_INIT_HEADER, CAN_INIT_REQUEST},
+    {CAN_READ_HEADER, CAN_READ_REQUEST},
+    {CAN_WRITE_ONCE_HEADER, CAN_WRITE_ONCE_REQUEST},
+    {CAN_LIVE_UPDATE_HEADER, CAN_LIVE_UPDATE_REQUEST},
+    {CLEAR_CAN_MESSAGE_BY_ID_HEADER, CLEAR_CAN_MESSAGE_BY_ID_REQUEST},
+    {CURRENT_CAN_MESSAGE_BY_ID_HEADER, CURRENT_CAN_MESSAGE_BY_ID_REQUEST},
+    {REMOVE_NEGATIVE_CAN_MASK_HEADER, REMOVE_NEGATIVE_CAN_MASK_REQUEST},
+    {REMOVE_POSITIVE_CAN_MASK_HEADER, REMOVE_POSITIVE_CAN_MASK_REQUEST},
+    {ADD_POSITIVE_CAN_MASK_HEADER, ADD_POSITIVE_CAN_MASK_REQUEST},
+    {ADD_NEGATIVE_CAN_MASK_HEADER, ADD_NEGATIVE_CAN_MASK_REQUEST},
+    {SET_POSITIVE_CAN_MASKS_HEADER, SET_POSITIVE_CAN_MASKS_REQUEST},
+    {SET_NEGATIVE_CAN_MASKS_HEADER, SET_NEGATIVE_CAN_MASKS_REQUEST},
+    {CURRENT_CAN_MESSAGES_HEADER, CURRENT_CAN_MESSAGES_REQUEST},
+    {CLEAR_CAN_MESSAGES_HEADER, CLEAR_CAN_MESSAGES_REQUEST},
+    {ALL_CURRENT_CAN_MASKS_HEADER, ALL_CURRENT_CAN_MASKS_REQUEST},
+    {CURRENT_POSITIVE_CAN_MASKS_HEADER, CURRENT_POSITIVE_CAN_MASKS_REQUEST},
+    {CURRENT_NEGATIVE_CAN_MASKS_HEADER, CURRENT_NEGATIVE_CAN_MASKS_REQUEST},
+    {CLEAR_POSITIVE_CAN_MASKS_HEADER, CLEAR_POSITIVE_CAN_MASKS_REQUEST},
+    {CLEAR_NEGATIVE_CAN_MASKS_HEADER, CLEAR_NEGATIVE_CAN_MASKS_REQUEST},
+    {CLEAR_ALL_CAN_MASKS_HEADER, CLEAR_ALL_CAN_MASKS_REQUEST},
+    {CAN_RECEIVE_OVERFLOWS_HEADER, CAN_RECEIVE_OVERFLOWS_REQUEST},
+    {CAN_BATCH_SIZE_HEADER, CAN_BATCH_SIZE_REQUEST},
+    {ADD_SOFTWARE_SERIAL_HEADER, ADD_SOFTWARE_SERIAL_REQUEST},
+    {REMOVE_SOFTWARE_SERIAL_HEADER, REMOVE_SOFTWARE_SERIAL_REQUEST}
+};
+
+static const int REQUEST_COUNT{sizeof(LEGACY_CHAIN) / sizeof(LEGACY_CHAIN[0])};
+
+static bool startsWith(const char *str, const char *compare)
+{
+    return (strncmp(str, compare, strlen(compare)) == 0);
+}
+
+static RequestType legacyRequestType(const char *str)
+{
+    for (int i = 0; i < REQUEST_COUNT; i++) {
+        if (startsWith(str, LEGACY_CHAIN[i].header)) {
+            return LEGACY_CHAIN[i].requestType;
+        }
+    }
+    return UNKNOWN_REQUEST;
+}
+
+static unsigned long long cycleCount()
+{
+#if defined(HAVE_CYCLE_COUNTER)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+template <typename Dispatcher>
+static void runBenchmark(const char *title, char requests[][32], Dispatcher dispatcher)
+{
+    volatile unsigned int sink{0};
+    auto startTime = std::chrono::steady_clock::now();
+    unsigned long long startCycles{cycleCount()};
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (int j = 0; j < REQUEST_COUNT; j++) {
+            sink = sink + dispatcher(requests[j]);
+        }
+    }
+    unsigned long long endCycles{cycleCount()};
+    auto endTime = std::chrono::steady_clock::now();
+    const double dispatches{static_cast<double>(ITERATIONS) * REQUEST_COUNT};
+    double nanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / dispatches};
+
+    std::cout << title << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << nanoseconds << "ns/dispatch";
+#if defined(HAVE_CYCLE_COUNTER)
+    std::cout << ", " << static_cast<double>(endCycles - startCycles) / dispatches << " cycles/dispatch";
+#else
+    (void)startCycles;
+    (void)endCycles;
+#endif
+    std::cout << std::endl << std::endl;
+}
+
+int main()
+{
+    char requests[REQUEST_COUNT][32];
+    int mismatches{0};
+    for (int i = 0; i < REQUEST_COUNT; i++) {
+        snprintf(requests[i], sizeof(requests[i]), "%s:13:1\r", LEGACY_CHAIN[i].header);
+        RequestType legacy{legacyRequestType(requests[i])};
+        RequestType hashed{requestType(requests[i])};
+        if ((legacy != hashed) || (hashed != LEGACY_CHAIN[i].requestType) || (requestType(LEGACY_CHAIN[i].header) != hashed)) {
+            std::cout << "MISMATCH: \"" << LEGACY_CHAIN[i].header << "\" " << static_cast<int>(legacy) << " != " << static_cast<int>(hashed) << std::endl;
+            mismatches++;
+        }
+    }
+    if (REQUEST_COUNT != (REQUEST_TYPE_COUNT - 1)) {
+        std::cout << "MISMATCH: " << REQUEST_COUNT << " requests in the chain, " << (REQUEST_TYPE_COUNT - 1) << " request types" << std::endl;
+        mismatches++;
+    }
+    const char *unknownRequests[]{"", "bogus", "dreadx:4", "aread2", "caninitialize", "ioreportend", "canwrite:1:2"};
+    for (const char *unknownRequest : unknownRequests) {
+        if (requestType(unknownRequest) != UNKNOWN_REQUEST) {
+            std::cout << "MISMATCH: \"" << unknownRequest << "\" should be unknown" << std::endl;
+            mismatches++;
+        }
+    }
+    std::cout << (REQUEST_COUNT - mismatches) << "/" << REQUEST_COUNT << " requests resolve to the same handler as the startsWith chain" << std::endl << std::endl;
+
+    runBenchmark("startsWith chain", requests, legacyRequestType);
+    runBenchmark("hashed header switch", requests, [](const char *str) { return requestType(str); });
+    return ((mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "requesttokenizer.h"
+#include "canmessage.h"
+
+/* Runs the firmware's in place request tokenizer, and CanMessage::parse() that canwrite requests
+ * used to go through, on the host */
+
+static int failures{0};
+
+static void check(bool condition, const char *description)
+{
+    std::cout << (condition ? "PASS: " : "FAIL: ") << description << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+static void fieldsPointIntoTheLine()
+{
+    char line[]{"dwrite:13:1\r"};
+    RequestTokenizer request{line, ':'};
+    check(request.fieldCount() == 3, "fields: header and two arguments");
+    check((strcmp(request.header(), "dwrite") == 0) && (strcmp(request.argument(0), "13") == 0) && (strcmp(request.argument(1), "1") == 0), "fields: header and arguments read back, trailing \\r dropped");
+    check((request.argument(0) == line + 7) && (request.offset(2) == 10), "fields: no copy, each field is a pointer into the receive buffer");
+    check((line[6] == '\0') && (line[9] == '\0'), "fields: separators are replaced with '\\0' in place");
+    check(!request.truncated(), "fields: not truncated");
+}
+
+static void missingArgumentsReadEmpty()
+{
+    char line[]{"aread"};
+    RequestTokenizer request{line, ':'};
+    check((request.argumentCount() == 0) && (!request.hasArguments()), "missing: a bare header has no arguments");
+    check((request.argument(0)[0] == '\0') && (request.field(5)[0] == '\0'), "missing: fields past the end read as \"\"");
+
+    char emptyArgument[]{"aread:\n"};
+    RequestTokenizer emptyRequest{emptyArgument, ':'};
+    check((emptyRequest.argumentCount() == 1) && (!emptyRequest.hasArguments()), "missing: \"aread:\" has nothing after the header");
+
+    char emptyFields[]{"dreadmulti:2::4"};
+    RequestTokenizer emptyFieldsRequest{emptyFields, ':'};
+    check((emptyFieldsRequest.argumentCount() == 3) && (emptyFieldsRequest.argument(1)[0] == '\0') && (strcmp(emptyFieldsRequest.argument(2), "4") == 0), "missing: empty fields are kept in place");
+}
+
+static void longLinesAreTruncated()
+{
+    char line[REQUEST_TOKENIZER_MAXIMUM_FIELDS * 2 + 8];
+    strcpy(line, "dreadmulti");
+    for (int i = 0; i < REQUEST_TOKENIZER_MAXIMUM_FIELDS; i++) {
+        strcat(line, ":2");
+    }
+    RequestTokenizer request{line, ':'};
+    check(request.fieldCount() == REQUEST_TOKENIZER_MAXIMUM_FIELDS, "truncated: stops at REQUEST_TOKENIZER_MAXIMUM_FIELDS fields");
+    check(request.truncated(), "truncated: and says so");
+    check(strcmp(request.field(REQUEST_TOKENIZER_MAXIMUM_FIELDS - 1), "2:2") == 0, "truncated: the rest of the line stays in the last field");
+}
+
+static void canMessageParse()
+{
+    CanMessage message{CanMessage::parse("0x1a4:0x01:2:0xff", ':')};
+    check((message.id() == 0x1A4) && (message.length() == 3) && (message.nthByte(0) == 0x01) && (message.nthByte(1) == 0x02) && (message.nthByte(2) == 0xFF), "parse: id and bytes in any base");
+    CanMessage tooLong{CanMessage::parse("0x10:1:2:3:4:5:6:7:8:9:10", ":")};
+    check((tooLong.length() == CAN_MESSAGE_MAXIMUM_LENGTH) && (tooLong.nthByte(7) == 8), "parse: bytes past CAN_MESSAGE_MAXIMUM_LENGTH are ignored");
+    CanMessage copy{message};
+    copy.setLength(1);
+    copy.setLength(3);
+    check((copy.nthByte(0) == 0x01) && (copy.nthByte(1) == 0) && (message.nthByte(1) == 0x02), "parse: copies keep their own bytes");
+}
+
+int main()
+{
+    fieldsPointIntoTheLine();
+    missingArgumentsReadEmpty();
+    longLinesAreTruncated();
+    canMessageParse();
+    std::cout << ((failures == 0) ? "All tests passed" : "Some tests failed") << std::endl;
+    return ((failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,241 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "responsebuilder.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#    define HAVE_CYCLE_COUNTER 1
+#endif
+
+/* Compares the firmware's ResponseBuilder with the Stream operator<< it replaced, reproduced
+ * below, on the host. Stream is a stub with the same shape as the Arduino core's Print: every
+ * print() formats on its own and ends in a virtual write(). Both ways must send the same bytes;
+ * the counts show how many calls reach the port per reply and the timings what they cost */
+
+static const int ITERATIONS{200000};
+
+class Stream
+{
+public:
+    virtual ~Stream() = default;
+    virtual size_t write(uint8_t byte) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t written{0};
+        while (size--) {
+            written += this->write(*buffer++);
+        }
+        return written;
+    }
+    size_t write(const char *str) { return (str ? this->write(reinterpret_cast<const uint8_t *>(str), strlen(str)) : 0); }
+
+    size_t print(const char *str) { return this->write(str); }
+    size_t print(char c) { return this->write(static_cast<uint8_t>(c)); }
+    size_t print(unsigned char value) { return this->printNumber(value); }
+    size_t print(int value) { return this->print(static_cast<long>(value)); }
+    size_t print(unsigned int value) { return this->printNumber(value); }
+    size_t print(long value)
+    {
+        if (value < 0) {
+            size_t written{this->print('-')};
+            return written + this->printNumber(0UL - static_cast<unsigned long>(value));
+        }
+        return this->printNumber(static_cast<unsigned long>(value));
+    }
+    size_t print(unsigned long value) { return this->printNumber(value); }
+
+private:
+    //As Print::printNumber() does it, one 32 bit division per digit
+    size_t printNumber(unsigned long value)
+    {
+        char buffer[8 * sizeof(long) + 1];
+        char *str{&buffer[sizeof(buffer) - 1]};
+        *str = '\0';
+        do {
+            unsigned long quotient{value / 10};
+            *--str = static_cast<char>('0' + (value - 10 * quotient));
+            value = quotient;
+        } while (value);
+        return this->write(str);
+    }
+};
+
+//Counts what reaches the port: one call per write(), as a UART driver or USB CDC would see it
+class StubSerial : public Stream
+{
+public:
+    using Stream::write;
+    size_t write(uint8_t byte) override
+    {
+        this->m_calls++;
+        this->m_sent.push_back(static_cast<char>(byte));
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        this->m_calls++;
+        this->m_sent.append(reinterpret_cast<const char *>(buffer), size);
+        return size;
+    }
+    unsigned long calls() const { return this->m_calls; }
+    const std::string &sent() const { return this->m_sent; }
+    void clear()
+    {
+        this->m_calls = 0;
+        this->m_sent.clear();
+    }
+
+private:
+    unsigned long m_calls{0};
+    std::string m_sent;
+};
+
+template <typename Parameter> Stream &operator<<(Stream &lhs, const Parameter &parameter)
+{
+    lhs.print(parameter);
+    return lhs;
+}
+
+static const char ITEM_SEPARATOR{':'};
+static const char LINE_ENDING{'\n'};
+
+//printResult(DIGITAL_WRITE_HEADER, pin, state, OPERATION_SUCCESS)
+static void legacyResult(Stream *stream, int i)
+{
+    *stream << "dwrite" << ITEM_SEPARATOR << static_cast<int8_t>(i % 70) << ITEM_SEPARATOR << (i & 1) << ITEM_SEPARATOR << -(i % 9) << LINE_ENDING;
+}
+
+static void builderResult(Stream *stream, int i)
+{
+    ResponseBuilder<Stream> response{stream};
+    response << "dwrite" << ITEM_SEPARATOR << static_cast<int8_t>(i % 70) << ITEM_SEPARATOR << (i & 1) << ITEM_SEPARATOR << -(i % 9) << LINE_ENDING;
+}
+
+//analogReadMultiRequest for eight pins
+static void legacyMulti(Stream *stream, int i)
+{
+    *stream << "areadmulti";
+    for (int pin = 0; pin < 8; pin++) {
+        *stream << ITEM_SEPARATOR << "A" << ITEM_SEPARATOR << ((i * 37 + pin * 131) % 1024) << ITEM_SEPARATOR << 1;
+    }
+    *stream << ITEM_SEPARATOR << 1 << LINE_ENDING;
+}
+
+static void builderMulti(Stream *stream, int i)
+{
+    ResponseBuilder<Stream> response{stream};
+    response << "areadmulti";
+    for (int pin = 0; pin < 8; pin++) {
+        response << ITEM_SEPARATOR << "A" << ITEM_SEPARATOR << ((i * 37 + pin * 131) % 1024) << ITEM_SEPARATOR << 1;
+    }
+    response << ITEM_SEPARATOR << 1 << LINE_ENDING;
+}
+
+static unsigned long long cycleCount()
+{
+#if defined(HAVE_CYCLE_COUNTER)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int checkSame(const char *title, void (*legacy)(Stream *, int), void (*builder)(Stream *, int))
+{
+    StubSerial legacySerial;
+    StubSerial builderSerial;
+    int mismatches{0};
+    for (int i = 0; i < 1000; i++) {
+        legacy(&legacySerial, i);
+        builder(&builderSerial, i);
+        if (legacySerial.sent() != builderSerial.sent()) {
+            std::cout << "MISMATCH: \"" << legacySerial.sent() << "\" != \"" << builderSerial.sent() << "\"" << std::endl;
+            mismatches++;
+        }
+        legacySerial.clear();
+        builderSerial.clear();
+    }
+    legacy(&legacySerial, 7);
+    builder(&builderSerial, 7);
+    std::string sample{builderSerial.sent()};
+    sample.pop_back();
+    std::cout << title << " (e.g. \"" << sample << "\"), " << (1000 - mismatches) << "/1000 replies identical, "
+              << legacySerial.calls() << " writes to the port per reply before, " << builderSerial.calls() << " now" << std::endl;
+    return mismatches;
+}
+
+static void runBenchmark(const char *title, void (*reply)(Stream *, int))
+{
+    StubSerial serial;
+    volatile size_t sink{0};
+    auto startTime = std::chrono::steady_clock::now();
+    unsigned long long startCycles{cycleCount()};
+    for (int i = 0; i < ITERATIONS; i++) {
+        reply(&serial, i);
+        sink = sink + serial.sent().size();
+        serial.clear();
+    }
+    unsigned long long endCycles{cycleCount()};
+    auto endTime = std::chrono::steady_clock::now();
+    double nanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+
+    std::cout << title << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << nanoseconds << "ns/reply";
+#if defined(HAVE_CYCLE_COUNTER)
+    std::cout << ", " << static_cast<double>(endCycles - startCycles) / ITERATIONS << " cycles/reply";
+#else
+    (void)startCycles;
+    (void)endCycles;
+#endif
+    std::cout << std::endl << std::endl;
+}
+
+static int checkFormatting()
+{
+    static const long values[]{0, 7, -1, 10, 65535, 65536, -65536, 1000000, 2147483647L, -2147483647L - 1};
+    int mismatches{0};
+    for (long value : values) {
+        char out[RESPONSE_FORMAT_MAXIMUM_DIGITS + 1];
+        out[ResponseFormat::signedDecimal(value, out)] = '\0';
+        if (std::to_string(value) != out) {
+            std::cout << "MISMATCH: " << value << " formatted as \"" << out << "\"" << std::endl;
+            mismatches++;
+        }
+    }
+    StubSerial serial;
+    {
+        ResponseBuilder<Stream> response{&serial};
+        for (int i = 0; i < 40; i++) {
+            response << "ioreport" << ITEM_SEPARATOR << i;
+        }
+    }
+    std::string expected;
+    for (int i = 0; i < 40; i++) {
+        expected += "ioreport:" + std::to_string(i);
+    }
+    if ((serial.sent() != expected) || (serial.calls() != ((expected.size() + RESPONSE_BUILDER_CAPACITY - 1) / RESPONSE_BUILDER_CAPACITY) + 1)) {
+        std::cout << "MISMATCH: a reply longer than RESPONSE_BUILDER_CAPACITY is not sent whole, in buffer sized writes" << std::endl;
+        mismatches++;
+    }
+    std::cout << "Integer formatting and overlong replies: " << ((mismatches == 0) ? "ok" : "FAILED") << std::endl << std::endl;
+    return mismatches;
+}
+
+int main()
+{
+    int mismatches{checkFormatting()};
+    mismatches += checkSame("printResult()", legacyResult, builderResult);
+    mismatches += checkSame("multi request reply", legacyMulti, builderMulti);
+    std::cout << std::endl;
+
+    runBenchmark("printResult(), Stream::print per field", legacyResult);
+    runBenchmark("printResult(), ResponseBuilder", builderResult);
+    runBenchmark("multi request reply, Stream::print per field", legacyMulti);
+    runBenchmark("multi request reply, ResponseBuilder", builderMulti);
+    return ((mismatches == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -7,16 +7,35 @@
 #include <future>
 #include <algorithm>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <chrono>
 #include <set>
+#include <initializer_list>
 #include <vector>
+#include <array>
+#include <type_traits>
+#include <limits>
+#include <atomic>
 #include "serialport.h"
 
 #include "generalutilities.h"
 #include "eventtimer.h"
 #include "tstream.h"
+#include "binaryframe.h"
+#include "responseparser.h"
+#include "iometrics.h"
+#include "roundtripestimator.h"
+#include "ringbuffer.h"
 
 
 enum class ArduinoType { UNO, NANO, MEGA };
+enum class IOResponseMode { EVENT_DRIVEN, SEND_DELAY };
+enum class ProtocolMode { ASCII, BINARY };
+enum class IOStreamMode { PERIODIC, ON_CHANGE, DELTA };
+enum class CacheMode { FORCE_REFRESH, CACHED, MAXIMUM_AGE };
 enum IOType { DIGITAL_INPUT, DIGITAL_OUTPUT, ANALOG_INPUT, ANALOG_OUTPUT, DIGITAL_INPUT_PULLUP, UNSPECIFIED };
 enum IOStatus { OPERATION_SUCCESS, OPERATION_FAILURE };
 enum IOState { PIN_NUMBER, STATE, RETURN_CODE };
@@ -28,6 +47,61 @@ enum CanIOStatus { MESSAGE_ID, BYTE_0, BYTE_1, BYTE_2, BYTE_3, BYTE_4, BYTE_5, B
 enum CanMask { CAN_MASK_RETURN_STATE, CAN_MASK_OPERATION_RESULT };
 enum CanMaskType { POSITIVE, NEGATIVE };
 
+const unsigned int MULTI_IO_STATE_RETURN_SIZE{3};
+//Firmware assembles at most LINE_ASSEMBLER_BUFFER_SIZE (175) bytes per request, longer batches are split
+const unsigned int MULTI_IO_MAXIMUM_REQUEST_LENGTH{170};
+//Every pin in a multi request costs at least a separator and one digit
+const size_t MULTI_IO_MAXIMUM_PINS_PER_REQUEST{(MULTI_IO_MAXIMUM_REQUEST_LENGTH - 1) / 2};
+
+//Large enough for the reply to the longest multi request batch (pin:state:result per pin plus the overall result)
+const size_t MAXIMUM_RESPONSE_FIELDS{(MULTI_IO_MAXIMUM_PINS_PER_REQUEST * MULTI_IO_STATE_RETURN_SIZE) + 1};
+using IOResponseFields = ResponseFields<MAXIMUM_RESPONSE_FIELDS>;
+//Large enough for a full Mega IO report (pin:type:state for every pin plus the end marker)
+const size_t MAXIMUM_IO_REPORT_FIELDS{256};
+using IOReportFields = ResponseFields<MAXIMUM_IO_REPORT_FIELDS>;
+
+/* One bit per pin number, built at compile time from a board's pin list, so asking whether a pin
+ * is analog, PWM and so on is a single bit test rather than a std::set lookup. Covers pins 0 to
+ * 127; the Mega's highest is 69 */
+class PinMask
+{
+public:
+    constexpr PinMask() :
+        m_words{0, 0}
+    {
+
+    }
+
+    constexpr PinMask(std::initializer_list<int> pinNumbers) :
+        m_words{maskWord(pinNumbers, 0), maskWord(pinNumbers, 1)}
+    {
+
+    }
+
+    constexpr bool test(int pinNumber) const
+    {
+        return ((pinNumber >= 0) && (pinNumber < MAXIMUM_PIN_NUMBER) && (((this->m_words[pinNumber / 64] >> (pinNumber % 64)) & 1) != 0));
+    }
+
+    std::set<int> pinNumbers() const;
+
+    static constexpr int MAXIMUM_PIN_NUMBER{128};
+
+private:
+    uint64_t m_words[2];
+
+    static constexpr uint64_t maskWord(std::initializer_list<int> pinNumbers, int word)
+    {
+        uint64_t mask{0};
+        for (int pinNumber : pinNumbers) {
+            if ((pinNumber >= 0) && (pinNumber < MAXIMUM_PIN_NUMBER) && ((pinNumber / 64) == word)) {
+                mask |= (static_cast<uint64_t>(1) << (pinNumber % 64));
+            }
+        }
+        return mask;
+    }
+};
+
 
 #ifndef HIGH
     #define HIGH 0x1
@@ -41,6 +115,7 @@ class ArduinoUno;
 class ArduinoNano;
 class ArduinoMega;
 class GPIO;
+class ReadPolicy;
 class IOReport;
 class SerialReport;
 //class LinMessage;
@@ -49,11 +124,26 @@ class SerialReport;
 class CanReport;
 class CanMessage;
 class CanDataPacket;
+class BusCaptureWriter;
+class CanFilter;
+
+//Pushed CAN frames are queued here by the reader thread until pollCanMessages() collects them
+const size_t CAN_STREAM_RING_SIZE{1024};
+using CanMessageRing = RingBuffer<CanMessage, CAN_STREAM_RING_SIZE>;
+
+struct CanStreamStatistics
+{
+    uint64_t received;
+    uint64_t overruns;
+    uint64_t malformed;
+    uint64_t filtered;
+};
 
 class Arduino
 {
 public:
     Arduino(ArduinoType arduinoType, std::shared_ptr<TStream> ioStream);
+    ~Arduino();
     std::pair<IOStatus, bool> digitalRead(int pinNumber);
     std::pair<IOStatus, bool> digitalWrite(int pinNumber, bool state);
     std::pair<IOStatus, std::vector<int>> digitalWriteAll(bool state);
@@ -64,6 +154,13 @@ public:
     std::pair<IOStatus, bool> softDigitalRead(int pinNumber);
     std::pair<IOStatus, double> softAnalogRead(int pinNumber);
     std::pair<IOStatus, int> softAnalogReadRaw(int pinNumber);
+    std::pair<IOStatus, bool> digitalRead(int pinNumber, const ReadPolicy &readPolicy);
+    std::pair<IOStatus, double> analogRead(int pinNumber, const ReadPolicy &readPolicy);
+    std::pair<IOStatus, int> analogReadRaw(int pinNumber, const ReadPolicy &readPolicy);
+    std::pair<IOStatus, bool> softDigitalRead(int pinNumber, const ReadPolicy &readPolicy);
+    std::pair<IOStatus, double> softAnalogRead(int pinNumber, const ReadPolicy &readPolicy);
+    std::pair<IOStatus, int> softAnalogReadRaw(int pinNumber, const ReadPolicy &readPolicy);
+    void invalidatePinStates();
     std::pair<IOStatus, IOType> pinMode(int pinNumber, IOType ioType);
     std::pair<IOStatus, IOType> currentPinMode(int pinNumber);
     std::pair<IOStatus, std::string> firmwareVersion();
@@ -73,19 +170,49 @@ public:
     std::pair<IOStatus, uint32_t> addCanMask(CanMaskType canMaskType, const std::string &mask);
     std::pair<IOStatus, uint32_t> removeCanMask(CanMaskType canMaskType, const std::string &mask);
     std::pair<IOStatus, bool> removeAllCanMasks(CanMaskType canMaskType);
+    std::pair<IOStatus, size_t> setCanMasks(CanMaskType canMaskType, const std::vector<uint32_t> &ids);
+    std::pair<IOStatus, bool> setCanFilter(const CanFilter &canFilter);
     std::pair<IOStatus, CanMessage> canWrite(const CanMessage &message);
     std::pair<IOStatus, bool> canAutoUpdate(bool state);
+    std::pair<IOStatus, unsigned int> setCanBatchSize(unsigned int frames);
     std::pair<IOStatus, bool> initializeCanBus();
     std::pair<IOStatus, CanMessage> canRead();    
     std::pair<IOStatus, CanMessage> canListen(double delay);
     std::pair<IOStatus, bool> canCapability();
+    std::pair<IOStatus, uint32_t> canReceiveOverflows();
+    size_t pollCanMessages(CanMessage *messages, size_t maximumMessages);
+    CanStreamStatistics canStreamStatistics() const;
+    void resetCanStreamStatistics();
+    void setBusCapture(std::shared_ptr<BusCaptureWriter> busCapture);
+    std::shared_ptr<BusCaptureWriter> busCapture() const;
+
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, bool>>> digitalReadMany(const std::vector<int> &pinNumbers);
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, bool>>> digitalWriteMany(const std::vector<std::pair<int, bool>> &pinStates);
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, double>>> analogReadMany(const std::vector<int> &pinNumbers);
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, int>>> analogReadRawMany(const std::vector<int> &pinNumbers);
+
+    std::future<std::pair<IOStatus, bool>> digitalReadAsync(int pinNumber);
+    std::future<std::pair<IOStatus, bool>> digitalWriteAsync(int pinNumber, bool state);
+    std::future<std::pair<IOStatus, double>> analogReadAsync(int pinNumber);
+    std::future<std::pair<IOStatus, int>> analogReadRawAsync(int pinNumber);
 
     SerialReport serialReportRequest(const std::string &delimiter);
     CanReport canReportRequest();
     IOReport ioReportRequest();
+    IOReport ioReportDeltaRequest(bool resynchronize);
+    IOReport cachedIOReport();
+    std::pair<IOStatus, int> setAnalogReportDeadband(int deadband);
+
+    std::pair<IOStatus, unsigned int> subscribeIOReports(unsigned int intervalMilliseconds, IOStreamMode ioStreamMode, std::function<void(const IOReport &)> onIOReport);
+    IOStatus unsubscribeIOReports();
 
     std::string serialPortName() const;
 
+    std::map<std::string, IOCommandMetrics> ioMetrics() const;
+    IOCommandMetrics ioMetrics(const std::string &header) const;
+    std::string ioMetricsReport() const;
+    void resetIOMetrics();
+
     std::set<int> AVAILABLE_ANALOG_PINS() const;
     std::set<int> AVAILABLE_PWM_PINS() const;
     std::set<int> AVAILABLE_PINS() const;
@@ -101,6 +228,21 @@ public:
     void setStreamSendDelay(unsigned int streamSendDelay);
     unsigned int streamSendDelay() const;
 
+    void setAdaptiveTimeout(bool adaptiveTimeout);
+    bool adaptiveTimeout() const;
+    double responseTimeLimit() const;
+    double smoothedRoundTripTime() const;
+    void resetRoundTripEstimate();
+
+    void setIOResponseMode(IOResponseMode ioResponseMode);
+    IOResponseMode ioResponseMode() const;
+
+    std::pair<IOStatus, ProtocolMode> negotiateProtocolMode(ProtocolMode protocolMode);
+    ProtocolMode protocolMode() const;
+
+    void setMaximumInFlightCommands(unsigned int maximumInFlightCommands);
+    unsigned int maximumInFlightCommands() const;
+
     void assignPinsAndIdentifiers();
 
     static const BaudRate FIRMWARE_BAUD_RATE;
@@ -113,18 +255,58 @@ public:
     static const unsigned int DEFAULT_IO_TRY_COUNT;
     
 private:
+    struct AsyncIORequest
+    {
+        std::string header;
+        std::string pinNumber;
+        std::chrono::steady_clock::time_point sentTime;
+        std::chrono::steady_clock::time_point deadline;
+        size_t bytesSent;
+        std::function<void(const std::vector<std::string> &)> onResponse;
+    };
+
     std::map<int, std::shared_ptr<GPIO>> m_gpioPins;
+    std::mutex m_pinStateMutex;
     std::shared_ptr<TStream> m_ioStream;
     std::mutex m_ioMutex;
     ArduinoType m_arduinoType;
     std::string m_identifier;
     std::string m_longName;
-    std::set<int> m_availablePins;
-    std::set<int> m_availablePwmPins;
-    std::set<int> m_availableAnalogPins;
+    PinMask m_availablePins;
+    PinMask m_availablePwmPins;
+    PinMask m_availableAnalogPins;
     int m_numberOfDigitalPins;
     unsigned int m_streamSendDelay;
     unsigned int m_ioTryCount;
+    IOResponseMode m_ioResponseMode;
+    unsigned int m_maximumInFlightCommands;
+    ProtocolMode m_protocolMode;
+    std::condition_variable m_ioCondition;
+    std::deque<AsyncIORequest> m_inFlightRequests;
+    std::string m_asyncReadBuffer;
+    bool m_asyncReaderRunning;
+    bool m_asyncReaderBusy;
+    unsigned int m_exclusiveIOWaiters;
+    std::thread m_asyncReaderThread;
+    bool m_ioReportsSubscribed;
+    std::function<void(const IOReport &)> m_onIOReport;
+    std::vector<std::string> m_pendingIOReportFrames;
+    IOReportFields m_ioReportFields;
+    std::unique_ptr<IOReport> m_ioReportCache;
+    IOMetrics m_ioMetrics;
+    bool m_adaptiveTimeout;
+    bool m_canStreaming;
+    std::unique_ptr<CanMessageRing> m_canMessageRing;
+    std::mutex m_canPollMutex;
+    IOResponseFields m_canStreamFields;
+    std::atomic<uint64_t> m_canStreamReceived;
+    std::atomic<uint64_t> m_canStreamOverruns;
+    std::atomic<uint64_t> m_canStreamMalformed;
+    std::atomic<uint64_t> m_canStreamFiltered;
+    std::unique_ptr<CanFilter> m_canFilter;
+    std::shared_ptr<BusCaptureWriter> m_busCapture;
+    mutable std::mutex m_busCaptureMutex;
+    RoundTripEstimator m_roundTripEstimator;
 
     bool isValidAnalogPinIdentifier(const std::string &state) const;
     bool isValidDigitalStateIdentifier(const std::string &state) const;
@@ -136,8 +318,40 @@ private:
     bool isValidAnalogOutputPin(int pinNumber) const;
     bool isValidAnalogInputPin(int pinNumber) const;
 
+    void openIOStream();
+    bool waitForFirmwareReady();
+    double timeLimitForDelay(double delay) const;
+    void waitForExclusiveIO(std::unique_lock<std::mutex> &ioLock);
+    void startAsyncReader();
+    std::string readResponseFrame(const std::string &header, const std::string &endSequence, double timeLimit);
+    void dispatchSkippedFrames(const std::string &skipped);
+    bool routePushedIOReports(std::string *received);
+    std::string genericIOFrameTask(const std::string &stringToSend, const std::string &header, double delay);
     std::vector<std::string> genericIOTask(const std::string &stringToSend, const std::string &header, double delay);
+    bool genericIOTask(const std::string &stringToSend, const std::string &header, double delay, IOResponseFields *fields);
+    std::pair<IOStatus, int> ioStateRequest(const std::string &stringToSend, const std::string &header, int pinNumber);
     std::vector<std::string> genericIOReportTask(const std::string &stringToSend, const std::string &header, const std::string &endHeader, double delay); 
+    void genericAsyncIOTask(const std::string &stringToSend, const std::string &header, const std::string &pinNumber, std::function<void(const std::vector<std::string> &)> onResponse);
+    void asyncReaderLoop();
+    void dispatchAsyncResponse(std::string &&frame);
+    void queueCanStreamFrame(std::string &&frame);
+    void queueCanStreamBatch(std::string &&frame);
+    void queueCanStreamMessage(const CanMessage &message);
+    static bool parseCanReadFields(const IOResponseFields &fields, CanMessage *message);
+    void captureCanMessage(const CanMessage &message, bool transmitted);
+    void expireAsyncRequests(bool expireAll);
+    IOStatus ioStreamRequest(const std::string &stringToSend, unsigned int intervalMilliseconds, IOStreamMode ioStreamMode);
+    bool parseIOReportFields(const IOReportFields &fields, IOReport *ioReport) const;
+    void recordPinState(int pinNumber, IOType ioType, const std::pair<IOStatus, int> &result);
+    void recordSoftPinState(int pinNumber, bool analogState, const std::pair<IOStatus, int> &result);
+    void recordPinType(int pinNumber, IOType ioType);
+    void recordIOReport(const IOReport &ioReport);
+    void invalidatePinState(int pinNumber);
+    bool cachedPinState(int pinNumber, bool analogState, const ReadPolicy &readPolicy, int *state);
+    std::vector<std::pair<IOStatus, int>> genericMultiIOTask(const std::string &header, const std::vector<int> &pinNumbers, const std::vector<std::string> &pinArguments);
+    std::vector<uint8_t> genericBinaryIOTask(uint8_t opcode, const std::vector<uint8_t> &payload, double delay);
+    std::pair<IOStatus, int> binaryIOStateRequest(uint8_t opcode, int pinNumber, const std::vector<uint8_t> &arguments);
+    static std::pair<IOStatus, int> parseIOStateResponse(int pinNumber, const std::vector<std::string> &states);
 };
 
 class ArduinoUno
@@ -145,9 +359,9 @@ class ArduinoUno
 public:
     ArduinoUno() = delete;
     virtual void doStuff() = 0;
-    static std::set<int> s_availableAnalogPins;
-    static std::set<int> s_availablePwmPins;
-    static std::set<int> s_availablePins;
+    static constexpr PinMask s_availableAnalogPins{14, 15, 16, 17, 18, 19};
+    static constexpr PinMask s_availablePwmPins{3, 5, 6, 9, 10, 11};
+    static constexpr PinMask s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
     static const char *IDENTIFIER;
     static const char *LONG_NAME;
     static int s_numberOfDigitalPins;
@@ -158,9 +372,9 @@ class ArduinoNano
 public:
     ArduinoNano() = delete;
     virtual void doStuff() = 0;
-    static std::set<int> s_availableAnalogPins;
-    static std::set<int> s_availablePwmPins;
-    static std::set<int> s_availablePins;
+    static constexpr PinMask s_availableAnalogPins{14, 15, 16, 17, 18, 19, 20, 21};
+    static constexpr PinMask s_availablePwmPins{3, 5, 6, 9, 10, 11};
+    static constexpr PinMask s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21};
     static const char *IDENTIFIER;
     static const char *LONG_NAME;
     static int s_numberOfDigitalPins;
@@ -171,9 +385,17 @@ class ArduinoMega
 public:
     ArduinoMega() = delete;
     virtual void doStuff() = 0;
-    static std::set<int> s_availableAnalogPins;
-    static std::set<int> s_availablePwmPins;
-    static std::set<int> s_availablePins;
+    static constexpr PinMask s_availableAnalogPins{54, 55, 56, 57, 58, 59, 60, 61,
+                                                   62, 63, 64, 65, 66, 67, 68, 69};
+    static constexpr PinMask s_availablePwmPins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 44, 45, 46};
+    static constexpr PinMask s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                             13, 14, 15, 16, 17, 18, 19, 20, 21,
+                                             22, 23, 24, 25, 26, 27, 28, 29, 30,
+                                             31, 32, 33, 34, 35, 36, 37, 38, 39,
+                                             40, 41, 42, 43, 44, 45, 46, 47, 48,
+                                             49, 50, 51, 52, 53, 54, 55, 56, 57,
+                                             58, 59, 60, 61, 62, 63, 64, 65, 66,
+                                             67, 68, 69};
     static const char *IDENTIFIER;
     static const char *LONG_NAME;
     static int s_numberOfDigitalPins;
@@ -184,15 +406,45 @@ class GPIO
 public:
     GPIO(int pinNumber, IOType ioType) :
         m_pinNumber{pinNumber},
-        m_ioType{ioType} { }
+        m_ioType{ioType},
+        m_state{0},
+        m_hasState{false} { }
     int pinNumber() const { return this->m_pinNumber; }
     IOType ioType() const { return this->m_ioType; }
     void setIOType(IOType ioType) { this->m_ioType = ioType; }
+    int state() const { return this->m_state; }
+    bool hasState() const { return this->m_hasState; }
+    std::chrono::steady_clock::time_point stateTime() const { return this->m_stateTime; }
+    void setState(int state) { this->m_state = state; this->m_hasState = true; this->m_stateTime = std::chrono::steady_clock::now(); }
+    void clearState() { this->m_hasState = false; }
     friend bool operator==(const GPIO &lhs, const GPIO &rhs) { return (lhs.pinNumber() == rhs.pinNumber()); }
 
 private:
     int m_pinNumber;
     IOType m_ioType;
+    int m_state;
+    bool m_hasState;
+    std::chrono::steady_clock::time_point m_stateTime;
+};
+
+/* How a read may use the cached pin state: FORCE_REFRESH always asks the board, CACHED takes
+ * any known state, MAXIMUM_AGE takes a state no older than maximumAge() milliseconds */
+class ReadPolicy
+{
+public:
+    static ReadPolicy forceRefresh() { return ReadPolicy{CacheMode::FORCE_REFRESH, 0}; }
+    static ReadPolicy cached() { return ReadPolicy{CacheMode::CACHED, 0}; }
+    static ReadPolicy maximumAge(unsigned int milliseconds) { return ReadPolicy{CacheMode::MAXIMUM_AGE, milliseconds}; }
+    CacheMode cacheMode() const { return this->m_cacheMode; }
+    unsigned int maximumAge() const { return this->m_maximumAge; }
+
+private:
+    ReadPolicy(CacheMode cacheMode, unsigned int maximumAge) :
+        m_cacheMode{cacheMode},
+        m_maximumAge{maximumAge} { }
+
+    CacheMode m_cacheMode;
+    unsigned int m_maximumAge;
 };
 
 class IOReport
@@ -208,7 +460,38 @@ public:
     std::vector<std::pair<int, int>> analogInputResults() const { return this->m_analogInputResults; }
     std::vector<std::pair<int, int>> analogOutputResults() const { return this->m_analogOutputResults; }
 
+    /* Folds a (possibly partial, e.g. delta) report into this one: every pin it
+     * contains replaces whatever this report held for that pin, under any type */
+    void merge(const IOReport &ioReport)
+    {
+        for (auto &it : ioReport.m_digitalInputResults) {
+            this->removeResult(it.first);
+            this->m_digitalInputResults.emplace_back(it);
+        }
+        for (auto &it : ioReport.m_digitalOutputResults) {
+            this->removeResult(it.first);
+            this->m_digitalOutputResults.emplace_back(it);
+        }
+        for (auto &it : ioReport.m_analogInputResults) {
+            this->removeResult(it.first);
+            this->m_analogInputResults.emplace_back(it);
+        }
+        for (auto &it : ioReport.m_analogOutputResults) {
+            this->removeResult(it.first);
+            this->m_analogOutputResults.emplace_back(it);
+        }
+    }
+
 private:
+    void removeResult(int pinNumber)
+    {
+        auto samePin = [pinNumber](const auto &result) { return result.first == pinNumber; };
+        this->m_digitalInputResults.erase(std::remove_if(this->m_digitalInputResults.begin(), this->m_digitalInputResults.end(), samePin), this->m_digitalInputResults.end());
+        this->m_digitalOutputResults.erase(std::remove_if(this->m_digitalOutputResults.begin(), this->m_digitalOutputResults.end(), samePin), this->m_digitalOutputResults.end());
+        this->m_analogInputResults.erase(std::remove_if(this->m_analogInputResults.begin(), this->m_analogInputResults.end(), samePin), this->m_analogInputResults.end());
+        this->m_analogOutputResults.erase(std::remove_if(this->m_analogOutputResults.begin(), this->m_analogOutputResults.end(), samePin), this->m_analogOutputResults.end());
+    }
+
     std::vector<std::pair<int, bool>> m_digitalInputResults;
     std::vector<std::pair<int, bool>> m_digitalOutputResults;
     std::vector<std::pair<int, int>> m_analogInputResults;
@@ -232,6 +515,10 @@ const unsigned int CAN_BYTE_WIDTH{2};
 const unsigned int RAW_CAN_MESSAGE_SIZE{8};
 const unsigned char CAN_MESSAGE_LENGTH{8};
 const unsigned char CAN_FRAME{0};
+const unsigned char CAN_EXTENDED_FRAME{1};
+//A {canbatch} frame writes extended IDs with exactly this many digits, standard IDs with fewer
+const size_t CAN_BATCH_EXTENDED_ID_DIGITS{8};
+const unsigned int MAXIMUM_CAN_BATCH_SIZE{8};
 const unsigned int CAN_BUS_ENABLED_RETURN_SIZE{2};
 const unsigned int CAN_READ_RETURN_SIZE{10};
 const unsigned int CAN_WRITE_RETURN_SIZE{10};
@@ -239,29 +526,50 @@ const unsigned int CAN_AUTO_UPDATE_RETURN_SIZE{2};
 const unsigned int CAN_INIT_RETURN_SIZE{2};
 const unsigned int ADD_CAN_MASK_RETURN_SIZE{3};
 const unsigned int REMOVE_CAN_MASK_RETURN_SIZE{3};
+const unsigned int SET_CAN_MASKS_RETURN_SIZE{2};
+const unsigned int CAN_RECEIVE_OVERFLOWS_RETURN_SIZE{2};
+const unsigned int CAN_BATCH_SIZE_RETURN_SIZE{2};
+//Slots in each of the firmware's positive and negative CAN mask lists
+const size_t FIRMWARE_CAN_MASK_SLOTS{10};
 
 const unsigned int IO_STATE_RETURN_SIZE{3};
 const unsigned int ARDUINO_TYPE_RETURN_SIZE{2};
 const unsigned int PIN_TYPE_RETURN_SIZE{3};
 const unsigned int IO_REPORT_RETURN_SIZE{3};
 const unsigned int A_TO_D_THRESHOLD_RETURN_SIZE{2};
+const unsigned int BINARY_MODE_RETURN_SIZE{2};
+const unsigned int IO_STREAM_RETURN_SIZE{3};
+const unsigned int IO_DEADBAND_RETURN_SIZE{2};
+const unsigned int IO_STREAM_MINIMUM_INTERVAL{10};
+const unsigned int IO_STREAM_MAXIMUM_INTERVAL{60000};
+//Mode numbers the firmware expects after the interval of an iostream request, and echoes back
+const int IO_STREAM_PERIODIC_MODE{0};
+const int IO_STREAM_ON_CHANGE_MODE{1};
+const int IO_STREAM_DELTA_MODE{2};
 const unsigned int RETURN_SIZE_HIGH_LIMIT{1000};
 const int STATE_FAILURE{-1};
 const int INVALID_PIN{-1};
 const double SERIAL_TIMEOUT{50};
 const int BLUETOOTH_RETRY_COUNT{10};
 const double BOOTLOADER_BOOT_TIME{2000};
+const double FIRMWARE_READY_PROBE_TIME_LIMIT{100};
+const double FIRMWARE_READY_PROBE_SETTLE_TIME{10};
 const double BLUETOOTH_SERIAL_SEND_DELAY{100};
 const int DEFAULT_IO_STREAM_SEND_DELAY{20};
+const IOResponseMode DEFAULT_IO_RESPONSE_MODE{IOResponseMode::EVENT_DRIVEN};
+const unsigned int DEFAULT_MAXIMUM_IN_FLIGHT_COMMANDS{8};
+const unsigned int ASYNC_READER_POLL_TIME{5};
 const double ANALOG_TO_VOLTAGE_SCALE_FACTOR{0.0049};
 const double DEFAULT_BLUETOOTH_SEND_DELAY_MULTIPLIER{4.8};
 
 const unsigned int DIGITAL_WRITE_ALL_MINIMIM_RETURN_SIZE{2};
 const unsigned int SERIAL_REPORT_REQUEST_TIME_LIMIT{50};
 const unsigned int SERIAL_REPORT_OVERALL_TIME_LIMIT{50};
+const double MINIMUM_ADAPTIVE_TIME_LIMIT{20};
+const double MAXIMUM_ADAPTIVE_TIME_LIMIT{2000};
 
-unsigned int SERIAL_PORT_TRY_COUNT_HIGH_LIMIT{4};
-double bluetoothSendDelayMultiplier{DEFAULT_BLUETOOTH_SEND_DELAY_MULTIPLIER};
+const unsigned int SERIAL_PORT_TRY_COUNT_HIGH_LIMIT{4};
+const double bluetoothSendDelayMultiplier{DEFAULT_BLUETOOTH_SEND_DELAY_MULTIPLIER};
 
 const int IO_TRY_COUNT{4};
 
@@ -276,6 +584,9 @@ const char * const DIGITAL_READ_HEADER{"{dread"};
 const char * const ANALOG_READ_HEADER{"{aread"};
 const char * const DIGITAL_WRITE_HEADER{"{dwrite"};
 const char * const DIGITAL_WRITE_ALL_HEADER{"{dwriteall"};
+const char * const DIGITAL_READ_MULTI_HEADER{"{dreadmulti"};
+const char * const DIGITAL_WRITE_MULTI_HEADER{"{dwritemulti"};
+const char * const ANALOG_READ_MULTI_HEADER{"{areadmulti"};
 const char * const ANALOG_WRITE_HEADER{"{awrite"};
 const char * const SOFT_DIGITAL_READ_HEADER{"{sdread"};
 const char * const SOFT_ANALOG_READ_HEADER{"{saread"};
@@ -284,8 +595,13 @@ const char * const PIN_TYPE_CHANGE_HEADER{"{ptchange"};
 const char * const ARDUINO_TYPE_HEADER{"{ardtype"};
 const char * const FIRMWARE_VERSION_HEADER{"{version"};
 const char * const HEARTBEAT_HEADER{"{heartbeat"};
+const char * const BINARY_MODE_HEADER{"{binmode"};
 const char * const IO_REPORT_HEADER{"{ioreport"};
 const char * const IO_REPORT_END_HEADER{"{ioreportend"};
+const char * const IO_REPORT_DELTA_HEADER{"{ioreportdelta"};
+const char * const IO_STREAM_HEADER{"{iostream"};
+const char * const IO_DEADBAND_HEADER{"{iodeadband"};
+const char * const IO_STREAM_END_IDENTIFIER{"ioreportend"};
 const char * const CHANGE_A_TO_D_THRESHOLD_HEADER{"{atodchange"};
 const char * const CURRENT_A_TO_D_THRESHOLD_HEADER{"{atodthresh"};
 
@@ -295,6 +611,7 @@ const char * const CURRENT_CAN_MESSAGES_HEADER{"{curcanmsgs"};
 const char * const CURRENT_CAN_MESSAGE_BY_ID_HEADER{"{curcanmsgid"};
 const char * const CAN_BUS_ENABLED_HEADER{"{canbus"};
 const char * const CAN_READ_HEADER{"{canread"};
+const char * const CAN_LIVE_UPDATE_HEADER{"{canlup"};
 const char * const CAN_WRITE_HEADER{"{canwrite"};
 const char * const ADD_POSITIVE_CAN_MASK_HEADER{"{addpcanmask"};
 const char * const ADD_NEGATIVE_CAN_MASK_HEADER{"{addncanmask"};
@@ -302,7 +619,12 @@ const char * const REMOVE_POSITIVE_CAN_MASK_HEADER{"{rempcanmask"};
 const char * const REMOVE_NEGATIVE_CAN_MASK_HEADER{"{remncanmask"};
 const char * const CLEAR_ALL_POSITIVE_CAN_MASKS_HEADER{"{clearpcanmasks"};
 const char * const CLEAR_ALL_NEGATIVE_CAN_MASKS_HEADER{"{clearncanmasks"};
+const char * const SET_POSITIVE_CAN_MASKS_HEADER{"{setpcanmasks"};
+const char * const SET_NEGATIVE_CAN_MASKS_HEADER{"{setncanmasks"};
 const char * const CLEAR_ALL_CAN_MASKS_HEADER{"{clearallcanmasks"};
+const char * const CAN_RECEIVE_OVERFLOWS_HEADER{"{canrxovf"};
+const char * const CAN_BATCH_SIZE_HEADER{"{canbsize"};
+const char * const CAN_BATCH_HEADER{"{canbatch"};
 const char * const CAN_REPORT_INVALID_DATA_STRING{"Invalid data received"};
 const char * const CAN_EMPTY_READ_SUCCESS_STRING{"{canread:1}"};
 
@@ -374,7 +696,10 @@ const char * const ANALOG_INPUT_IDENTIFIER{"ain"};
 const char * const ANALOG_OUTPUT_IDENTIFIER{"aout"};
 const char * const DIGITAL_INPUT_PULLUP_IDENTIFIER{"dinpup"};
 const char * const OPERATION_FAILURE_STRING{"-1"};
+const char * const OPERATION_SUCCESS_STRING{"1"};
+const int OPERATION_SUCCESS_CODE{1};
 const char * const IO_REPORT_INVALID_DATA_STRING{"Arduino::ioReportRequest(int) timed out or received invalid data"};
+const char * const IO_REPORT_DELTA_INVALID_DATA_STRING{"Arduino::ioReportDeltaRequest(bool) timed out or received invalid data"};
 
 const char * const BLUETOOTH_SERIAL_IDENTIFIER{"rfcomm"};
 const char * const INVALID_PIN_ALIAS_STRING{"Invalid pin alias: "};
@@ -391,19 +716,21 @@ const char * const INVALID_STATE_TO_PARSE_TO_ANALOG_STATE_STRING{"Invalid state
 const char * const INVALID_STATE_TO_PARSE_TO_ANALOG_STATE_RAW_STRING{"Invalid state passed to Arduino::parseToAnalogStateRaw(const std::string &): "};
 const char * const FIRMWARE_VERSION_UNKNOWN_STRING{" unknown"};
 const char * const FIRMWARE_VERSION_BASE_STRING{"firmware version "};
+const char * const MAXIMUM_IN_FLIGHT_COMMANDS_TOO_LOW_STRING{"Invalid maximum in flight command count passed to Arduino::setMaximumInFlightCommands(unsigned int), value must be greater than 0 ("};
+const char * const INVALID_IO_STREAM_INTERVAL_STRING{"Invalid interval passed to Arduino::subscribeIOReports(unsigned int, IOStreamMode, std::function<void(const IOReport &)>), value must be between 10 and 60000 milliseconds ("};
 const char * const IO_TRY_COUNT_TOO_LOW_STRING{"Invalid  IO try count passed to Arduino::setIOTryCount(unsigned int), value must be greater than 0 ("};
 
-int voltageToAnalog(double state)
+inline int voltageToAnalog(double state)
 {
     return (state / ANALOG_TO_VOLTAGE_SCALE_FACTOR);
 }
 
-double analogToVoltage(int state)
+inline double analogToVoltage(int state)
 {
     return state * ANALOG_TO_VOLTAGE_SCALE_FACTOR;
 }
 
-bool parseToDigitalState(const std::string &state)
+inline bool parseToDigitalState(const std::string &state)
 {
     std::string copyString{state};
     std::transform(copyString.begin(), copyString.end(), copyString.begin(), ::tolower);
@@ -421,7 +748,7 @@ bool parseToDigitalState(const std::string &state)
     throw std::runtime_error(INVALID_STATE_TO_PARSE_TO_DIGITAL_STATE_STRING + state);
 }
 
-double parseToAnalogState(const std::string &state)
+inline double parseToAnalogState(const std::string &state)
 {
     try {
         double temp{GeneralUtilities::decStringToDouble(state.c_str())};
@@ -434,7 +761,7 @@ double parseToAnalogState(const std::string &state)
     }
 }
 
-int parseToAnalogStateRaw(const std::string &state)
+inline int parseToAnalogStateRaw(const std::string &state)
 {
     try {
         int temp{GeneralUtilities::decStringToInt(state.c_str())};
@@ -447,7 +774,7 @@ int parseToAnalogStateRaw(const std::string &state)
     }
 }
 
-bool isValidDigitalStateIdentifier(const std::string &state)
+inline bool isValidDigitalStateIdentifier(const std::string &state)
 {
     std::string copyString{state};
     std::transform(copyString.begin(), copyString.end(), copyString.begin(), ::tolower);
@@ -465,7 +792,7 @@ bool isValidDigitalStateIdentifier(const std::string &state)
     return false;
 }
 
-bool isValidAnalogStateIdentifier(const std::string &state)
+inline bool isValidAnalogStateIdentifier(const std::string &state)
 {
     for (auto &it : VALID_ANALOG_STATE_IDENTIFIERS) {
         if (state == std::string(1, it)) {
@@ -475,7 +802,7 @@ bool isValidAnalogStateIdentifier(const std::string &state)
     return false;
 }
 
-bool isValidAnalogRawStateIdentifier(const std::string &state)
+inline bool isValidAnalogRawStateIdentifier(const std::string &state)
 {
     bool match{false};
     for (auto &it : state) {
@@ -492,7 +819,7 @@ bool isValidAnalogRawStateIdentifier(const std::string &state)
     return true;
 }
 
-std::string parseIOType(IOType ioType)
+inline std::string parseIOType(IOType ioType)
 {
     if (ioType == IOType::DIGITAL_INPUT) {
         return DIGITAL_INPUT_IDENTIFIER;
@@ -509,7 +836,7 @@ std::string parseIOType(IOType ioType)
     }
 }
 
-IOType parseIOTypeFromString(const std::string &ioType)
+inline IOType parseIOTypeFromString(const std::string &ioType)
 {
     if (ioType == DIGITAL_INPUT_IDENTIFIER) {
         return IOType::DIGITAL_INPUT;
@@ -528,7 +855,7 @@ IOType parseIOTypeFromString(const std::string &ioType)
 
 
 
-int parseAnalogPin(ArduinoType arduinoType, const std::string &pinAlias)
+inline int parseAnalogPin(ArduinoType arduinoType, const std::string &pinAlias)
 {
     if (arduinoType == ArduinoType::UNO) {
         if ((pinAlias == UNO_A0_STRING) || (pinAlias == UNO_A0_EQUIVALENT_STRING)) {
@@ -608,7 +935,7 @@ int parseAnalogPin(ArduinoType arduinoType, const std::string &pinAlias)
     }
 }
 
-std::string analogPinFromNumber(ArduinoType arduinoType, int pinNumber)
+inline std::string analogPinFromNumber(ArduinoType arduinoType, int pinNumber)
 {
     if (arduinoType == ArduinoType::UNO) {
         if (pinNumber == 14) {
@@ -695,20 +1022,29 @@ public:
         this->m_canMessageResults.emplace_back(result);
     }
 
-    std::vector<CanMessage> canMessageResults() const
+    const std::vector<CanMessage> &canMessageResults() const &
     {
         return this->m_canMessageResults;
     }
 
+    std::vector<CanMessage> canMessageResults() &&
+    {
+        return std::move(this->m_canMessageResults);
+    }
+
 private:
     std::vector<CanMessage> m_canMessageResults;
 };
 
+/* The eight data bytes of a CAN frame, stored inline so copying a packet (or a CanMessage
+ * holding one) never allocates */
 class CanDataPacket
 {
 public:
+    using DataBytes = std::array<unsigned char, RAW_CAN_MESSAGE_SIZE>;
+
     CanDataPacket() :
-        m_dataPacket{std::vector<unsigned char>{0, 0, 0, 0, 0, 0, 0, 0}}
+        m_dataPacket{{0, 0, 0, 0, 0, 0, 0, 0}}
     {
 
     }
@@ -717,27 +1053,35 @@ public:
                                 unsigned char third, unsigned char fourth, 
                                 unsigned char fifth, unsigned char sixth, 
                                 unsigned char seventh, unsigned char eighth) :
-        m_dataPacket{std::vector<unsigned char>{first, second, third, fourth, 
-                                                fifth, sixth, seventh, eighth}}
+        m_dataPacket{{first, second, third, fourth, 
+                      fifth, sixth, seventh, eighth}}
     {
 
     }                                            
 
-    CanDataPacket(const std::vector<unsigned char> &dataPacket) :
+    CanDataPacket(const DataBytes &dataPacket) :
         m_dataPacket(dataPacket)
     {
 
     }
 
-    CanDataPacket(const CanDataPacket &dataPacket) :
-        m_dataPacket{dataPacket.m_dataPacket}
+    CanDataPacket(const std::vector<unsigned char> &dataPacket) :
+        m_dataPacket{{0, 0, 0, 0, 0, 0, 0, 0}}
     {
+        this->setDataPacket(dataPacket);
+    }
 
+    void setDataPacket(const DataBytes &dataPacket)
+    {
+        this->m_dataPacket = dataPacket;
     }
 
+    //Bytes beyond the eighth are ignored, missing ones are zeroed
     void setDataPacket(const std::vector<unsigned char> &dataPacket)
     {
-        this->m_dataPacket = dataPacket;
+        for (size_t i = 0; i < this->m_dataPacket.size(); i++) {
+            this->m_dataPacket[i] = ((i < dataPacket.size()) ? dataPacket[i] : 0);
+        }
     }
 
     void setDataPacket(unsigned char first, unsigned char second, 
@@ -745,67 +1089,52 @@ public:
                                     unsigned char fifth, unsigned char sixth, 
                                     unsigned char seventh, unsigned char eighth)
     {
-        this->m_dataPacket = std::vector<unsigned char>{first, second, third, fourth,
-                                                        fifth, sixth, seventh, eighth};
+        this->m_dataPacket = DataBytes{{first, second, third, fourth,
+                                        fifth, sixth, seventh, eighth}};
     }                         
 
     bool setNthByte(int index, unsigned char nth)
     {
-        if ((index >= 0) && (index < 8)) {
-            this->m_dataPacket.at(index) = nth;
+        if ((index >= 0) && (index < static_cast<int>(this->m_dataPacket.size()))) {
+            this->m_dataPacket[index] = nth;
             return true;
         } else {
             return false;
         }
     }
 
-    unsigned char nthByte(int index)
+    unsigned char nthByte(int index) const
     {
         return this->m_dataPacket.at(index);
     }
 
     void toBasicArray(unsigned char copyArray[8]) const
     {
-        int i = 0;
-        for (auto &it : this->m_dataPacket) {
-            copyArray[i++] = it;
-        }
+        std::copy(this->m_dataPacket.begin(), this->m_dataPacket.end(), copyArray);
     }
 
-    std::vector<unsigned char> dataPacket() const
+    const DataBytes &dataPacket() const
     {
-        return m_dataPacket;
+        return this->m_dataPacket;
     }
 
     CanDataPacket combineDataPackets(const CanDataPacket &first, const CanDataPacket &second)
     {
-        std::vector<unsigned char> constructorArg;
-        std::vector<unsigned char> firstCopy = first.dataPacket();
-        std::vector<unsigned char> secondCopy = second.dataPacket();
-        std::vector<unsigned char>::const_iterator firstIter = firstCopy.begin();
-        std::vector<unsigned char>::const_iterator secondIter = secondCopy.begin();
-        while (firstIter != firstCopy.end()) {
-            constructorArg.push_back((*firstIter++) | (*secondIter++));
+        CanDataPacket combined;
+        for (size_t i = 0; i < combined.m_dataPacket.size(); i++) {
+            combined.m_dataPacket[i] = (first.m_dataPacket[i] | second.m_dataPacket[i]);
         }
-        return CanDataPacket(constructorArg);
+        return combined;
     }
 
     friend bool operator==(const CanDataPacket &lhs, const CanDataPacket &rhs)
     {
-        if (lhs.m_dataPacket.size() != rhs.m_dataPacket.size()) {
-            return false;
-        }
-        for (unsigned int i = 0; i < lhs.m_dataPacket.size(); i++) {
-            if (lhs.m_dataPacket.at(i) != rhs.m_dataPacket.at(i)) {
-                return false;
-            }
-        }
-        return true;
+        return (lhs.m_dataPacket == rhs.m_dataPacket);
     }
 
 
 private:
-    std::vector<unsigned char> m_dataPacket;
+    DataBytes m_dataPacket;
 
 };
 
@@ -878,7 +1207,7 @@ public:
         return this->m_dataPacket.setNthByte(index, nth);
     }
 
-    CanDataPacket dataPacket() const
+    const CanDataPacket &dataPacket() const
     {
         return this->m_dataPacket;
     }
@@ -958,15 +1287,8 @@ public:
 
     friend bool operator==(const CanMessage &lhs, const CanMessage &rhs)
     {
-        if (lhs.m_dataPacket.dataPacket().size() != lhs.m_dataPacket.dataPacket().size()) {
-            return false;
-        }
-        for (unsigned int i = 0; i < lhs.m_dataPacket.dataPacket().size(); i++) {
-            if (lhs.m_dataPacket.dataPacket().at(i) != rhs.m_dataPacket.dataPacket().at(i)) {
-                return false;
-            }
-        }
-        return ((lhs.m_id == rhs.m_id) &&
+        return ((lhs.m_dataPacket == rhs.m_dataPacket) &&
+                (lhs.m_id == rhs.m_id) &&
                 (lhs.m_frame == rhs.m_frame) &&
                 (lhs.m_length == rhs.m_length));
     }
@@ -987,6 +1309,9 @@ private:
     static const char *NTH_DATA_PACKET_BYTE_INDEX_OUT_OF_RANGE_STRING;
 };
 
+//Streamed frames are copied through a ring buffer, which has to stay allocation free
+static_assert(std::is_trivially_copyable<CanMessage>::value, "CanMessage must stay trivially copyable");
+
 /*
 
 class LinDataPacket
@@ -0,0 +1,114 @@
+#ifndef ARDUINOPC_ARDUINOMANAGER_H
+#define ARDUINOPC_ARDUINOMANAGER_H
+
+#include <string>
+#include <utility>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <functional>
+#include <map>
+#include <vector>
+#include <stdexcept>
+
+#include "arduino.h"
+
+/* Owns a set of Arduino devices (keyed by serial port name) and gives each one a dispatch thread.
+ * Work queued for a board runs in order on that board's thread, while different boards run in
+ * parallel, so a rack wide request takes roughly one link latency instead of one per board */
+class ArduinoManager
+{
+public:
+    ArduinoManager();
+    ~ArduinoManager();
+    ArduinoManager(const ArduinoManager &) = delete;
+    ArduinoManager &operator=(const ArduinoManager &) = delete;
+
+    bool addArduino(std::shared_ptr<Arduino> arduino);
+    size_t connectArduinos(const std::vector<std::pair<ArduinoType, std::shared_ptr<TStream>>> &ioStreams);
+    bool removeArduino(const std::string &serialPortName);
+    std::shared_ptr<Arduino> arduino(const std::string &serialPortName) const;
+    std::vector<std::string> serialPortNames() const;
+    size_t size() const;
+
+    template <typename T>
+    std::future<T> dispatchTo(const std::string &serialPortName, std::function<T(Arduino &)> task)
+    {
+        std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+        auto found = this->m_boards.find(serialPortName);
+        if (found == this->m_boards.end()) {
+            throw std::runtime_error(NO_ARDUINO_ON_PORT_STRING + serialPortName);
+        }
+        return found->second->enqueue(task);
+    }
+
+    template <typename T>
+    std::map<std::string, std::future<T>> dispatch(std::function<T(Arduino &)> task)
+    {
+        std::map<std::string, std::future<T>> futures;
+        std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+        for (auto &it : this->m_boards) {
+            futures.emplace(it.first, it.second->enqueue(task));
+        }
+        return futures;
+    }
+
+    template <typename T>
+    std::map<std::string, T> dispatchAndWait(std::function<T(Arduino &)> task)
+    {
+        std::map<std::string, std::future<T>> futures{this->dispatch(task)};
+        std::map<std::string, T> results;
+        for (auto &it : futures) {
+            results.emplace(it.first, it.second.get());
+        }
+        return results;
+    }
+
+    std::map<std::string, std::pair<IOStatus, bool>> digitalRead(int pinNumber);
+    std::map<std::string, std::pair<IOStatus, bool>> digitalWrite(int pinNumber, bool state);
+    std::map<std::string, std::pair<IOStatus, std::vector<int>>> digitalWriteAll(bool state);
+    std::map<std::string, std::pair<IOStatus, int>> analogReadRaw(int pinNumber);
+    std::map<std::string, IOReport> ioReportRequest();
+    std::map<std::string, std::pair<IOStatus, std::string>> firmwareVersion();
+
+private:
+    class BoardWorker
+    {
+    public:
+        BoardWorker(std::shared_ptr<Arduino> arduino);
+        ~BoardWorker();
+
+        std::shared_ptr<Arduino> arduino() const;
+
+        template <typename T>
+        std::future<T> enqueue(std::function<T(Arduino &)> task)
+        {
+            std::shared_ptr<std::packaged_task<T()>> packagedTask{std::make_shared<std::packaged_task<T()>>(std::bind(task, std::ref(*this->m_arduino)))};
+            std::future<T> future{packagedTask->get_future()};
+            std::lock_guard<std::mutex> taskLock{this->m_taskMutex};
+            this->m_tasks.emplace_back([packagedTask]() { (*packagedTask)(); });
+            this->m_taskCondition.notify_one();
+            return future;
+        }
+
+    private:
+        std::shared_ptr<Arduino> m_arduino;
+        std::mutex m_taskMutex;
+        std::condition_variable m_taskCondition;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_running;
+        std::thread m_thread;
+
+        void run();
+    };
+
+    mutable std::mutex m_boardsMutex;
+    std::map<std::string, std::unique_ptr<BoardWorker>> m_boards;
+
+    static const char *NO_ARDUINO_ON_PORT_STRING;
+};
+
+#endif //ARDUINOPC_ARDUINOMANAGER_H
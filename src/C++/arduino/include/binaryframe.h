@@ -0,0 +1,41 @@
+#ifndef ARDUINOPC_BINARYFRAME_H
+#define ARDUINOPC_BINARYFRAME_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/* Host side of the firmware's binary framing (firmware/lib/BinaryFrame), all multi byte values little endian:
+ *   [SYNC][OPCODE][LENGTH][PAYLOAD (LENGTH bytes)][CRC8]
+ * The CRC (polynomial 0x07, initial value 0) covers OPCODE, LENGTH and PAYLOAD,
+ * and responses use the request opcode with RESPONSE_FLAG set */
+namespace BinaryFrame
+{
+    enum Opcode : uint8_t
+    {
+        DIGITAL_READ = 0x01,
+        DIGITAL_WRITE = 0x02,
+        ANALOG_READ = 0x03,
+        ANALOG_WRITE = 0x04,
+        SOFT_DIGITAL_READ = 0x05,
+        SOFT_ANALOG_READ = 0x06,
+        INVALID_OPCODE = 0x7F
+    };
+
+    enum FrameOffset { SYNC_OFFSET, OPCODE_OFFSET, LENGTH_OFFSET, PAYLOAD_OFFSET };
+
+    const uint8_t SYNC{0xA5};
+    const uint8_t RESPONSE_FLAG{0x80};
+    const size_t HEADER_SIZE{3};
+    const size_t CRC_SIZE{1};
+    const size_t MAXIMUM_PAYLOAD{32};
+
+    uint8_t crc8(const uint8_t *data, size_t length, uint8_t crc = 0);
+    std::string encode(uint8_t opcode, const std::vector<uint8_t> &payload);
+    bool extractFrame(std::string &buffer, uint8_t *opcode, std::vector<uint8_t> *payload);
+    void appendUInt16(std::vector<uint8_t> &out, uint16_t value);
+    uint16_t getUInt16(const uint8_t *in);
+}
+
+#endif //ARDUINOPC_BINARYFRAME_H
@@ -0,0 +1,196 @@
+#ifndef ARDUINOPC_BUSCAPTURE_H
+#define ARDUINOPC_BUSCAPTURE_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <chrono>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+#include "arduino.h"
+#include "ringbuffer.h"
+
+/* Capture file layout. Everything is fixed size and naturally aligned, so a file can be mapped
+ * into memory and used as an array of records directly:
+ *     BusCaptureFileHeader     32 bytes
+ *     BusCaptureRecord[n]      24 bytes each, in timestamp order
+ * Records are only ever appended, and a record cut short by a crash is overwritten by the next
+ * writer that opens the file. Both are stored in the writer's byte order, which the header's
+ * byte order mark lets a reader check */
+enum class CaptureBus : uint8_t { CAN, LIN };
+
+const uint8_t BUS_CAPTURE_TRANSMITTED{0x01};
+const uint8_t BUS_CAPTURE_EXTENDED_ID{0x02};
+
+struct BusCaptureFileHeader
+{
+    char magic[8];
+    uint32_t byteOrderMark;
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t startTime; //Microseconds since the Unix epoch when the capture was created
+    uint64_t reserved;
+};
+
+struct BusCaptureRecord
+{
+    uint64_t timestamp; //Microseconds since the header's startTime
+    uint32_t id;
+    uint8_t bus;
+    uint8_t flags;
+    uint8_t length;
+    uint8_t reserved;
+    uint8_t data[8];
+};
+
+static_assert(sizeof(BusCaptureFileHeader) == 32, "BusCaptureFileHeader must stay 32 bytes");
+static_assert(sizeof(BusCaptureRecord) == 24, "BusCaptureRecord must stay 24 bytes");
+static_assert(std::is_trivially_copyable<BusCaptureRecord>::value, "BusCaptureRecord must be trivially copyable");
+
+const size_t BUS_CAPTURE_RING_SIZE{4096};
+const size_t BUS_CAPTURE_BATCH_SIZE{256};
+const unsigned int BUS_CAPTURE_WRITE_INTERVAL{10};
+const long BUS_CAPTURE_REPLAY_DEFAULT_TIMEOUT{100};
+const size_t BUS_CAPTURE_CAN_READ_FRAME_SIZE{80};
+
+const char * const BUS_CAPTURE_MAGIC{"ARDPCCAP"};
+const uint32_t BUS_CAPTURE_BYTE_ORDER_MARK{0x01020304};
+const uint16_t BUS_CAPTURE_VERSION{1};
+const char * const BUS_CAPTURE_REPLAY_FIRMWARE_VERSION{"replay"};
+const char * const BUS_CAPTURE_REPLAY_PORT_NAME_PREFIX{"replay:"};
+const char * const BUS_CAPTURE_OPEN_FAILED_STRING{"Unable to open bus capture file "};
+const char * const BUS_CAPTURE_INVALID_FILE_STRING{"Not a bus capture file (or written with a different byte order or version): "};
+const char * const BUS_CAPTURE_NO_READER_STRING{"BusCaptureReplayStream needs a BusCaptureReader"};
+
+/* Appends frames to a capture file without doing any file IO on the caller's thread: capture()
+ * stamps the frame and pushes it into a ring, and a writer thread drains the ring to disk in
+ * batches. If the disk falls behind far enough to fill the ring, frames are dropped and counted */
+class BusCaptureWriter
+{
+public:
+    BusCaptureWriter(const std::string &filePath);
+    ~BusCaptureWriter();
+    BusCaptureWriter(const BusCaptureWriter &) = delete;
+    BusCaptureWriter &operator=(const BusCaptureWriter &) = delete;
+
+    bool captureCanMessage(const CanMessage &message, bool transmitted);
+    bool capture(CaptureBus bus, uint32_t id, uint8_t flags, const uint8_t *data, uint8_t length);
+    void flush();
+
+    std::string filePath() const;
+    uint64_t startTime() const;
+    uint64_t captured() const;
+    uint64_t dropped() const;
+
+private:
+    std::string m_filePath;
+    std::fstream m_file;
+    uint64_t m_startTime;
+    uint64_t m_timestampOffset;
+    std::chrono::steady_clock::time_point m_openTime;
+    std::unique_ptr<RingBuffer<BusCaptureRecord, BUS_CAPTURE_RING_SIZE>> m_records;
+    std::mutex m_producerMutex;
+    std::mutex m_fileMutex;
+    std::array<BusCaptureRecord, BUS_CAPTURE_BATCH_SIZE> m_batch;
+    std::mutex m_runMutex;
+    std::condition_variable m_runCondition;
+    bool m_running;
+    std::atomic<uint64_t> m_captured;
+    std::atomic<uint64_t> m_dropped;
+    std::thread m_writerThread;
+
+    void run();
+    size_t drain();
+};
+
+/* Reads a capture file. Records are fixed size and sorted by timestamp, so seek() finds a time
+ * with a binary search over the file (O(log n) reads) and needs no separate index */
+class BusCaptureReader
+{
+public:
+    BusCaptureReader(const std::string &filePath);
+    BusCaptureReader(const BusCaptureReader &) = delete;
+    BusCaptureReader &operator=(const BusCaptureReader &) = delete;
+
+    std::string filePath() const;
+    uint64_t startTime() const;
+    uint64_t size() const;
+    void refresh();
+    bool read(uint64_t index, BusCaptureRecord *record);
+    size_t read(uint64_t index, BusCaptureRecord *records, size_t maximumRecords);
+    uint64_t seek(uint64_t timestamp);
+
+private:
+    std::string m_filePath;
+    std::ifstream m_file;
+    BusCaptureFileHeader m_header;
+    uint64_t m_size;
+};
+
+/* A simulated board that plays a capture back over the TStream interface, so an Arduino (or
+ * anything else reading a TStream) sees the recorded CAN traffic as if it were arriving live.
+ * Received CAN frames become due at their recorded time divided by speed (0 plays everything
+ * at once); transmitted frames and LIN frames are skipped. It answers the version probe, CAN
+ * live update and CAN read requests the way the firmware does and ignores everything else */
+class BusCaptureReplayStream : public TStream
+{
+public:
+    BusCaptureReplayStream(std::shared_ptr<BusCaptureReader> reader, double speed);
+    BusCaptureReplayStream(const BusCaptureReplayStream &) = delete;
+    BusCaptureReplayStream &operator=(const BusCaptureReplayStream &) = delete;
+
+    void seek(uint64_t timestamp);
+    double speed() const;
+    bool finished();
+
+    ssize_t writeLine(const std::string &str) override;
+    ssize_t writeString(const std::string &str) override;
+    std::string readLine(bool *timeout = nullptr) override;
+    std::string readUntil(const std::string &until, bool *timeout = nullptr) override;
+    std::string readUntil(char until, bool *timeout = nullptr) override;
+    std::string readString(int maximumSize = -1) override;
+    int available() override;
+    void openPort() override;
+    void closePort() override;
+    bool isOpen() const override;
+    std::string portName() const override;
+    void setTimeout(long timeout) override;
+    long timeout() const override;
+    void setLineEnding(const std::string &lineEnding) override;
+    std::string lineEnding() const override;
+    void flushRx() override;
+
+private:
+    std::shared_ptr<BusCaptureReader> m_reader;
+    double m_speed;
+    mutable std::mutex m_replayMutex;
+    std::condition_variable m_replayCondition;
+    bool m_isOpen;
+    long m_timeout;
+    std::string m_lineEnding;
+    bool m_liveUpdate;
+    std::string m_output;
+    uint64_t m_nextIndex;
+    uint64_t m_firstTimestamp;
+    std::chrono::steady_clock::time_point m_replayStart;
+    std::array<BusCaptureRecord, BUS_CAPTURE_BATCH_SIZE> m_readAhead;
+    uint64_t m_readAheadIndex;
+    size_t m_readAheadSize;
+
+    bool nextReplayableRecord(BusCaptureRecord *record);
+    bool nextDueFrame(std::chrono::steady_clock::time_point now, std::string *frame);
+    std::chrono::steady_clock::time_point dueTime(const BusCaptureRecord &record) const;
+    void pumpLiveUpdates(std::chrono::steady_clock::time_point now);
+    void handleCommand(const std::string &command);
+    std::string readUntilMatch(const std::string &until, bool *timeout);
+
+    static std::string canReadFrame(const BusCaptureRecord &record);
+};
+
+#endif //ARDUINOPC_BUSCAPTURE_H
@@ -0,0 +1,66 @@
+#ifndef ARDUINOPC_CANFILTER_H
+#define ARDUINOPC_CANFILTER_H
+
+#include <set>
+#include <vector>
+#include <bitset>
+#include <unordered_set>
+#include <utility>
+#include <cstdint>
+
+#include "arduino.h"
+
+const uint32_t MAXIMUM_STANDARD_CAN_ID{0x7FF};
+const uint32_t MAXIMUM_EXTENDED_CAN_ID{0x1FFFFFFF};
+
+/* Host side CAN acceptance filter, with the same semantics as the firmware's mask lists: a frame
+ * passes if it matches no NEGATIVE rule and, when there are any POSITIVE rules, at least one of
+ * those. A rule is an exact ID, an inclusive ID range or a mask/value pair ((id & mask) == value).
+ * Every change recompiles the rules into an index: standard (11 bit) IDs get a bitmap over the
+ * whole ID space, so checking one is a single bit test, while extended (29 bit) IDs go through a
+ * hash set of exact IDs, a sorted list of merged ranges (binary search) and then the mask pairs */
+class CanFilter
+{
+public:
+    CanFilter();
+
+    bool addID(CanMaskType canMaskType, uint32_t id);
+    bool addRange(CanMaskType canMaskType, uint32_t low, uint32_t high);
+    bool addMask(CanMaskType canMaskType, uint32_t mask, uint32_t value);
+    bool removeID(CanMaskType canMaskType, uint32_t id);
+    void clear(CanMaskType canMaskType);
+    void clear();
+
+    bool accepts(uint32_t id) const;
+    bool empty() const;
+    bool hasOnlyIDs() const;
+    std::vector<uint32_t> ids(CanMaskType canMaskType) const;
+
+private:
+    class RuleSet
+    {
+    public:
+        RuleSet();
+
+        std::set<uint32_t> m_ids;
+        std::vector<std::pair<uint32_t, uint32_t>> m_ranges;
+        std::vector<std::pair<uint32_t, uint32_t>> m_masks;
+
+        bool empty() const;
+        bool matches(uint32_t id) const;
+        void compile();
+
+    private:
+        std::bitset<MAXIMUM_STANDARD_CAN_ID + 1> m_standardIDs;
+        std::unordered_set<uint32_t> m_extendedIDs;
+        std::vector<std::pair<uint32_t, uint32_t>> m_extendedRanges;
+    };
+
+    RuleSet m_positive;
+    RuleSet m_negative;
+
+    RuleSet &ruleSet(CanMaskType canMaskType);
+    const RuleSet &ruleSet(CanMaskType canMaskType) const;
+};
+
+#endif //ARDUINOPC_CANFILTER_H
@@ -0,0 +1,78 @@
+#ifndef ARDUINOPC_IOMETRICS_H
+#define ARDUINOPC_IOMETRICS_H
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+/* Log-linear latency histogram in the style of HdrHistogram: values below SUB_BUCKET_COUNT
+ * microseconds are counted exactly, above that each power of two is split into
+ * SUB_BUCKET_COUNT / 2 buckets, so any recorded value is within 1 / 16 (about 6%) of the
+ * value reported for it. Values beyond MAXIMUM_VALUE are clamped to it */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void record(uint64_t microseconds);
+    void reset();
+
+    uint64_t count() const;
+    uint64_t minimum() const;
+    uint64_t maximum() const;
+    double mean() const;
+    uint64_t valueAtPercentile(double percentile) const;
+
+    static const unsigned int SUB_BUCKET_BITS{5};
+    static const unsigned int MAXIMUM_VALUE_BITS{36};
+    static const uint64_t SUB_BUCKET_COUNT{1u << SUB_BUCKET_BITS};
+    static const uint64_t MAXIMUM_VALUE{(static_cast<uint64_t>(1) << MAXIMUM_VALUE_BITS) - 1};
+    static const size_t BUCKET_COUNT{SUB_BUCKET_COUNT + ((MAXIMUM_VALUE_BITS - SUB_BUCKET_BITS) * (SUB_BUCKET_COUNT / 2))};
+
+private:
+    uint64_t m_counts[BUCKET_COUNT];
+    uint64_t m_count;
+    uint64_t m_minimum;
+    uint64_t m_maximum;
+    double m_sum;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t highestEquivalentValue(size_t index);
+};
+
+/* Counters for one command header. An exchange is one request written and its reply (or
+ * timeout) read back, a call is the first exchange of a request loop and a retry any further one */
+struct IOCommandMetrics
+{
+    uint64_t calls{0};
+    uint64_t retries{0};
+    uint64_t exchanges{0};
+    uint64_t timeouts{0};
+    uint64_t bytesSent{0};
+    uint64_t bytesReceived{0};
+    LatencyHistogram latency{};
+};
+
+class IOMetrics
+{
+public:
+    IOMetrics();
+
+    void recordAttempt(const std::string &header, int attempt);
+    void recordExchange(const std::string &header, size_t bytesSent, size_t bytesReceived, std::chrono::steady_clock::duration latency, bool timedOut);
+    void recordUnsolicited(const std::string &header, size_t bytesReceived);
+    void reset();
+
+    std::map<std::string, IOCommandMetrics> snapshot() const;
+    IOCommandMetrics snapshot(const std::string &header) const;
+    std::string toString() const;
+
+private:
+    mutable std::mutex m_metricsMutex;
+    std::map<std::string, IOCommandMetrics> m_commandMetrics;
+};
+
+#endif //ARDUINOPC_IOMETRICS_H
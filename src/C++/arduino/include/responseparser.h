@@ -0,0 +1,236 @@
+#ifndef ARDUINOPC_RESPONSEPARSER_H
+#define ARDUINOPC_RESPONSEPARSER_H
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <stdexcept>
+
+/* Non-owning view of one field of a response frame (the C++14 stand-in for std::string_view).
+ * Numeric conversions work directly on the characters, no temporary strings are created */
+class FieldView
+{
+public:
+    FieldView() :
+        m_data{nullptr},
+        m_length{0}
+    {
+
+    }
+
+    FieldView(const char *data, size_t length) :
+        m_data{data},
+        m_length{length}
+    {
+
+    }
+
+    const char *data() const
+    {
+        return this->m_data;
+    }
+
+    size_t length() const
+    {
+        return this->m_length;
+    }
+
+    bool empty() const
+    {
+        return (this->m_length == 0);
+    }
+
+    std::string toString() const
+    {
+        return std::string{this->m_data, this->m_length};
+    }
+
+    bool toInt(int *out) const
+    {
+        size_t i{0};
+        bool negative{false};
+        if ((this->m_length > 0) && ((this->m_data[0] == '-') || (this->m_data[0] == '+'))) {
+            negative = (this->m_data[0] == '-');
+            i++;
+        }
+        if (i == this->m_length) {
+            return false;
+        }
+        long long value{0};
+        for ( ; i < this->m_length; i++) {
+            if ((this->m_data[i] < '0') || (this->m_data[i] > '9')) {
+                return false;
+            }
+            value = (value * 10) + (this->m_data[i] - '0');
+            if (value > INT_MAX) {
+                return false;
+            }
+        }
+        *out = static_cast<int>(negative ? -value : value);
+        return true;
+    }
+
+    bool toHexUInt(uint32_t *out) const
+    {
+        size_t i{0};
+        if ((this->m_length > 2) && (this->m_data[0] == '0') && ((this->m_data[1] == 'x') || (this->m_data[1] == 'X'))) {
+            i = 2;
+        }
+        if ((i == this->m_length) || (this->m_length - i > 8)) {
+            return false;
+        }
+        uint32_t value{0};
+        for ( ; i < this->m_length; i++) {
+            char c{this->m_data[i]};
+            uint32_t nibble{0};
+            if ((c >= '0') && (c <= '9')) {
+                nibble = c - '0';
+            } else if ((c >= 'a') && (c <= 'f')) {
+                nibble = c - 'a' + 10;
+            } else if ((c >= 'A') && (c <= 'F')) {
+                nibble = c - 'A' + 10;
+            } else {
+                return false;
+            }
+            value = (value << 4) | nibble;
+        }
+        *out = value;
+        return true;
+    }
+
+    bool toDouble(double *out) const
+    {
+        char buffer[MAXIMUM_DOUBLE_LENGTH];
+        if ((this->m_length == 0) || (this->m_length >= MAXIMUM_DOUBLE_LENGTH)) {
+            return false;
+        }
+        memcpy(buffer, this->m_data, this->m_length);
+        buffer[this->m_length] = '\0';
+        char *end{nullptr};
+        *out = strtod(buffer, &end);
+        return (end == buffer + this->m_length);
+    }
+
+    friend bool operator==(const FieldView &lhs, const char *rhs)
+    {
+        return ((strlen(rhs) == lhs.m_length) && (memcmp(lhs.m_data, rhs, lhs.m_length) == 0));
+    }
+
+    friend bool operator!=(const FieldView &lhs, const char *rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator==(const FieldView &lhs, const std::string &rhs)
+    {
+        return ((rhs.length() == lhs.m_length) && (memcmp(lhs.m_data, rhs.data(), lhs.m_length) == 0));
+    }
+
+    friend bool operator!=(const FieldView &lhs, const std::string &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    const char *m_data;
+    size_t m_length;
+
+    static const size_t MAXIMUM_DOUBLE_LENGTH{32};
+};
+
+/* Fixed capacity field array for one response frame. The frame text is moved in and owned
+ * here, so the views stay valid for as long as the ResponseFields object does, and reusing
+ * the same object across retries reuses its storage */
+template <size_t Capacity>
+class ResponseFields
+{
+public:
+    ResponseFields() :
+        m_frame{""},
+        m_size{0}
+    {
+
+    }
+
+    ResponseFields(const ResponseFields &) = delete;
+    ResponseFields &operator=(const ResponseFields &) = delete;
+
+    size_t size() const
+    {
+        return this->m_size;
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+    const FieldView &at(size_t index) const
+    {
+        if (index >= this->m_size) {
+            throw std::out_of_range("ResponseFields::at(size_t): index (" + std::to_string(index) + ") >= size (" + std::to_string(this->m_size) + ")");
+        }
+        return this->m_fields[index];
+    }
+
+    const FieldView &operator[](size_t index) const
+    {
+        return this->m_fields[index];
+    }
+
+    const std::string &frame() const
+    {
+        return this->m_frame;
+    }
+
+    /* Takes ownership of frame and splits the text between "header:" and the terminator on
+     * separator. Returns false if the frame does not carry header, is not terminated, or
+     * has more than Capacity fields */
+    bool parse(std::string &&frame, const std::string &header, char separator, char terminator, char lineEnding)
+    {
+        this->m_frame = std::move(frame);
+        this->m_size = 0;
+        size_t end{this->m_frame.length()};
+        if ((end > 0) && (this->m_frame[end - 1] == lineEnding)) {
+            end--;
+        }
+        if ((end == 0) || (this->m_frame[end - 1] != terminator)) {
+            return false;
+        }
+        end--;
+        if ((end < header.length()) || (this->m_frame.compare(0, header.length(), header) != 0)) {
+            return false;
+        }
+        size_t position{header.length()};
+        if (position == end) {
+            return true;
+        }
+        if (this->m_frame[position] != separator) {
+            return false;
+        }
+        position++;
+        const char *data{this->m_frame.data()};
+        while (true) {
+            const void *found{memchr(data + position, separator, end - position)};
+            size_t fieldEnd{found ? static_cast<size_t>(static_cast<const char *>(found) - data) : end};
+            if (this->m_size == Capacity) {
+                return false;
+            }
+            this->m_fields[this->m_size++] = FieldView{data + position, fieldEnd - position};
+            if (fieldEnd == end) {
+                return true;
+            }
+            position = fieldEnd + 1;
+        }
+    }
+
+private:
+    std::string m_frame;
+    FieldView m_fields[Capacity];
+    size_t m_size;
+};
+
+#endif //ARDUINOPC_RESPONSEPARSER_H
@@ -0,0 +1,77 @@
+#ifndef ARDUINOPC_RINGBUFFER_H
+#define ARDUINOPC_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+/* Bounded single producer, single consumer queue. Neither side ever blocks or takes a lock: the
+ * producer only writes m_head and the consumer only writes m_tail, and each publishes its slot
+ * with a release store that the other side picks up with an acquire load. One slot is always
+ * left empty to tell a full ring from an empty one, so it holds at most Capacity - 1 items */
+template <typename T, size_t Capacity>
+class RingBuffer
+{
+    static_assert(Capacity >= 2, "RingBuffer needs room for at least one item");
+
+public:
+    RingBuffer() :
+        m_head{0},
+        m_tail{0}
+    {
+
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    //Producer side. Returns false (dropping item) if the ring is full
+    bool tryPush(const T &item)
+    {
+        size_t head{this->m_head.load(std::memory_order_relaxed)};
+        size_t next{(head + 1) % Capacity};
+        if (next == this->m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        this->m_items[head] = item;
+        this->m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //Consumer side. Returns false if the ring is empty
+    bool tryPop(T *item)
+    {
+        size_t tail{this->m_tail.load(std::memory_order_relaxed)};
+        if (tail == this->m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        *item = this->m_items[tail];
+        this->m_tail.store((tail + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+    //Consumer side. Drops everything currently queued
+    void clear()
+    {
+        this->m_tail.store(this->m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    //Only a snapshot while the other side is active
+    size_t size() const
+    {
+        size_t head{this->m_head.load(std::memory_order_acquire)};
+        size_t tail{this->m_tail.load(std::memory_order_acquire)};
+        return ((head + Capacity - tail) % Capacity);
+    }
+
+    static constexpr size_t capacity()
+    {
+        return Capacity - 1;
+    }
+
+private:
+    T m_items[Capacity];
+    std::atomic<size_t> m_head;
+    std::atomic<size_t> m_tail;
+};
+
+#endif //ARDUINOPC_RINGBUFFER_H
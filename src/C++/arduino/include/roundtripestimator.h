@@ -0,0 +1,115 @@
+#ifndef ARDUINOPC_ROUNDTRIPESTIMATOR_H
+#define ARDUINOPC_ROUNDTRIPESTIMATOR_H
+
+#include <mutex>
+#include <cmath>
+#include <algorithm>
+
+/* Response deadline estimation for one link, following TCP's retransmission timer (RFC 6298):
+ *   SRTT   <- (1 - 1/8) * SRTT + 1/8 * R
+ *   RTTVAR <- (1 - 1/4) * RTTVAR + 1/4 * |SRTT - R|
+ *   RTO     = SRTT + max(G, 4 * RTTVAR), clamped to [minimum, maximum]
+ * A timeout doubles the RTO until the next valid sample, and (Karn's algorithm) the sample taken
+ * right after a timeout is discarded, since it may have matched the late reply to the earlier
+ * request. Until the first sample arrives the caller's initial (configured) deadline is used.
+ * All times are in milliseconds */
+class RoundTripEstimator
+{
+public:
+    RoundTripEstimator(double minimum, double maximum) :
+        m_estimatorMutex{},
+        m_minimum{minimum},
+        m_maximum{maximum},
+        m_smoothedRoundTripTime{0.00},
+        m_roundTripTimeVariation{0.00},
+        m_backoff{1},
+        m_hasSample{false},
+        m_discardNextSample{false}
+    {
+
+    }
+
+    void addSample(double roundTripTime)
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        if (this->m_discardNextSample) {
+            this->m_discardNextSample = false;
+            return;
+        }
+        if (!this->m_hasSample) {
+            this->m_smoothedRoundTripTime = roundTripTime;
+            this->m_roundTripTimeVariation = roundTripTime / 2.00;
+            this->m_hasSample = true;
+        } else {
+            this->m_roundTripTimeVariation = ((1.00 - BETA) * this->m_roundTripTimeVariation) + (BETA * std::fabs(this->m_smoothedRoundTripTime - roundTripTime));
+            this->m_smoothedRoundTripTime = ((1.00 - ALPHA) * this->m_smoothedRoundTripTime) + (ALPHA * roundTripTime);
+        }
+        this->m_backoff = 1;
+    }
+
+    void addTimeout()
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        this->m_discardNextSample = true;
+        if (this->m_backoff < MAXIMUM_BACKOFF) {
+            this->m_backoff *= 2;
+        }
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        this->m_smoothedRoundTripTime = 0.00;
+        this->m_roundTripTimeVariation = 0.00;
+        this->m_backoff = 1;
+        this->m_hasSample = false;
+        this->m_discardNextSample = false;
+    }
+
+    bool hasSample() const
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        return this->m_hasSample;
+    }
+
+    double smoothedRoundTripTime() const
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        return this->m_smoothedRoundTripTime;
+    }
+
+    double roundTripTimeVariation() const
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        return this->m_roundTripTimeVariation;
+    }
+
+    double timeout(double initialTimeout) const
+    {
+        std::lock_guard<std::mutex> estimatorLock{this->m_estimatorMutex};
+        double base{initialTimeout};
+        if (this->m_hasSample) {
+            double variation{K * this->m_roundTripTimeVariation};
+            base = this->m_smoothedRoundTripTime + ((variation > CLOCK_GRANULARITY) ? variation : CLOCK_GRANULARITY);
+        }
+        return std::min(std::max(base * this->m_backoff, this->m_minimum), this->m_maximum);
+    }
+
+private:
+    mutable std::mutex m_estimatorMutex;
+    double m_minimum;
+    double m_maximum;
+    double m_smoothedRoundTripTime;
+    double m_roundTripTimeVariation;
+    unsigned int m_backoff;
+    bool m_hasSample;
+    bool m_discardNextSample;
+
+    static constexpr double ALPHA{0.125};
+    static constexpr double BETA{0.25};
+    static constexpr double K{4.00};
+    static constexpr double CLOCK_GRANULARITY{1.00};
+    static constexpr unsigned int MAXIMUM_BACKOFF{8};
+};
+
+#endif //ARDUINOPC_ROUNDTRIPESTIMATOR_H
@@ -1,4 +1,6 @@
 #include "arduino.h"
+#include "buscapture.h"
+#include "canfilter.h"
 
 const BaudRate FIRMWARE_BAUD_RATE{BaudRate::BAUD115200};
 const DataBits FIRMWARE_DATA_BITS{DataBits::EIGHT};
@@ -13,21 +15,54 @@ Arduino::Arduino(ArduinoType arduinoType, std::shared_ptr<TStream> tStream) :
     m_arduinoType{arduinoType},
     m_ioStream{tStream},
     m_streamSendDelay{DEFAULT_IO_STREAM_SEND_DELAY},
-    m_ioTryCount{DEFAULT_IO_TRY_COUNT}
+    m_ioTryCount{DEFAULT_IO_TRY_COUNT},
+    m_ioResponseMode{DEFAULT_IO_RESPONSE_MODE},
+    m_maximumInFlightCommands{DEFAULT_MAXIMUM_IN_FLIGHT_COMMANDS},
+    m_protocolMode{ProtocolMode::ASCII},
+    m_asyncReadBuffer{""},
+    m_asyncReaderRunning{false},
+    m_asyncReaderBusy{false},
+    m_exclusiveIOWaiters{0},
+    m_ioReportsSubscribed{false},
+    m_ioReportCache{std::make_unique<IOReport>()},
+    m_ioMetrics{},
+    m_adaptiveTimeout{true},
+    m_canStreaming{false},
+    m_canMessageRing{std::make_unique<CanMessageRing>()},
+    m_canStreamReceived{0},
+    m_canStreamOverruns{0},
+    m_canStreamMalformed{0},
+    m_canStreamFiltered{0},
+    m_canFilter{std::make_unique<CanFilter>()},
+    m_busCapture{nullptr},
+    m_busCaptureMutex{},
+    m_roundTripEstimator{MINIMUM_ADAPTIVE_TIME_LIMIT, MAXIMUM_ADAPTIVE_TIME_LIMIT}
 {
+    this->m_ioStream->setLineEnding(std::string(1, FIRMWARE_LINE_ENDING));
     try {
         if (!this->m_ioStream->isOpen()) {
-            this->m_ioStream->openPort();
-            GeneralUtilities::delayMilliseconds(BOOTLOADER_BOOT_TIME);
+            this->openIOStream();
         }
     } catch (std::exception &e) {
         throw e;
     }
-    this->m_ioStream->setLineEnding(std::string{1, FIRMWARE_LINE_ENDING});
     //TODO: Validate type of Arduino
     this->assignPinsAndIdentifiers();
 }
 
+Arduino::~Arduino()
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->m_asyncReaderRunning = false;
+    this->m_ioCondition.notify_all();
+    ioLock.unlock();
+    if (this->m_asyncReaderThread.joinable()) {
+        this->m_asyncReaderThread.join();
+    }
+    ioLock.lock();
+    this->expireAsyncRequests(true);
+}
+
 void Arduino::assignPinsAndIdentifiers()
 {
    if (this->m_arduinoType == ArduinoType::UNO) {
@@ -52,7 +87,7 @@ void Arduino::assignPinsAndIdentifiers()
         this->m_identifier = ArduinoMega::IDENTIFIER;
         this->m_longName = ArduinoMega::LONG_NAME;
     }
-    for (auto &it : this->m_availablePins) {
+    for (auto &it : this->m_availablePins.pinNumbers()) {
         if (isValidAnalogInputPin(it)) {
             this->m_gpioPins.emplace(it, std::make_shared<GPIO>(it, IOType::ANALOG_INPUT));
         } else {
@@ -61,6 +96,35 @@ void Arduino::assignPinsAndIdentifiers()
     }
 }
 
+void Arduino::openIOStream()
+{
+    this->m_ioStream->openPort();
+    this->waitForFirmwareReady();
+}
+
+/* Polls the firmware version until the firmware answers, instead of always sleeping for
+ * BOOTLOADER_BOOT_TIME after opening the port. Opening the port resets most boards, in which
+ * case the probes go unanswered until the bootloader hands over to the firmware. Returns false
+ * if nothing answered within BOOTLOADER_BOOT_TIME */
+bool Arduino::waitForFirmwareReady()
+{
+    std::string stringToSend{static_cast<std::string>(FIRMWARE_VERSION_HEADER) + LINE_ENDING};
+    EventTimer eventTimer;
+    eventTimer.start();
+    while (eventTimer.totalMilliseconds() < BOOTLOADER_BOOT_TIME) {
+        this->m_ioStream->writeLine(stringToSend);
+        double timeLimit{std::min(FIRMWARE_READY_PROBE_TIME_LIMIT, BOOTLOADER_BOOT_TIME - eventTimer.totalMilliseconds())};
+        if (this->readResponseFrame(FIRMWARE_VERSION_HEADER, std::string(1, TERMINATING_CHARACTER), timeLimit) != "") {
+            //Drop the replies to any earlier probes that are still arriving
+            GeneralUtilities::delayMilliseconds(FIRMWARE_READY_PROBE_SETTLE_TIME);
+            this->m_ioStream->flushRx();
+            return true;
+        }
+        eventTimer.update();
+    }
+    return false;
+}
+
 std::string Arduino::serialPortName() const
 {
     return this->m_ioStream->portName();
@@ -96,6 +160,65 @@ void Arduino::setStreamSendDelay(unsigned int streamSendDelay)
     this->m_streamSendDelay = streamSendDelay;
 }
 
+/* While enabled, event driven and binary requests wait for the deadline estimated from the
+ * measured round trip times of this link instead of streamSendDelay + SERIAL_REPORT_REQUEST_TIME_LIMIT
+ * (which is still used until the first round trip has been measured) */
+void Arduino::setAdaptiveTimeout(bool adaptiveTimeout)
+{
+    this->m_adaptiveTimeout = adaptiveTimeout;
+}
+
+bool Arduino::adaptiveTimeout() const
+{
+    return this->m_adaptiveTimeout;
+}
+
+double Arduino::responseTimeLimit() const
+{
+    return this->timeLimitForDelay(this->m_streamSendDelay);
+}
+
+double Arduino::smoothedRoundTripTime() const
+{
+    return this->m_roundTripEstimator.smoothedRoundTripTime();
+}
+
+void Arduino::resetRoundTripEstimate()
+{
+    this->m_roundTripEstimator.reset();
+}
+
+double Arduino::timeLimitForDelay(double delay) const
+{
+    double staticTimeLimit{delay + SERIAL_REPORT_REQUEST_TIME_LIMIT};
+    return (this->m_adaptiveTimeout ? this->m_roundTripEstimator.timeout(staticTimeLimit) : staticTimeLimit);
+}
+
+IOResponseMode Arduino::ioResponseMode() const
+{
+    return this->m_ioResponseMode;
+}
+
+void Arduino::setIOResponseMode(IOResponseMode ioResponseMode)
+{
+    this->m_ioResponseMode = ioResponseMode;
+}
+
+unsigned int Arduino::maximumInFlightCommands() const
+{
+    return this->m_maximumInFlightCommands;
+}
+
+void Arduino::setMaximumInFlightCommands(unsigned int maximumInFlightCommands)
+{
+    if (maximumInFlightCommands < 1) {
+        throw std::runtime_error(MAXIMUM_IN_FLIGHT_COMMANDS_TOO_LOW_STRING + std::to_string(maximumInFlightCommands) + " < 1) ");
+    }
+    std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+    this->m_maximumInFlightCommands = maximumInFlightCommands;
+    this->m_ioCondition.notify_all();
+}
+
 
 void Arduino::setIOTryCount(unsigned int ioTryCount)
 {
@@ -105,30 +228,150 @@ void Arduino::setIOTryCount(unsigned int ioTryCount)
     this->m_ioTryCount = ioTryCount;
 }
 
-std::vector<std::string> Arduino::genericIOTask(const std::string &stringToSend, const std::string &header, double delay)
+/* Blocks on the stream until a complete frame (header ... endSequence) arrives or timeLimit
+ * milliseconds elapse, instead of sleeping for a fixed delay before reading. Complete frames
+ * received ahead of the header go to dispatchSkippedFrames, so pushed CAN frames and IO reports
+ * reach their streams, and anything else (for example a late reply to a previous, timed out
+ * request) is dropped there. Returns an empty string if no matching frame arrived in time */
+/* Hands every complete frame in skipped to dispatchAsyncResponse, as the reader thread would have
+ * done had it read them. Synchronous callers have no pipelined command outstanding, so only pushed
+ * frames are kept. The caller must hold m_ioMutex */
+void Arduino::dispatchSkippedFrames(const std::string &skipped)
 {
-    std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
-    if (!this->m_ioStream->isOpen()) {
-        this->m_ioStream->openPort();
-        GeneralUtilities::delayMilliseconds(BOOTLOADER_BOOT_TIME);
+    size_t searchStart{0};
+    size_t frameEnd{skipped.find(TERMINATING_CHARACTER)};
+    while (frameEnd != std::string::npos) {
+        size_t frameStart{skipped.rfind('{', frameEnd)};
+        if ((frameStart != std::string::npos) && (frameStart >= searchStart)) {
+            this->dispatchAsyncResponse(skipped.substr(frameStart, frameEnd - frameStart + 1));
+        }
+        searchStart = frameEnd + 1;
+        frameEnd = skipped.find(TERMINATING_CHARACTER, searchStart);
     }
-    unsigned long int tempTimeout{this->m_ioStream->timeout()};
-    this->m_ioStream->setTimeout(SERIAL_REPORT_REQUEST_TIME_LIMIT);
-    this->m_ioStream->writeLine(stringToSend);
-    GeneralUtilities::delayMilliseconds(delay);
-    std::unique_ptr<std::string> returnString{std::make_unique<std::string>("")};
+}
+
+std::string Arduino::readResponseFrame(const std::string &header, const std::string &endSequence, double timeLimit)
+{
+    long tempTimeout{this->m_ioStream->timeout()};
+    std::string received{""};
+    std::string frame{""};
     EventTimer eventTimer;
     eventTimer.start();
-    do {
-        std::string str{this->m_ioStream->readUntil(LINE_ENDING)};
-        if (str != "") {
-            *returnString = str;
+    while (eventTimer.totalMilliseconds() < timeLimit) {
+        this->m_ioStream->setTimeout(static_cast<long>(timeLimit - eventTimer.totalMilliseconds()) + 1);
+        received += this->m_ioStream->readUntil(endSequence.back());
+        eventTimer.update();
+        size_t headerPosition{received.find(header)};
+        while (headerPosition != std::string::npos) {
+            size_t afterHeader{headerPosition + header.length()};
+            //Make sure "{dwrite" does not match a "{dwriteall" frame
+            if ((afterHeader < received.length()) && (received[afterHeader] != ':') && (received.compare(afterHeader, endSequence.length(), endSequence) != 0)) {
+                headerPosition = received.find(header, afterHeader);
+                continue;
+            }
             break;
         }
-        eventTimer.update();
-    } while (eventTimer.totalMilliseconds() < this->m_ioStream->timeout());
+        if (headerPosition == std::string::npos) {
+            //Keep a possible partial frame (which may be the partial header) at the end of the buffer
+            size_t partialStart{received.rfind('{')};
+            if ((partialStart == std::string::npos) || (received.find(TERMINATING_CHARACTER, partialStart) != std::string::npos)) {
+                partialStart = received.length();
+            }
+            this->dispatchSkippedFrames(received.substr(0, partialStart));
+            received = received.substr(partialStart);
+            continue;
+        }
+        this->dispatchSkippedFrames(received.substr(0, headerPosition));
+        size_t endPosition{received.find(endSequence, headerPosition + header.length())};
+        if (endPosition != std::string::npos) {
+            frame = received.substr(headerPosition, endPosition + endSequence.length() - headerPosition);
+            break;
+        }
+        received = received.substr(headerPosition);
+    }
     this->m_ioStream->setTimeout(tempTimeout);
-    std::cout << "returnString = " << *returnString << std::endl;
+    return frame;
+}
+
+/* Pushed IO reports and the acknowledgement of an iostream request share IO_STREAM_HEADER, but only
+ * a report closes with IO_STREAM_END_IDENTIFIER. Cuts every report out of received (with the line
+ * ending after it) and hands it to dispatchAsyncResponse, as the reader thread would have done.
+ * Returns true if anything was cut out. The caller must hold m_ioMutex */
+bool Arduino::routePushedIOReports(std::string *received)
+{
+    const std::string reportEnd{":" + static_cast<std::string>(IO_STREAM_END_IDENTIFIER) + TERMINATING_CHARACTER};
+    bool routed{false};
+    size_t frameStart{received->find(IO_STREAM_HEADER)};
+    while (frameStart != std::string::npos) {
+        size_t frameEnd{received->find(TERMINATING_CHARACTER, frameStart)};
+        if (frameEnd == std::string::npos) {
+            break;
+        }
+        size_t frameLength{frameEnd + 1 - frameStart};
+        if ((frameLength < reportEnd.length()) || (received->compare(frameEnd + 1 - reportEnd.length(), reportEnd.length(), reportEnd) != 0)) {
+            frameStart = received->find(IO_STREAM_HEADER, frameEnd);
+            continue;
+        }
+        this->dispatchAsyncResponse(received->substr(frameStart, frameLength));
+        if ((frameEnd + 1 < received->length()) && ((*received)[frameEnd + 1] == LINE_ENDING)) {
+            frameLength++;
+        }
+        received->erase(frameStart, frameLength);
+        routed = true;
+        frameStart = received->find(IO_STREAM_HEADER, frameStart);
+    }
+    return routed;
+}
+
+std::string Arduino::genericIOFrameTask(const std::string &stringToSend, const std::string &header, double delay)
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->waitForExclusiveIO(ioLock);
+    if (!this->m_ioStream->isOpen()) {
+        this->openIOStream();
+    }
+    std::string returnString{""};
+    std::chrono::steady_clock::time_point sentTime{std::chrono::steady_clock::now()};
+    if (this->m_ioResponseMode == IOResponseMode::EVENT_DRIVEN) {
+        this->m_ioStream->writeLine(stringToSend);
+        double timeLimit{this->timeLimitForDelay(delay)};
+        returnString = this->readResponseFrame(header, std::string(1, TERMINATING_CHARACTER), timeLimit);
+        //While IO reports stream, an iostream acknowledgement can be preceded by reports with the same header
+        while (this->routePushedIOReports(&returnString) && (returnString == "")) {
+            double elapsed{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sentTime).count()};
+            returnString = this->readResponseFrame(header, std::string(1, TERMINATING_CHARACTER), timeLimit - elapsed);
+        }
+        if (returnString == "") {
+            this->m_roundTripEstimator.addTimeout();
+        } else {
+            this->m_roundTripEstimator.addSample(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sentTime).count());
+        }
+    } else {
+        long tempTimeout{this->m_ioStream->timeout()};
+        this->m_ioStream->setTimeout(SERIAL_REPORT_REQUEST_TIME_LIMIT);
+        this->m_ioStream->writeLine(stringToSend);
+        GeneralUtilities::delayMilliseconds(delay);
+        EventTimer eventTimer;
+        eventTimer.start();
+        do {
+            std::string str{this->m_ioStream->readUntil(LINE_ENDING)};
+            //Pushed IO reports are not the reply, whatever the request was
+            this->routePushedIOReports(&str);
+            if (str != "") {
+                returnString = str;
+                break;
+            }
+            eventTimer.update();
+        } while (eventTimer.totalMilliseconds() < this->m_ioStream->timeout());
+        this->m_ioStream->setTimeout(tempTimeout);
+    }
+    this->m_ioMetrics.recordExchange(header, stringToSend.length(), returnString.length(), std::chrono::steady_clock::now() - sentTime, returnString == "");
+    return returnString;
+}
+
+std::vector<std::string> Arduino::genericIOTask(const std::string &stringToSend, const std::string &header, double delay)
+{
+    std::unique_ptr<std::string> returnString{std::make_unique<std::string>(genericIOFrameTask(stringToSend, header, delay))};
     if (GeneralUtilities::endsWith(*returnString, LINE_ENDING)) {
         *returnString = returnString->substr(0, returnString->length()-1); 
     }
@@ -141,30 +384,44 @@ std::vector<std::string> Arduino::genericIOTask(const std::string &stringToSend,
     return GeneralUtilities::parseToContainer<std::vector<std::string>>(returnString->begin(), returnString->end(), ':');
 }
 
+bool Arduino::genericIOTask(const std::string &stringToSend, const std::string &header, double delay, IOResponseFields *fields)
+{
+    return fields->parse(genericIOFrameTask(stringToSend, header, delay), header, ':', TERMINATING_CHARACTER, LINE_ENDING);
+}
+
 std::vector<std::string> Arduino::genericIOReportTask(const std::string &stringToSend, const std::string &header, const std::string &endHeader, double delay)
 {
-    std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->waitForExclusiveIO(ioLock);
     if (!this->m_ioStream->isOpen()) {
-        this->m_ioStream->openPort();
-        GeneralUtilities::delayMilliseconds(BOOTLOADER_BOOT_TIME);
+        this->openIOStream();
     }
-    this->m_ioStream->writeLine(stringToSend);
-    GeneralUtilities::delayMilliseconds(delay);
+    std::string endSequence{GeneralUtilities::stripAllFromString(endHeader, LINE_ENDING) + TERMINATING_CHARACTER};
     std::unique_ptr<std::string> returnString{std::make_unique<std::string>("")};
-    EventTimer eventTimer;
-    eventTimer.start();
-    do {
-        std::string str{this->m_ioStream->readUntil(LINE_ENDING)};
-        if (str != "") {
-            *returnString = str;
-            break;
-        }
-        eventTimer.update();
-    } while (eventTimer.totalMilliseconds() < this->m_ioStream->timeout());
+    std::chrono::steady_clock::time_point sentTime{std::chrono::steady_clock::now()};
+    if (this->m_ioResponseMode == IOResponseMode::EVENT_DRIVEN) {
+        this->m_ioStream->writeLine(stringToSend);
+        //Reports are much longer than the frames the round trip estimate is built from, so it only ever extends this limit
+        *returnString = this->readResponseFrame(header, endSequence, std::max(delay + SERIAL_REPORT_REQUEST_TIME_LIMIT, this->timeLimitForDelay(delay)));
+    } else {
+        this->m_ioStream->writeLine(stringToSend);
+        GeneralUtilities::delayMilliseconds(delay);
+        EventTimer eventTimer;
+        eventTimer.start();
+        do {
+            std::string str{this->m_ioStream->readUntil(LINE_ENDING)};
+            if (str != "") {
+                *returnString = str;
+                break;
+            }
+            eventTimer.update();
+        } while (eventTimer.totalMilliseconds() < this->m_ioStream->timeout());
+    }
+    this->m_ioMetrics.recordExchange(header, stringToSend.length(), returnString->length(), std::chrono::steady_clock::now() - sentTime, *returnString == "");
     if (GeneralUtilities::endsWith(*returnString, LINE_ENDING)) {
         *returnString = returnString->substr(0, returnString->length()-1); 
     }
-    if (GeneralUtilities::startsWith(*returnString, header) && GeneralUtilities::endsWith(*returnString, endHeader)) {
+    if (GeneralUtilities::startsWith(*returnString, header) && GeneralUtilities::endsWith(*returnString, endSequence)) {
         *returnString = returnString->substr(static_cast<std::string>(header).length() + 1);
         *returnString = returnString->substr(0, returnString->length()-1);
     } else {
@@ -177,6 +434,7 @@ std::pair<IOStatus, std::string> Arduino::arduinoTypeString()
 {
     std::string stringToSend{static_cast<std::string>(ARDUINO_TYPE_HEADER) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(ARDUINO_TYPE_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(ARDUINO_TYPE_HEADER), this->m_streamSendDelay)};
         if (states.size() != ARDUINO_TYPE_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -201,6 +459,7 @@ std::pair<IOStatus, std::string> Arduino::firmwareVersion()
 {
     std::string stringToSend{static_cast<std::string>(FIRMWARE_VERSION_HEADER) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(FIRMWARE_VERSION_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(FIRMWARE_VERSION_HEADER), this->m_streamSendDelay)};
         if (states.size() != ARDUINO_TYPE_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -225,6 +484,7 @@ std::pair<IOStatus, bool> Arduino::canCapability()
 {
     std::string stringToSend{static_cast<std::string>(CAN_BUS_ENABLED_HEADER) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_BUS_ENABLED_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(CAN_BUS_ENABLED_HEADER), this->m_streamSendDelay)};
         if (states.size() != CAN_BUS_ENABLED_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -250,10 +510,35 @@ std::pair<IOStatus, bool> Arduino::canCapability()
     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
 }
 
+/* The firmware moves received frames from the CAN controller into a small ring from its receive
+ * interrupt. Returns how many were dropped because that ring was full since the last call */
+std::pair<IOStatus, uint32_t> Arduino::canReceiveOverflows()
+{
+    std::string stringToSend{static_cast<std::string>(CAN_RECEIVE_OVERFLOWS_HEADER) + LINE_ENDING};
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_RECEIVE_OVERFLOWS_HEADER, i);
+        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(CAN_RECEIVE_OVERFLOWS_HEADER), this->m_streamSendDelay)};
+        if (states.size() != CAN_RECEIVE_OVERFLOWS_RETURN_SIZE) {
+            continue;
+        }
+        if (states.at(CanEnabledStatus::CAN_OPERATION_RESULT) != OPERATION_SUCCESS_STRING) {
+            continue;
+        }
+        try {
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, static_cast<uint32_t>(GeneralUtilities::decStringToInt(states.at(CanEnabledStatus::CAN_RETURN_STATE))));
+        } catch (std::exception &e) {
+            (void)e;
+            continue;
+        }
+    }
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+}
+
 std::pair<IOStatus, int> Arduino::analogToDigitalThreshold()
 {
     std::string stringToSend{static_cast<std::string>(CURRENT_A_TO_D_THRESHOLD_HEADER) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CURRENT_A_TO_D_THRESHOLD_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(CURRENT_A_TO_D_THRESHOLD_HEADER), this->m_streamSendDelay)};
         if (states.size() != A_TO_D_THRESHOLD_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -287,6 +572,7 @@ IOReport Arduino::ioReportRequest()
 {
     std::string stringToSend{static_cast<std::string>(IO_REPORT_HEADER) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(IO_REPORT_HEADER, i);
         std::vector<std::string> allStates{genericIOReportTask(stringToSend, 
                                                                static_cast<std::string>(IO_REPORT_HEADER), 
                                                                static_cast<std::string>(IO_REPORT_END_HEADER) + LINE_ENDING, 
@@ -322,17 +608,194 @@ IOReport Arduino::ioReportRequest()
                 ioReport.addAnalogOutputResult(std::make_pair(GeneralUtilities::decStringToInt(states.at(IOReportEnum::IO_PIN_NUMBER)), GeneralUtilities::decStringToInt(states.at(IOReportEnum::IO_STATE))));
             }
         }
+        this->recordIOReport(ioReport);
+        std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+        this->m_ioReportCache->merge(ioReport);
         return ioReport;
     }
     return IOReport{};
 }
 
-SerialReport Arduino::serialReportRequest(const std::string &delimiter)
+/* Fetches only the pins that changed since they were last reported, merges them into the cached
+ * view and returns the merged view. If a reply is lost the firmware has already moved its baseline,
+ * so every retry asks for a full resynchronization instead */
+IOReport Arduino::ioReportDeltaRequest(bool resynchronize)
+{
+    IOReportFields fields;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(IO_REPORT_DELTA_HEADER, i);
+        std::string stringToSend{static_cast<std::string>(IO_REPORT_DELTA_HEADER) + (((resynchronize) || (i > 0)) ? ":1" : "") + LINE_ENDING};
+        if (!fields.parse(genericIOFrameTask(stringToSend, static_cast<std::string>(IO_REPORT_DELTA_HEADER), this->m_streamSendDelay), IO_REPORT_DELTA_HEADER, ':', TERMINATING_CHARACTER, LINE_ENDING)) {
+            continue;
+        }
+        IOReport ioReport;
+        if (!this->parseIOReportFields(fields, &ioReport)) {
+            continue;
+        }
+        this->recordIOReport(ioReport);
+        std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+        if ((resynchronize) || (i > 0)) {
+            *this->m_ioReportCache = IOReport{};
+        }
+        this->m_ioReportCache->merge(ioReport);
+        return *this->m_ioReportCache;
+    }
+    throw std::runtime_error(IO_REPORT_DELTA_INVALID_DATA_STRING);
+}
+
+IOReport Arduino::cachedIOReport()
 {
     std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+    return *this->m_ioReportCache;
+}
+
+std::pair<IOStatus, int> Arduino::setAnalogReportDeadband(int deadband)
+{
+    std::string stringToSend{static_cast<std::string>(IO_DEADBAND_HEADER) + ":" + std::to_string(deadband) + LINE_ENDING};
+    IOResponseFields fields;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(IO_DEADBAND_HEADER, i);
+        if (!genericIOTask(stringToSend, static_cast<std::string>(IO_DEADBAND_HEADER), this->m_streamSendDelay, &fields)) {
+            continue;
+        }
+        if (fields.size() != IO_DEADBAND_RETURN_SIZE) {
+            continue;
+        }
+        if (fields[ArduinoTypeEnum::OPERATION_RESULT] != OPERATION_SUCCESS_STRING) {
+            continue;
+        }
+        int returnedDeadband{0};
+        if ((!fields[ArduinoTypeEnum::RETURN_STATE].toInt(&returnedDeadband)) || (returnedDeadband != deadband)) {
+            continue;
+        }
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, returnedDeadband);
+    }
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+}
+
+static int ioStreamModeNumber(IOStreamMode ioStreamMode)
+{
+    switch (ioStreamMode) {
+        case IOStreamMode::PERIODIC: return IO_STREAM_PERIODIC_MODE;
+        case IOStreamMode::ON_CHANGE: return IO_STREAM_ON_CHANGE_MODE;
+        case IOStreamMode::DELTA: return IO_STREAM_DELTA_MODE;
+    }
+    return IO_STREAM_PERIODIC_MODE;
+}
+
+/* Asks the firmware to push an IO report every intervalMilliseconds (in ON_CHANGE mode only when
+ * a pin changed, in DELTA mode only the pins that changed). Each report is merged into the cached
+ * view, which is then handed to onIOReport. onIOReport is called from the reader thread */
+std::pair<IOStatus, unsigned int> Arduino::subscribeIOReports(unsigned int intervalMilliseconds, IOStreamMode ioStreamMode, std::function<void(const IOReport &)> onIOReport)
+{
+    if ((intervalMilliseconds < IO_STREAM_MINIMUM_INTERVAL) || (intervalMilliseconds > IO_STREAM_MAXIMUM_INTERVAL)) {
+        throw std::runtime_error(INVALID_IO_STREAM_INTERVAL_STRING + std::to_string(intervalMilliseconds) + ")");
+    }
+    std::string stringToSend{static_cast<std::string>(IO_STREAM_HEADER) + ":" + std::to_string(intervalMilliseconds) + ":" + std::to_string(ioStreamModeNumber(ioStreamMode)) + LINE_ENDING};
+    IOStatus ioStatus{this->ioStreamRequest(stringToSend, intervalMilliseconds, ioStreamMode)};
+    if (ioStatus == IOStatus::OPERATION_SUCCESS) {
+        std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+        this->m_onIOReport = onIOReport;
+        this->m_ioReportsSubscribed = true;
+        this->startAsyncReader();
+        this->m_ioCondition.notify_all();
+    }
+    return std::make_pair(ioStatus, intervalMilliseconds);
+}
+
+IOStatus Arduino::unsubscribeIOReports()
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->m_ioReportsSubscribed = false;
+    this->m_pendingIOReportFrames.clear();
+    ioLock.unlock();
+    std::string stringToSend{static_cast<std::string>(IO_STREAM_HEADER) + ":0" + LINE_ENDING};
+    //Without a mode item the firmware falls back to, and echoes, the periodic mode
+    IOStatus ioStatus{this->ioStreamRequest(stringToSend, 0, IOStreamMode::PERIODIC)};
+    ioLock.lock();
+    this->m_onIOReport = nullptr;
+    return ioStatus;
+}
+
+IOStatus Arduino::ioStreamRequest(const std::string &stringToSend, unsigned int intervalMilliseconds, IOStreamMode ioStreamMode)
+{
+    IOResponseFields fields;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(IO_STREAM_HEADER, i);
+        if (!genericIOTask(stringToSend, static_cast<std::string>(IO_STREAM_HEADER), this->m_streamSendDelay, &fields)) {
+            continue;
+        }
+        if (fields.size() != IO_STREAM_RETURN_SIZE) {
+            continue;
+        }
+        int returnedInterval{0};
+        if ((!fields[IOState::PIN_NUMBER].toInt(&returnedInterval)) || (returnedInterval != static_cast<int>(intervalMilliseconds))) {
+            continue;
+        }
+        int returnedMode{0};
+        if ((!fields[IOState::STATE].toInt(&returnedMode)) || (returnedMode != ioStreamModeNumber(ioStreamMode))) {
+            continue;
+        }
+        if (fields[IOState::RETURN_CODE] != OPERATION_SUCCESS_STRING) {
+            continue;
+        }
+        return IOStatus::OPERATION_SUCCESS;
+    }
+    return IOStatus::OPERATION_FAILURE;
+}
+
+/* Pushed reports are flat pin:type:state triplets (analog inputs by alias, e.g. A0) closed by
+ * IO_STREAM_END_IDENTIFIER. Empty fields are skipped */
+bool Arduino::parseIOReportFields(const IOReportFields &fields, IOReport *ioReport) const
+{
+    size_t i{0};
+    while (i < fields.size()) {
+        if (fields[i].empty()) {
+            i++;
+            continue;
+        }
+        if (fields[i] == IO_STREAM_END_IDENTIFIER) {
+            return true;
+        }
+        if (i + IO_REPORT_RETURN_SIZE > fields.size()) {
+            return false;
+        }
+        int pinNumber{0};
+        if (!fields[i + IOReportEnum::IO_PIN_NUMBER].toInt(&pinNumber)) {
+            try {
+                pinNumber = parseAnalogPin(this->m_arduinoType, fields[i + IOReportEnum::IO_PIN_NUMBER].toString());
+            } catch (std::exception &e) {
+                (void)e;
+                return false;
+            }
+        }
+        int state{0};
+        if (!fields[i + IOReportEnum::IO_STATE].toInt(&state)) {
+            return false;
+        }
+        const FieldView &ioType{fields[i + IOReportEnum::IO_TYPE]};
+        if ((ioType == DIGITAL_INPUT_IDENTIFIER) || (ioType == DIGITAL_INPUT_PULLUP_IDENTIFIER)) {
+            ioReport->addDigitalInputResult(std::make_pair(pinNumber, state == 1));
+        } else if (ioType == DIGITAL_OUTPUT_IDENTIFIER) {
+            ioReport->addDigitalOutputResult(std::make_pair(pinNumber, state == 1));
+        } else if (ioType == ANALOG_INPUT_IDENTIFIER) {
+            ioReport->addAnalogInputResult(std::make_pair(pinNumber, state));
+        } else if (ioType == ANALOG_OUTPUT_IDENTIFIER) {
+            ioReport->addAnalogOutputResult(std::make_pair(pinNumber, state));
+        } else {
+            return false;
+        }
+        i += IO_REPORT_RETURN_SIZE;
+    }
+    return false;
+}
+
+SerialReport Arduino::serialReportRequest(const std::string &delimiter)
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->waitForExclusiveIO(ioLock);
     if (!this->m_ioStream->isOpen()) {
-        this->m_ioStream->openPort();
-        GeneralUtilities::delayMilliseconds(BOOTLOADER_BOOT_TIME);
+        this->openIOStream();
     }
     SerialReport serialReport;
     std::unique_ptr<std::string> readLine{std::make_unique<std::string>("")};
@@ -389,6 +852,7 @@ std::pair<IOStatus, int> Arduino::setAnalogToDigitalThreshold(int threshold)
 {
     std::string stringToSend{static_cast<std::string>(CHANGE_A_TO_D_THRESHOLD_HEADER) + ":" + std::to_string(threshold) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CHANGE_A_TO_D_THRESHOLD_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(CHANGE_A_TO_D_THRESHOLD_HEADER), this->m_streamSendDelay)};
         if (states.size() != A_TO_D_THRESHOLD_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -430,6 +894,7 @@ std::pair<IOStatus, IOType> Arduino::pinMode(int pinNumber, IOType ioType)
 {
     std::string stringToSend{static_cast<std::string>(PIN_TYPE_CHANGE_HEADER) + ":" + std::to_string(pinNumber) + ":" + parseIOType(ioType) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(PIN_TYPE_CHANGE_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(PIN_TYPE_CHANGE_HEADER), this->m_streamSendDelay)};
         if (states.size() != IO_STATE_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -453,7 +918,9 @@ std::pair<IOStatus, IOType> Arduino::pinMode(int pinNumber, IOType ioType)
             }
         }
         try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, parseIOTypeFromString(states.at(IOState::STATE)));
+            IOType returnedIOType{parseIOTypeFromString(states.at(IOState::STATE))};
+            this->recordPinType(pinNumber, returnedIOType);
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, returnedIOType);
         } catch (std::exception &e) {
             (void)e;
             if (i+1 == this->m_ioTryCount) {
@@ -471,6 +938,7 @@ std::pair<IOStatus, IOType> Arduino::currentPinMode(int pinNumber)
 {
     std::string stringToSend{static_cast<std::string>(PIN_TYPE_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(PIN_TYPE_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(PIN_TYPE_HEADER), this->m_streamSendDelay)};
         if (states.size() != PIN_TYPE_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -494,7 +962,9 @@ std::pair<IOStatus, IOType> Arduino::currentPinMode(int pinNumber)
             }
         }
         try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, parseIOTypeFromString(states.at(IOState::STATE)));
+            IOType returnedIOType{parseIOTypeFromString(states.at(IOState::STATE))};
+            this->recordPinType(pinNumber, returnedIOType);
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, returnedIOType);
         } catch (std::exception &e) {
             (void)e;
             if (i+1 == this->m_ioTryCount) {
@@ -509,82 +979,37 @@ std::pair<IOStatus, IOType> Arduino::currentPinMode(int pinNumber)
 
 std::pair<IOStatus, bool> Arduino::digitalRead(int pinNumber)
 {
-    std::string stringToSend{static_cast<std::string>(DIGITAL_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING };
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(DIGITAL_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)) == 1);
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
+    std::pair<IOStatus, int> result{IOStatus::OPERATION_FAILURE, 0};
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        result = this->binaryIOStateRequest(BinaryFrame::DIGITAL_READ, pinNumber, std::vector<uint8_t>{});
+    } else {
+        std::string stringToSend{static_cast<std::string>(DIGITAL_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING };
+        result = this->ioStateRequest(stringToSend, static_cast<std::string>(DIGITAL_READ_HEADER), pinNumber);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, false);
+    this->recordPinState(pinNumber, IOType::DIGITAL_INPUT, result);
+    return std::make_pair(result.first, result.second == 1);
+}
+
+std::pair<IOStatus, bool> Arduino::digitalRead(int pinNumber, const ReadPolicy &readPolicy)
+{
+    int state{0};
+    if (this->cachedPinState(pinNumber, false, readPolicy, &state)) {
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state == 1);
+    }
+    return this->digitalRead(pinNumber);
 }
 
 std::pair<IOStatus, bool> Arduino::digitalWrite(int pinNumber, bool state)
 {
-    std::string stringToSend{static_cast<std::string>(DIGITAL_WRITE_HEADER) + ":" + std::to_string(pinNumber) + ":" + std::to_string(state) + LINE_ENDING };
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(DIGITAL_WRITE_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)) == 1);
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, false);
-            } else {
-                continue;
-            }
-        }
+    std::pair<IOStatus, int> result{IOStatus::OPERATION_FAILURE, 0};
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        result = this->binaryIOStateRequest(BinaryFrame::DIGITAL_WRITE, pinNumber, std::vector<uint8_t>{static_cast<uint8_t>(state)});
+    } else {
+        std::string stringToSend{static_cast<std::string>(DIGITAL_WRITE_HEADER) + ":" + std::to_string(pinNumber) + ":" + std::to_string(state) + LINE_ENDING };
+        result = this->ioStateRequest(stringToSend, static_cast<std::string>(DIGITAL_WRITE_HEADER), pinNumber);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, false);
+    this->recordPinState(pinNumber, IOType::DIGITAL_OUTPUT, result);
+    return std::make_pair(result.first, result.second == 1);
 }
 
 std::pair<IOStatus, std::vector<int>> Arduino::digitalWriteAll(bool state)
@@ -592,6 +1017,7 @@ std::pair<IOStatus, std::vector<int>> Arduino::digitalWriteAll(bool state)
     std::vector<int> writtenPins;
     std::string stringToSend{static_cast<std::string>(DIGITAL_WRITE_ALL_HEADER) + ":" + std::to_string(state) + LINE_ENDING };
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(DIGITAL_WRITE_ALL_HEADER, i);
         writtenPins = std::vector<int>{};
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(DIGITAL_WRITE_ALL_HEADER), this->m_streamSendDelay)};
         if (states.size() == 0) {
@@ -629,6 +1055,9 @@ std::pair<IOStatus, std::vector<int>> Arduino::digitalWriteAll(bool state)
                 writtenPins.push_back(GeneralUtilities::decStringToInt(it));
             }
             std::sort(writtenPins.begin(), writtenPins.end());
+            for (auto &it : writtenPins) {
+                this->recordPinState(it, IOType::DIGITAL_OUTPUT, std::make_pair(IOStatus::OPERATION_SUCCESS, static_cast<int>(state)));
+            }
             return std::make_pair(IOStatus::OPERATION_SUCCESS, writtenPins);
         } catch (std::exception &e) {
             (void)e;
@@ -644,207 +1073,109 @@ std::pair<IOStatus, std::vector<int>> Arduino::digitalWriteAll(bool state)
 
 std::pair<IOStatus, bool> Arduino::softDigitalRead(int pinNumber)
 {
-    std::string stringToSend{static_cast<std::string>(SOFT_DIGITAL_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(SOFT_DIGITAL_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)));
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
+    std::pair<IOStatus, int> result{IOStatus::OPERATION_FAILURE, 0};
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        result = this->binaryIOStateRequest(BinaryFrame::SOFT_DIGITAL_READ, pinNumber, std::vector<uint8_t>{});
+    } else {
+        std::string stringToSend{static_cast<std::string>(SOFT_DIGITAL_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+        result = this->ioStateRequest(stringToSend, static_cast<std::string>(SOFT_DIGITAL_READ_HEADER), pinNumber);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    this->recordSoftPinState(pinNumber, false, result);
+    return std::make_pair(result.first, result.second == 1);
 }
 
-std::pair<IOStatus, double> Arduino::analogRead(int pinNumber)
+std::pair<IOStatus, bool> Arduino::softDigitalRead(int pinNumber, const ReadPolicy &readPolicy)
 {
-    std::string stringToSend{static_cast<std::string>(ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(ANALOG_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, analogToVoltage(GeneralUtilities::decStringToInt(states.at(IOState::STATE))));
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
+    int state{0};
+    if (this->cachedPinState(pinNumber, false, readPolicy, &state)) {
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state == 1);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
+    return this->softDigitalRead(pinNumber);
+}
+
+std::pair<IOStatus, double> Arduino::analogRead(int pinNumber)
+{
+    std::pair<IOStatus, int> result{this->analogReadRaw(pinNumber)};
+    return std::make_pair(result.first, (result.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(result.second) : 0.00);
+}
+
+std::pair<IOStatus, double> Arduino::analogRead(int pinNumber, const ReadPolicy &readPolicy)
+{
+    std::pair<IOStatus, int> result{this->analogReadRaw(pinNumber, readPolicy)};
+    return std::make_pair(result.first, (result.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(result.second) : 0.00);
 }
 
 std::pair<IOStatus, int> Arduino::analogReadRaw(int pinNumber)
 {
-    std::string stringToSend{static_cast<std::string>(ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(ANALOG_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)));
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
+    std::pair<IOStatus, int> result{IOStatus::OPERATION_FAILURE, 0};
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        result = this->binaryIOStateRequest(BinaryFrame::ANALOG_READ, pinNumber, std::vector<uint8_t>{});
+    } else {
+        std::string stringToSend{static_cast<std::string>(ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+        result = this->ioStateRequest(stringToSend, static_cast<std::string>(ANALOG_READ_HEADER), pinNumber);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    this->recordPinState(pinNumber, IOType::ANALOG_INPUT, result);
+    return result;
 }
 
-std::pair<IOStatus, double> Arduino::softAnalogRead(int pinNumber)
+std::pair<IOStatus, int> Arduino::analogReadRaw(int pinNumber, const ReadPolicy &readPolicy)
 {
-    std::string stringToSend{static_cast<std::string>(SOFT_ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(SOFT_ANALOG_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, analogToVoltage(GeneralUtilities::decStringToInt(states.at(IOState::STATE))));
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
-            } else {
-                continue;
-            }
-        }
+    int state{0};
+    if (this->cachedPinState(pinNumber, true, readPolicy, &state)) {
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0.00);
+    return this->analogReadRaw(pinNumber);
+}
+
+std::pair<IOStatus, double> Arduino::softAnalogRead(int pinNumber)
+{
+    std::pair<IOStatus, int> result{this->softAnalogReadRaw(pinNumber)};
+    return std::make_pair(result.first, (result.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(result.second) : 0.00);
+}
+
+std::pair<IOStatus, double> Arduino::softAnalogRead(int pinNumber, const ReadPolicy &readPolicy)
+{
+    std::pair<IOStatus, int> result{this->softAnalogReadRaw(pinNumber, readPolicy)};
+    return std::make_pair(result.first, (result.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(result.second) : 0.00);
 }
 
 std::pair<IOStatus, int> Arduino::softAnalogReadRaw(int pinNumber)
 {
-    std::string stringToSend{static_cast<std::string>(SOFT_ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
-    for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(SOFT_ANALOG_READ_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)));
-        } catch (std::exception &e) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
+    std::pair<IOStatus, int> result{IOStatus::OPERATION_FAILURE, 0};
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        result = this->binaryIOStateRequest(BinaryFrame::SOFT_ANALOG_READ, pinNumber, std::vector<uint8_t>{});
+    } else {
+        std::string stringToSend{static_cast<std::string>(SOFT_ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+        result = this->ioStateRequest(stringToSend, static_cast<std::string>(SOFT_ANALOG_READ_HEADER), pinNumber);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    this->recordSoftPinState(pinNumber, true, result);
+    return result;
+}
+
+std::pair<IOStatus, int> Arduino::softAnalogReadRaw(int pinNumber, const ReadPolicy &readPolicy)
+{
+    int state{0};
+    if (this->cachedPinState(pinNumber, true, readPolicy, &state)) {
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state);
+    }
+    return this->softAnalogReadRaw(pinNumber);
 }
 
 std::pair<IOStatus, double> Arduino::analogWrite(int pinNumber, double state)
 {
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        std::vector<uint8_t> analogState;
+        BinaryFrame::appendUInt16(analogState, static_cast<uint16_t>(voltageToAnalog(state)));
+        std::pair<IOStatus, int> result{this->binaryIOStateRequest(BinaryFrame::ANALOG_WRITE, pinNumber, analogState)};
+        this->recordPinState(pinNumber, IOType::ANALOG_OUTPUT, result);
+        return std::make_pair(result.first, analogToVoltage(result.second));
+    }
+    //The ASCII reply does not carry a raw state the cache can use
+    this->recordPinType(pinNumber, IOType::ANALOG_OUTPUT);
+    this->invalidatePinState(pinNumber);
     std::string stringToSend{static_cast<std::string>(ANALOG_WRITE_HEADER) + ":" + std::to_string(voltageToAnalog(pinNumber)) + ":" + std::to_string(state) + LINE_ENDING};
     for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(ANALOG_WRITE_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(ANALOG_WRITE_HEADER), this->m_streamSendDelay)};
         if (states.size() != IO_STATE_RETURN_SIZE) {
             if (i+1 == this->m_ioTryCount) {
@@ -883,83 +1214,233 @@ std::pair<IOStatus, double> Arduino::analogWrite(int pinNumber, double state)
 
 std::pair<IOStatus, int> Arduino::analogWriteRaw(int pinNumber, int state)
 {
+    if (this->m_protocolMode == ProtocolMode::BINARY) {
+        std::vector<uint8_t> analogState;
+        BinaryFrame::appendUInt16(analogState, static_cast<uint16_t>(state));
+        std::pair<IOStatus, int> result{this->binaryIOStateRequest(BinaryFrame::ANALOG_WRITE, pinNumber, analogState)};
+        this->recordPinState(pinNumber, IOType::ANALOG_OUTPUT, result);
+        return result;
+    }
     std::string stringToSend{static_cast<std::string>(ANALOG_WRITE_HEADER) + ":" + std::to_string(pinNumber) + ":" + std::to_string(state) + LINE_ENDING};
+    std::pair<IOStatus, int> result{this->ioStateRequest(stringToSend, static_cast<std::string>(ANALOG_WRITE_HEADER), pinNumber)};
+    this->recordPinState(pinNumber, IOType::ANALOG_OUTPUT, result);
+    return result;
+}
+
+std::pair<IOStatus, CanMessage> Arduino::canRead()
+{
+    std::string stringToSend{static_cast<std::string>(CAN_READ_HEADER) + TERMINATING_CHARACTER};
+    CanMessage emptyMessage{0, 0, 0, CanDataPacket()};
+    IOResponseFields fields;
     for (int i = 0; i < this->m_ioTryCount; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(ANALOG_WRITE_HEADER), this->m_streamSendDelay)};
-        if (states.size() != IO_STATE_RETURN_SIZE) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
+        this->m_ioMetrics.recordAttempt(CAN_READ_HEADER, i);
+        if (!genericIOTask(stringToSend, CAN_READ_HEADER, this->m_streamSendDelay, &fields)) {
+            continue;
         }
-        if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
-        }
-        if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
+        if (fields.size() == CAN_READ_BLANK_RETURN_SIZE) {
+            if (fields[0] == OPERATION_FAILURE_STRING) {
                 continue;
             }
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, emptyMessage);
         }
-        try {
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)));
-        } catch (std::exception &e) {
-            (void)e;
-            if (i+1 == this->m_ioTryCount) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
-            } else {
-                continue;
-            }
+        CanMessage message;
+        if (!parseCanReadFields(fields, &message)) {
+            continue;
         }
+        this->captureCanMessage(message, false);
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, message);
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
 }
 
-std::pair<IOStatus, CanMessage> Arduino::canRead()
+/* Unpacks a successful {canread:id:byte0:...:byteN:result} reply, which carries as many bytes as
+ * the frame's length (up to 8). The reply has no frame type, but only an extended frame can have
+ * an ID past 0x7FF. Returns false for blank, failed or malformed replies */
+bool Arduino::parseCanReadFields(const IOResponseFields &fields, CanMessage *message)
 {
-    using namespace GeneralUtilities;
-    std::string stringToSend{static_cast<std::string>(CAN_READ_HEADER) + TERMINATING_CHARACTER};
-    CanMessage emptyMessage{0, 0, 0, CanDataPacket()};
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
-        std::vector<std::string> states{genericIOTask(stringToSend, CAN_READ_HEADER, this->m_streamSendDelay)};
-        if ((states.size() == CAN_READ_RETURN_SIZE) && (states.size() != CAN_READ_BLANK_RETURN_SIZE)){
-            if (i+1 == IO_TRY_COUNT) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
-            } else {
-                continue;
-            }
+    if ((fields.size() < CAN_READ_RETURN_SIZE - CAN_MESSAGE_LENGTH) || (fields.size() > CAN_READ_RETURN_SIZE)) {
+        return false;
+    }
+    if (fields[fields.size() - 1] == OPERATION_FAILURE_STRING) {
+        return false;
+    }
+    uint32_t messageID{0};
+    if (!fields[CanIOStatus::MESSAGE_ID].toHexUInt(&messageID)) {
+        return false;
+    }
+    uint8_t length{static_cast<uint8_t>(fields.size() - (CAN_READ_RETURN_SIZE - CAN_MESSAGE_LENGTH))};
+    *message = CanMessage{messageID, ((messageID > MAXIMUM_STANDARD_CAN_ID) ? CAN_EXTENDED_FRAME : CAN_FRAME), length, CanDataPacket()};
+    for (unsigned int byteNumber = CanIOStatus::BYTE_0; byteNumber < CanIOStatus::BYTE_0 + length; byteNumber++) {
+        uint32_t byte{0};
+        if ((!fields[byteNumber].toHexUInt(&byte)) || (byte > 0xFF)) {
+            return false;
+        }
+        message->setDataPacketNthByte(byteNumber - CanIOStatus::BYTE_0, static_cast<unsigned char>(byte));
+    }
+    return true;
+}
+
+/* With live update on, the firmware pushes every received frame as a {canread:...} reply without
+ * being asked. The reader thread parses those into a bounded ring, collected with pollCanMessages() */
+std::pair<IOStatus, bool> Arduino::canAutoUpdate(bool state)
+{
+    std::string stringToSend{static_cast<std::string>(CAN_LIVE_UPDATE_HEADER) + ":" + std::to_string(state) + LINE_ENDING};
+    IOResponseFields fields;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_LIVE_UPDATE_HEADER, i);
+        if (!genericIOTask(stringToSend, static_cast<std::string>(CAN_LIVE_UPDATE_HEADER), this->m_streamSendDelay, &fields)) {
+            continue;
         }
-        if (states.size() == CAN_READ_BLANK_RETURN_SIZE) {
-            if (states.at(0) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
-                    return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
-                } else {
-                    continue;
-                }
-            } else {
-                return std::make_pair(IOStatus::OPERATION_SUCCESS, emptyMessage);
-            }
+        if (fields.size() != CAN_AUTO_UPDATE_RETURN_SIZE) {
+            continue;
         }
-        if (states.at(CanIOStatus::CAN_IO_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-            if (i+1 == IO_TRY_COUNT) {
-                return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
-            } else {
-                continue;
-            }
+        if ((fields[CanEnabledStatus::CAN_OPERATION_RESULT] != OPERATION_SUCCESS_STRING) || (fields[CanEnabledStatus::CAN_RETURN_STATE] != std::to_string(state))) {
+            continue;
         }
-        std::string message{states.at(CanIOStatus::MESSAGE_ID)};
-        for (unsigned int i = CanIOStatus::BYTE_0; i < CanIOStatus::CAN_IO_OPERATION_RESULT; i++) {
-            message += ":" + states.at(i);
+        std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+        this->m_canStreaming = state;
+        if (state) {
+            this->startAsyncReader();
         }
-        return std::make_pair(IOStatus::OPERATION_SUCCESS, CanMessage::parseCanMessage(message));
+        this->m_ioCondition.notify_all();
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state);
+    }
+    return std::make_pair(IOStatus::OPERATION_FAILURE, !state);
+}
+
+/* Sets how many streamed frames the firmware packs into each {canbatch} line (1 to
+ * MAXIMUM_CAN_BATCH_SIZE). A partly filled batch is still sent once its oldest frame is a few
+ * milliseconds old, so larger batches mostly trade header overhead for throughput. 1 goes back to
+ * one {canread} line per frame */
+std::pair<IOStatus, unsigned int> Arduino::setCanBatchSize(unsigned int frames)
+{
+    if ((frames < 1) || (frames > MAXIMUM_CAN_BATCH_SIZE)) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    std::string stringToSend{static_cast<std::string>(CAN_BATCH_SIZE_HEADER) + ":" + std::to_string(frames) + TERMINATING_CHARACTER};
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_BATCH_SIZE_HEADER, i);
+        std::vector<std::string> states{genericIOTask(stringToSend, CAN_BATCH_SIZE_HEADER, this->m_streamSendDelay)};
+        if (states.size() != CAN_BATCH_SIZE_RETURN_SIZE) {
+            continue;
+        }
+        if ((states.at(CanEnabledStatus::CAN_OPERATION_RESULT) != OPERATION_SUCCESS_STRING) || (states.at(CanEnabledStatus::CAN_RETURN_STATE) != std::to_string(frames))) {
+            continue;
+        }
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, frames);
+    }
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+}
+
+/* Moves up to maximumMessages streamed frames, oldest first, into messages and returns how many
+ * were copied. Frames that arrive while the ring is full are dropped and counted as overruns */
+size_t Arduino::pollCanMessages(CanMessage *messages, size_t maximumMessages)
+{
+    std::lock_guard<std::mutex> canPollLock{this->m_canPollMutex};
+    size_t polled{0};
+    while ((polled < maximumMessages) && (this->m_canMessageRing->tryPop(messages + polled))) {
+        polled++;
+    }
+    return polled;
+}
+
+CanStreamStatistics Arduino::canStreamStatistics() const
+{
+    return CanStreamStatistics{this->m_canStreamReceived.load(), this->m_canStreamOverruns.load(), this->m_canStreamMalformed.load(), this->m_canStreamFiltered.load()};
+}
+
+void Arduino::resetCanStreamStatistics()
+{
+    this->m_canStreamReceived = 0;
+    this->m_canStreamOverruns = 0;
+    this->m_canStreamMalformed = 0;
+    this->m_canStreamFiltered = 0;
+}
+
+/* Every CAN frame read, streamed or written from then on is also appended to busCapture. The
+ * capture only queues frames, so this adds no file IO to the receive path. Pass nullptr to stop */
+void Arduino::setBusCapture(std::shared_ptr<BusCaptureWriter> busCapture)
+{
+    std::lock_guard<std::mutex> busCaptureLock{this->m_busCaptureMutex};
+    this->m_busCapture = busCapture;
+}
+
+std::shared_ptr<BusCaptureWriter> Arduino::busCapture() const
+{
+    std::lock_guard<std::mutex> busCaptureLock{this->m_busCaptureMutex};
+    return this->m_busCapture;
+}
+
+void Arduino::captureCanMessage(const CanMessage &message, bool transmitted)
+{
+    std::shared_ptr<BusCaptureWriter> busCapture{this->busCapture()};
+    if (busCapture) {
+        busCapture->captureCanMessage(message, transmitted);
+    }
+}
+
+//Called from the reader thread with m_ioMutex held
+void Arduino::queueCanStreamFrame(std::string &&frame)
+{
+    this->m_ioMetrics.recordUnsolicited(CAN_READ_HEADER, frame.length());
+    CanMessage message;
+    if ((!this->m_canStreamFields.parse(std::move(frame), CAN_READ_HEADER, ':', TERMINATING_CHARACTER, LINE_ENDING)) || (!parseCanReadFields(this->m_canStreamFields, &message))) {
+        this->m_canStreamMalformed++;
+        return;
+    }
+    this->queueCanStreamMessage(message);
+}
+
+/* Unpacks a pushed {canbatch:count:id:data:...:result} frame, one CanMessage per id:data pair.
+ * The data field is the frame's bytes as two hex digits each, so its length gives the DLC.
+ * Called from the reader thread with m_ioMutex held */
+void Arduino::queueCanStreamBatch(std::string &&frame)
+{
+    this->m_ioMetrics.recordUnsolicited(CAN_BATCH_HEADER, frame.length());
+    int count{0};
+    if ((!this->m_canStreamFields.parse(std::move(frame), CAN_BATCH_HEADER, ':', TERMINATING_CHARACTER, LINE_ENDING)) ||
+        (this->m_canStreamFields.size() < 2) ||
+        (!this->m_canStreamFields[0].toInt(&count)) ||
+        (this->m_canStreamFields.size() != static_cast<size_t>(2 + (2 * count))) ||
+        (this->m_canStreamFields[this->m_canStreamFields.size() - 1] != OPERATION_SUCCESS_STRING)) {
+        this->m_canStreamMalformed++;
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        const FieldView &idField = this->m_canStreamFields[1 + (2 * i)];
+        const FieldView &dataField = this->m_canStreamFields[2 + (2 * i)];
+        uint32_t messageID{0};
+        if ((!idField.toHexUInt(&messageID)) || ((dataField.length() % 2) != 0) || (dataField.length() > (2 * CAN_MESSAGE_LENGTH))) {
+            this->m_canStreamMalformed++;
+            continue;
+        }
+        uint8_t frameType{(idField.length() == CAN_BATCH_EXTENDED_ID_DIGITS) ? CAN_EXTENDED_FRAME : CAN_FRAME};
+        CanMessage message{messageID, frameType, static_cast<uint8_t>(dataField.length() / 2), CanDataPacket()};
+        bool validData{true};
+        for (size_t byteNumber = 0; byteNumber < message.length(); byteNumber++) {
+            uint32_t byte{0};
+            validData = validData && FieldView{dataField.data() + (2 * byteNumber), 2}.toHexUInt(&byte);
+            message.setDataPacketNthByte(byteNumber, static_cast<unsigned char>(byte));
+        }
+        if (!validData) {
+            this->m_canStreamMalformed++;
+            continue;
+        }
+        this->queueCanStreamMessage(message);
+    }
+}
+
+void Arduino::queueCanStreamMessage(const CanMessage &message)
+{
+    this->m_canStreamReceived++;
+    if (!this->m_canFilter->accepts(message.id())) {
+        this->m_canStreamFiltered++;
+        return;
+    }
+    this->captureCanMessage(message, false);
+    if (!this->m_canMessageRing->tryPush(message)) {
+        this->m_canStreamOverruns++;
     }
-    return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
 }
 
 std::pair<IOStatus, CanMessage> Arduino::canWrite(const CanMessage &message)
@@ -967,24 +1448,25 @@ std::pair<IOStatus, CanMessage> Arduino::canWrite(const CanMessage &message)
     using namespace GeneralUtilities;
     CanMessage emptyMessage{0, 0, 0, CanDataPacket()};
     std::string stringToSend{static_cast<std::string>(CAN_WRITE_HEADER) + ":" + message.toString() + TERMINATING_CHARACTER };
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_WRITE_HEADER, i);
         std::vector<std::string> states{genericIOTask(stringToSend, CAN_WRITE_HEADER, this->m_streamSendDelay)};
         if ((states.size() == CAN_READ_RETURN_SIZE) && (states.size() != CAN_READ_BLANK_RETURN_SIZE)){
-            if (i+1 == IO_TRY_COUNT) {
+            if (i+1 == this->m_ioTryCount) {
                 return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
             } else {
                 continue;
             }
         }
         if (states.size() != CAN_WRITE_RETURN_SIZE) {
-            if (i+1 == IO_TRY_COUNT) {
+            if (i+1 == this->m_ioTryCount) {
                 return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
             } else {
                 continue;
             }
         }
         if (states.at(CanIOStatus::CAN_IO_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-            if (i+1 == IO_TRY_COUNT) {
+            if (i+1 == this->m_ioTryCount) {
                 return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
             } else {
                 continue;
@@ -994,6 +1476,7 @@ std::pair<IOStatus, CanMessage> Arduino::canWrite(const CanMessage &message)
         for (unsigned int i = CanIOStatus::BYTE_0; i < CanIOStatus::CAN_IO_OPERATION_RESULT; i++) {
             returnMessage += ":" + states.at(i);
         }
+        this->captureCanMessage(message, true);
         return std::make_pair(IOStatus::OPERATION_SUCCESS, CanMessage::parseCanMessage(returnMessage));
     }
     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
@@ -1002,11 +1485,12 @@ std::pair<IOStatus, CanMessage> Arduino::canWrite(const CanMessage &message)
 CanReport Arduino::canReportRequest()
 {
     using namespace GeneralUtilities;
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_READ_HEADER, i);
         CanReport canReport;
         std::pair<IOStatus, CanMessage> result{canListen(DEFAULT_IO_STREAM_SEND_DELAY)};
         if (result.first == IOStatus::OPERATION_FAILURE) {
-            if (i+1 == IO_TRY_COUNT) {
+            if (i+1 == this->m_ioTryCount) {
                 throw std::runtime_error(CAN_REPORT_INVALID_DATA_STRING);
             } else {
                 continue;
@@ -1024,8 +1508,15 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
     using namespace GeneralUtilities;
     std::string stringToSend{static_cast<std::string>(CAN_READ_HEADER) + TERMINATING_CHARACTER};
     CanMessage emptyMessage{0, 0, 0, CanDataPacket()};
+    //Reads the stream directly, so it has to keep the reader thread out like the generic tasks do
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->waitForExclusiveIO(ioLock);
+    if (!this->m_ioStream->isOpen()) {
+        this->openIOStream();
+    }
     this->m_ioStream->writeLine(stringToSend);
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(CAN_READ_HEADER, i);
         std::unique_ptr<std::string> returnString{std::make_unique<std::string>("")};
         *returnString = this->m_ioStream->readUntil(TERMINATING_CHARACTER);
         bool canRead{false};
@@ -1040,7 +1531,7 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
             *returnString = returnString->substr(static_cast<std::string>(CAN_WRITE_HEADER).length() + 1);
             *returnString = returnString->substr(0, returnString->find(TERMINATING_CHARACTER)+1);
         } else {
-            if (i+1 == IO_TRY_COUNT) {
+            if (i+1 == this->m_ioTryCount) {
                 return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
             } else {
                 continue;
@@ -1049,7 +1540,7 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
         if (canRead) {
             std::vector<std::string> states{parseToContainer<std::vector<std::string>>(returnString->begin(), returnString->end(), ':')};
             if ((states.size() != CAN_READ_RETURN_SIZE) && (states.size() != CAN_READ_BLANK_RETURN_SIZE)){
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
                 } else {
                     continue;
@@ -1057,7 +1548,7 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
             }
             if (states.size() == CAN_READ_BLANK_RETURN_SIZE) {
                 if (states.at(0) == OPERATION_FAILURE_STRING) {
-                    if (i+1 == IO_TRY_COUNT) {
+                    if (i+1 == this->m_ioTryCount) {
                         return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
                     } else {
                         continue;
@@ -1067,7 +1558,7 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
                 }
             }
             if (states.at(CanIOStatus::CAN_IO_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
                 } else {
                     continue;
@@ -1077,18 +1568,20 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
             for (unsigned int i = CanIOStatus::BYTE_0; i < CanIOStatus::CAN_IO_OPERATION_RESULT; i++) {
                 message += ":" + states.at(i);
             }
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, CanMessage::parseCanMessage(message));
+            CanMessage canMessage{CanMessage::parseCanMessage(message)};
+            this->captureCanMessage(canMessage, false);
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, canMessage);
         } else {
             std::vector<std::string> states{parseToContainer<std::vector<std::string>>(returnString->begin(), returnString->end(), ':')};
             if (states.size() != CAN_WRITE_RETURN_SIZE) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
                 } else {
                     continue;
                 }
             }
             if (states.at(CanIOStatus::CAN_IO_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
                 } else {
                     continue;
@@ -1098,7 +1591,9 @@ std::pair<IOStatus, CanMessage> Arduino::canListen(double delay)
             for (unsigned int i = CanIOStatus::BYTE_0; i < CanIOStatus::CAN_IO_OPERATION_RESULT; i++) {
                 message += ":" + states.at(i);
             }
-            return std::make_pair(IOStatus::OPERATION_SUCCESS, CanMessage::parseCanMessage(message));
+            CanMessage canMessage{CanMessage::parseCanMessage(message)};
+            this->captureCanMessage(canMessage, true);
+            return std::make_pair(IOStatus::OPERATION_SUCCESS, canMessage);
         }
     }
     return std::make_pair(IOStatus::OPERATION_FAILURE, emptyMessage);
@@ -1115,25 +1610,26 @@ std::pair<IOStatus, uint32_t> Arduino::addCanMask(CanMaskType canMaskType, const
     } else {
         return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
     }
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
         if (canMaskType == CanMaskType::POSITIVE) {
+            this->m_ioMetrics.recordAttempt(ADD_POSITIVE_CAN_MASK_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, ADD_POSITIVE_CAN_MASK_HEADER, this->m_streamSendDelay)};
             if (states.size() != ADD_CAN_MASK_RETURN_SIZE) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (mask != states.at(CanMask::CAN_MASK_RETURN_STATE)) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (states.at(CanMask::CAN_MASK_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1143,7 +1639,7 @@ std::pair<IOStatus, uint32_t> Arduino::addCanMask(CanMaskType canMaskType, const
                 return std::make_pair(IOStatus::OPERATION_SUCCESS, std::stoi(states.at(CanMask::CAN_MASK_RETURN_STATE)));
             } catch (std::exception &e) {
                 (void)e;
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1151,23 +1647,24 @@ std::pair<IOStatus, uint32_t> Arduino::addCanMask(CanMaskType canMaskType, const
             }
         } else if (canMaskType == CanMaskType::NEGATIVE) {
             std::string stringToSend{static_cast<std::string>(ADD_NEGATIVE_CAN_MASK_HEADER) + ':' + mask + TERMINATING_CHARACTER};
+            this->m_ioMetrics.recordAttempt(ADD_NEGATIVE_CAN_MASK_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, ADD_NEGATIVE_CAN_MASK_HEADER, this->m_streamSendDelay)};
             if (states.size() != ADD_CAN_MASK_RETURN_SIZE) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (mask != states.at(CanMask::CAN_MASK_RETURN_STATE)) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (states.at(CanMask::CAN_MASK_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1177,7 +1674,7 @@ std::pair<IOStatus, uint32_t> Arduino::addCanMask(CanMaskType canMaskType, const
                 return std::make_pair(IOStatus::OPERATION_SUCCESS, std::stoi(states.at(CanMask::CAN_MASK_RETURN_STATE)));
             } catch (std::exception &e) {
                 (void)e;
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1202,25 +1699,26 @@ std::pair<IOStatus, uint32_t> Arduino::removeCanMask(CanMaskType canMaskType, co
     } else {
         return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
     }
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
         if (canMaskType == CanMaskType::POSITIVE) {
+            this->m_ioMetrics.recordAttempt(REMOVE_POSITIVE_CAN_MASK_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, REMOVE_POSITIVE_CAN_MASK_HEADER, this->m_streamSendDelay)};
             if (states.size() != REMOVE_CAN_MASK_RETURN_SIZE) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (mask != states.at(CanMask::CAN_MASK_RETURN_STATE)) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (states.at(CanMask::CAN_MASK_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1230,30 +1728,31 @@ std::pair<IOStatus, uint32_t> Arduino::removeCanMask(CanMaskType canMaskType, co
                 return std::make_pair(IOStatus::OPERATION_SUCCESS, std::stoi(states.at(CanMask::CAN_MASK_RETURN_STATE)));
             } catch (std::exception &e) {
                 (void)e;
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
         } else if (canMaskType == CanMaskType::NEGATIVE) {
+            this->m_ioMetrics.recordAttempt(REMOVE_NEGATIVE_CAN_MASK_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, REMOVE_NEGATIVE_CAN_MASK_HEADER, this->m_streamSendDelay)};
             if (states.size() != REMOVE_CAN_MASK_RETURN_SIZE) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (mask != states.at(CanMask::CAN_MASK_RETURN_STATE)) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
                 }
             }
             if (states.at(CanMask::CAN_MASK_OPERATION_RESULT) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1263,7 +1762,7 @@ std::pair<IOStatus, uint32_t> Arduino::removeCanMask(CanMaskType canMaskType, co
                 return std::make_pair(IOStatus::OPERATION_SUCCESS, std::stoi(states.at(CanMask::CAN_MASK_RETURN_STATE)));
             } catch (std::exception &e) {
                 (void)e;
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
                 } else {
                     continue;
@@ -1288,18 +1787,19 @@ std::pair<IOStatus, bool> Arduino::removeAllCanMasks(CanMaskType canMaskType)
         stringToSend = static_cast<std::string>(CLEAR_ALL_CAN_MASKS_HEADER) + TERMINATING_CHARACTER;
     }
 
-    for (int i = 0; i < IO_TRY_COUNT; i++) {
+    for (int i = 0; i < this->m_ioTryCount; i++) {
         if (canMaskType == CanMaskType::POSITIVE) {
+            this->m_ioMetrics.recordAttempt(CLEAR_ALL_POSITIVE_CAN_MASKS_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, CLEAR_ALL_POSITIVE_CAN_MASKS_HEADER, this->m_streamSendDelay)};
             if (states.size() != 1) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
                 }
             }
             if (states.at(0) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
@@ -1307,16 +1807,17 @@ std::pair<IOStatus, bool> Arduino::removeAllCanMasks(CanMaskType canMaskType)
             }
             return std::make_pair(IOStatus::OPERATION_SUCCESS, true);
         } else if (canMaskType == CanMaskType::NEGATIVE) {
+            this->m_ioMetrics.recordAttempt(CLEAR_ALL_NEGATIVE_CAN_MASKS_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, CLEAR_ALL_NEGATIVE_CAN_MASKS_HEADER, this->m_streamSendDelay)};
             if (states.size() != 1) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
                 }
             }
             if (states.at(0) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
@@ -1324,16 +1825,17 @@ std::pair<IOStatus, bool> Arduino::removeAllCanMasks(CanMaskType canMaskType)
             }
             return std::make_pair(IOStatus::OPERATION_SUCCESS, true);
         } else {
+            this->m_ioMetrics.recordAttempt(CLEAR_ALL_CAN_MASKS_HEADER, i);
             std::vector<std::string> states{genericIOTask(stringToSend, CLEAR_ALL_CAN_MASKS_HEADER, this->m_streamSendDelay)};
             if (states.size() != 1) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
                 }
             }
             if (states.at(0) == OPERATION_FAILURE_STRING) {
-                if (i+1 == IO_TRY_COUNT) {
+                if (i+1 == this->m_ioTryCount) {
                     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
                 } else {
                     continue;
@@ -1345,79 +1847,749 @@ std::pair<IOStatus, bool> Arduino::removeAllCanMasks(CanMaskType canMaskType)
     return std::make_pair(IOStatus::OPERATION_FAILURE, false);
 }
 
-bool Arduino::isValidAnalogPinIdentifier(const std::string &state) const
+/* Replaces the firmware's positive or negative mask list with ids in one frame, instead of an
+ * add/remove round trip per mask. Returns how many masks the firmware now holds */
+std::pair<IOStatus, size_t> Arduino::setCanMasks(CanMaskType canMaskType, const std::vector<uint32_t> &ids)
 {
-    for (auto &it : this->m_availableAnalogPins) {
-        if (state == analogPinFromNumber(this->m_arduinoType, it)) {
-            return true;
+    using namespace GeneralUtilities;
+    if (ids.size() > FIRMWARE_CAN_MASK_SLOTS) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    if (ids.empty()) {
+        std::pair<IOStatus, bool> result{this->removeAllCanMasks(canMaskType)};
+        return std::make_pair(result.first, 0);
+    }
+    std::string header{(canMaskType == CanMaskType::POSITIVE) ? SET_POSITIVE_CAN_MASKS_HEADER : SET_NEGATIVE_CAN_MASKS_HEADER};
+    std::string stringToSend{header};
+    for (auto &it : ids) {
+        stringToSend += ":0x" + toHexString(it);
+    }
+    stringToSend += TERMINATING_CHARACTER;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(header, i);
+        std::vector<std::string> states{genericIOTask(stringToSend, header, this->m_streamSendDelay)};
+        if (states.size() != SET_CAN_MASKS_RETURN_SIZE) {
+            continue;
+        }
+        if ((states.at(CanMask::CAN_MASK_OPERATION_RESULT) == OPERATION_FAILURE_STRING) || (states.at(CanMask::CAN_MASK_RETURN_STATE) != std::to_string(ids.size()))) {
+            continue;
         }
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, ids.size());
     }
-    return false;
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
 }
 
-bool Arduino::isValidDigitalOutputPin(int pinNumber) const
+/* Installs canFilter on the streaming receive path. If the firmware's mask lists can hold it
+ * exactly (exact IDs only, few enough to fit, and no ID 0, which the firmware uses to mark an
+ * empty slot) it is pushed there as well, so rejected frames never cross the link. Otherwise the
+ * firmware's lists are cleared and the host does all of the filtering. The bool in the result
+ * says whether the firmware is filtering */
+std::pair<IOStatus, bool> Arduino::setCanFilter(const CanFilter &canFilter)
 {
-    for (auto &it : this->m_availableAnalogPins) {
-        if (pinNumber == it) {
-            return true;
+    {
+        std::lock_guard<std::mutex> ioLock{this->m_ioMutex};
+        *this->m_canFilter = canFilter;
+    }
+    std::vector<uint32_t> positiveIDs{canFilter.ids(CanMaskType::POSITIVE)};
+    std::vector<uint32_t> negativeIDs{canFilter.ids(CanMaskType::NEGATIVE)};
+    bool firmwareFiltering{canFilter.hasOnlyIDs() &&
+                           (positiveIDs.size() <= FIRMWARE_CAN_MASK_SLOTS) &&
+                           (negativeIDs.size() <= FIRMWARE_CAN_MASK_SLOTS) &&
+                           (std::find(positiveIDs.begin(), positiveIDs.end(), 0) == positiveIDs.end()) &&
+                           (std::find(negativeIDs.begin(), negativeIDs.end(), 0) == negativeIDs.end())};
+    if (!firmwareFiltering) {
+        positiveIDs.clear();
+        negativeIDs.clear();
+    }
+    if ((this->setCanMasks(CanMaskType::POSITIVE, positiveIDs).first == IOStatus::OPERATION_FAILURE) ||
+        (this->setCanMasks(CanMaskType::NEGATIVE, negativeIDs).first == IOStatus::OPERATION_FAILURE)) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, false);
+    }
+    return std::make_pair(IOStatus::OPERATION_SUCCESS, firmwareFiltering);
+}
+
+std::pair<IOStatus, std::vector<std::pair<IOStatus, bool>>> Arduino::digitalReadMany(const std::vector<int> &pinNumbers)
+{
+    std::vector<std::pair<IOStatus, int>> results{genericMultiIOTask(static_cast<std::string>(DIGITAL_READ_MULTI_HEADER), pinNumbers, std::vector<std::string>(pinNumbers.size(), ""))};
+    std::vector<std::pair<IOStatus, bool>> states;
+    IOStatus ioStatus{IOStatus::OPERATION_SUCCESS};
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results.at(i).first != IOStatus::OPERATION_SUCCESS) {
+            ioStatus = IOStatus::OPERATION_FAILURE;
+        }
+        this->recordPinState(pinNumbers.at(i), IOType::DIGITAL_INPUT, results.at(i));
+        states.push_back(std::make_pair(results.at(i).first, results.at(i).second == 1));
+    }
+    return std::make_pair(ioStatus, states);
+}
+
+std::pair<IOStatus, std::vector<std::pair<IOStatus, bool>>> Arduino::digitalWriteMany(const std::vector<std::pair<int, bool>> &pinStates)
+{
+    std::vector<int> pinNumbers;
+    std::vector<std::string> pinArguments;
+    for (auto &it : pinStates) {
+        pinNumbers.push_back(it.first);
+        pinArguments.push_back(":" + std::to_string(it.second));
+    }
+    std::vector<std::pair<IOStatus, int>> results{genericMultiIOTask(static_cast<std::string>(DIGITAL_WRITE_MULTI_HEADER), pinNumbers, pinArguments)};
+    std::vector<std::pair<IOStatus, bool>> states;
+    IOStatus ioStatus{IOStatus::OPERATION_SUCCESS};
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results.at(i).first != IOStatus::OPERATION_SUCCESS) {
+            ioStatus = IOStatus::OPERATION_FAILURE;
+        }
+        this->recordPinState(pinNumbers.at(i), IOType::DIGITAL_OUTPUT, results.at(i));
+        states.push_back(std::make_pair(results.at(i).first, results.at(i).second == 1));
+    }
+    return std::make_pair(ioStatus, states);
+}
+
+std::pair<IOStatus, std::vector<std::pair<IOStatus, double>>> Arduino::analogReadMany(const std::vector<int> &pinNumbers)
+{
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, int>>> results{analogReadRawMany(pinNumbers)};
+    std::vector<std::pair<IOStatus, double>> states;
+    for (auto &it : results.second) {
+        states.push_back(std::make_pair(it.first, (it.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(it.second) : 0.00));
+    }
+    return std::make_pair(results.first, states);
+}
+
+std::pair<IOStatus, std::vector<std::pair<IOStatus, int>>> Arduino::analogReadRawMany(const std::vector<int> &pinNumbers)
+{
+    std::vector<std::pair<IOStatus, int>> results{genericMultiIOTask(static_cast<std::string>(ANALOG_READ_MULTI_HEADER), pinNumbers, std::vector<std::string>(pinNumbers.size(), ""))};
+    IOStatus ioStatus{IOStatus::OPERATION_SUCCESS};
+    for (size_t i = 0; i < results.size(); i++) {
+        if (results.at(i).first != IOStatus::OPERATION_SUCCESS) {
+            ioStatus = IOStatus::OPERATION_FAILURE;
         }
+        this->recordPinState(pinNumbers.at(i), IOType::ANALOG_INPUT, results.at(i));
     }
-    for (auto &it : this->m_availablePins) {
-        if (pinNumber == it) {
-            return true;
+    return std::make_pair(ioStatus, results);
+}
+
+//The request length limit alone keeps every batch within MULTI_IO_MAXIMUM_PINS_PER_REQUEST pins
+static_assert(IOResponseFields::capacity() >= (MULTI_IO_MAXIMUM_PINS_PER_REQUEST * MULTI_IO_STATE_RETURN_SIZE) + 1, "IOResponseFields cannot hold the reply to a full multi request batch");
+
+/* Sends one multi request frame per batch of pins (batches are only split when the request would
+ * not fit in the firmware's read buffer) and unpacks the pin:state:result triplets of the reply.
+ * The returned vector lines up with pinNumbers, pins that could not be read are OPERATION_FAILURE */
+std::vector<std::pair<IOStatus, int>> Arduino::genericMultiIOTask(const std::string &header, const std::vector<int> &pinNumbers, const std::vector<std::string> &pinArguments)
+{
+    std::vector<std::pair<IOStatus, int>> results(pinNumbers.size(), std::make_pair(IOStatus::OPERATION_FAILURE, 0));
+    IOResponseFields fields;
+    size_t batchStart{0};
+    while (batchStart < pinNumbers.size()) {
+        std::string stringToSend{header};
+        size_t batchEnd{batchStart};
+        while (batchEnd < pinNumbers.size()) {
+            std::string item{":" + std::to_string(pinNumbers.at(batchEnd)) + pinArguments.at(batchEnd)};
+            if ((batchEnd != batchStart) && (stringToSend.length() + item.length() + 1 > MULTI_IO_MAXIMUM_REQUEST_LENGTH)) {
+                break;
+            }
+            stringToSend += item;
+            batchEnd++;
+        }
+        stringToSend += LINE_ENDING;
+        for (int i = 0; i < this->m_ioTryCount; i++) {
+            this->m_ioMetrics.recordAttempt(header, i);
+            if (!genericIOTask(stringToSend, header, this->m_streamSendDelay, &fields)) {
+                continue;
+            }
+            if (fields.size() != ((batchEnd - batchStart) * MULTI_IO_STATE_RETURN_SIZE) + 1) {
+                continue;
+            }
+            bool validResponse{true};
+            for (size_t pin = batchStart; pin < batchEnd; pin++) {
+                size_t offset{(pin - batchStart) * MULTI_IO_STATE_RETURN_SIZE};
+                int returnedPinNumber{0};
+                if ((!fields[offset + IOState::PIN_NUMBER].toInt(&returnedPinNumber)) || (returnedPinNumber != pinNumbers.at(pin))) {
+                    validResponse = false;
+                    break;
+                }
+            }
+            if (!validResponse) {
+                continue;
+            }
+            for (size_t pin = batchStart; pin < batchEnd; pin++) {
+                size_t offset{(pin - batchStart) * MULTI_IO_STATE_RETURN_SIZE};
+                int state{0};
+                if ((fields[offset + IOState::RETURN_CODE] == OPERATION_SUCCESS_STRING) && (fields[offset + IOState::STATE].toInt(&state))) {
+                    results.at(pin) = std::make_pair(IOStatus::OPERATION_SUCCESS, state);
+                }
+            }
+            break;
         }
+        batchStart = batchEnd;
     }
-    return false;
+    return results;
 }
 
-bool Arduino::isValidDigitalInputPin(int pinNumber) const
+std::future<std::pair<IOStatus, bool>> Arduino::digitalReadAsync(int pinNumber)
 {
-    for (auto &it : this->m_availableAnalogPins) {
-        if (pinNumber == it) {
-            return true;
+    std::string stringToSend{static_cast<std::string>(DIGITAL_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+    std::shared_ptr<std::promise<std::pair<IOStatus, bool>>> promise{std::make_shared<std::promise<std::pair<IOStatus, bool>>>()};
+    this->genericAsyncIOTask(stringToSend, static_cast<std::string>(DIGITAL_READ_HEADER), std::to_string(pinNumber), [this, promise, pinNumber](const std::vector<std::string> &states) {
+        std::pair<IOStatus, int> result{parseIOStateResponse(pinNumber, states)};
+        this->recordPinState(pinNumber, IOType::DIGITAL_INPUT, result);
+        promise->set_value(std::make_pair(result.first, result.second == 1));
+    });
+    return promise->get_future();
+}
+
+std::future<std::pair<IOStatus, bool>> Arduino::digitalWriteAsync(int pinNumber, bool state)
+{
+    std::string stringToSend{static_cast<std::string>(DIGITAL_WRITE_HEADER) + ":" + std::to_string(pinNumber) + ":" + std::to_string(state) + LINE_ENDING};
+    std::shared_ptr<std::promise<std::pair<IOStatus, bool>>> promise{std::make_shared<std::promise<std::pair<IOStatus, bool>>>()};
+    this->genericAsyncIOTask(stringToSend, static_cast<std::string>(DIGITAL_WRITE_HEADER), std::to_string(pinNumber), [this, promise, pinNumber](const std::vector<std::string> &states) {
+        std::pair<IOStatus, int> result{parseIOStateResponse(pinNumber, states)};
+        this->recordPinState(pinNumber, IOType::DIGITAL_OUTPUT, result);
+        promise->set_value(std::make_pair(result.first, result.second == 1));
+    });
+    return promise->get_future();
+}
+
+std::future<std::pair<IOStatus, double>> Arduino::analogReadAsync(int pinNumber)
+{
+    std::string stringToSend{static_cast<std::string>(ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+    std::shared_ptr<std::promise<std::pair<IOStatus, double>>> promise{std::make_shared<std::promise<std::pair<IOStatus, double>>>()};
+    this->genericAsyncIOTask(stringToSend, static_cast<std::string>(ANALOG_READ_HEADER), std::to_string(pinNumber), [this, promise, pinNumber](const std::vector<std::string> &states) {
+        std::pair<IOStatus, int> result{parseIOStateResponse(pinNumber, states)};
+        this->recordPinState(pinNumber, IOType::ANALOG_INPUT, result);
+        promise->set_value(std::make_pair(result.first, (result.first == IOStatus::OPERATION_SUCCESS) ? analogToVoltage(result.second) : 0.00));
+    });
+    return promise->get_future();
+}
+
+std::future<std::pair<IOStatus, int>> Arduino::analogReadRawAsync(int pinNumber)
+{
+    std::string stringToSend{static_cast<std::string>(ANALOG_READ_HEADER) + ":" + std::to_string(pinNumber) + LINE_ENDING};
+    std::shared_ptr<std::promise<std::pair<IOStatus, int>>> promise{std::make_shared<std::promise<std::pair<IOStatus, int>>>()};
+    this->genericAsyncIOTask(stringToSend, static_cast<std::string>(ANALOG_READ_HEADER), std::to_string(pinNumber), [this, promise, pinNumber](const std::vector<std::string> &states) {
+        std::pair<IOStatus, int> result{parseIOStateResponse(pinNumber, states)};
+        this->recordPinState(pinNumber, IOType::ANALOG_INPUT, result);
+        promise->set_value(result);
+    });
+    return promise->get_future();
+}
+
+std::pair<IOStatus, ProtocolMode> Arduino::negotiateProtocolMode(ProtocolMode protocolMode)
+{
+    std::string stringToSend{static_cast<std::string>(BINARY_MODE_HEADER) + ":" + std::to_string(protocolMode == ProtocolMode::BINARY) + LINE_ENDING};
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(BINARY_MODE_HEADER, i);
+        std::vector<std::string> states{genericIOTask(stringToSend, static_cast<std::string>(BINARY_MODE_HEADER), this->m_streamSendDelay)};
+        if (states.size() != BINARY_MODE_RETURN_SIZE) {
+            continue;
+        }
+        if (states.at(ArduinoTypeEnum::OPERATION_RESULT) != OPERATION_SUCCESS_STRING) {
+            continue;
+        }
+        if (states.at(ArduinoTypeEnum::RETURN_STATE) != std::to_string(protocolMode == ProtocolMode::BINARY)) {
+            continue;
         }
+        this->m_protocolMode = protocolMode;
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, this->m_protocolMode);
     }
-    for (auto &it : this->m_availablePins) {
-        if (pinNumber == it) {
-            return true;
+    //Older firmware answers {invalid, so keep talking ASCII to it
+    return std::make_pair(IOStatus::OPERATION_FAILURE, this->m_protocolMode);
+}
+
+ProtocolMode Arduino::protocolMode() const
+{
+    return this->m_protocolMode;
+}
+
+/* Binary requests are counted in the metrics under the header of their ASCII equivalent */
+static std::string binaryOpcodeHeader(uint8_t opcode)
+{
+    switch (opcode) {
+        case BinaryFrame::DIGITAL_READ: return DIGITAL_READ_HEADER;
+        case BinaryFrame::DIGITAL_WRITE: return DIGITAL_WRITE_HEADER;
+        case BinaryFrame::ANALOG_READ: return ANALOG_READ_HEADER;
+        case BinaryFrame::ANALOG_WRITE: return ANALOG_WRITE_HEADER;
+        case BinaryFrame::SOFT_DIGITAL_READ: return SOFT_DIGITAL_READ_HEADER;
+        case BinaryFrame::SOFT_ANALOG_READ: return SOFT_ANALOG_READ_HEADER;
+        default: return INVALID_HEADER;
+    }
+}
+
+std::vector<uint8_t> Arduino::genericBinaryIOTask(uint8_t opcode, const std::vector<uint8_t> &payload, double delay)
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->waitForExclusiveIO(ioLock);
+    if (!this->m_ioStream->isOpen()) {
+        this->openIOStream();
+    }
+    long tempTimeout{this->m_ioStream->timeout()};
+    std::string frameToSend{BinaryFrame::encode(opcode, payload)};
+    std::chrono::steady_clock::time_point sentTime{std::chrono::steady_clock::now()};
+    this->m_ioStream->writeString(frameToSend);
+    double timeLimit{this->timeLimitForDelay(delay)};
+    std::string received{""};
+    std::vector<uint8_t> responsePayload;
+    bool matched{false};
+    EventTimer eventTimer;
+    eventTimer.start();
+    while (eventTimer.totalMilliseconds() < timeLimit) {
+        this->m_ioStream->setTimeout(static_cast<long>(timeLimit - eventTimer.totalMilliseconds()) + 1);
+        std::string str{this->m_ioStream->readString()};
+        eventTimer.update();
+        if (str == "") {
+            GeneralUtilities::delayMilliseconds(1);
+            eventTimer.update();
+            continue;
         }
+        received += str;
+        uint8_t responseOpcode{0};
+        while (BinaryFrame::extractFrame(received, &responseOpcode, &responsePayload)) {
+            if ((responseOpcode == (opcode | BinaryFrame::RESPONSE_FLAG)) || (responseOpcode == (BinaryFrame::INVALID_OPCODE | BinaryFrame::RESPONSE_FLAG))) {
+                matched = true;
+                break;
+            }
+        }
+        if (matched) {
+            break;
+        }
+        responsePayload.clear();
     }
-    return false;
+    this->m_ioStream->setTimeout(tempTimeout);
+    if (matched) {
+        this->m_roundTripEstimator.addSample(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sentTime).count());
+    } else {
+        this->m_roundTripEstimator.addTimeout();
+    }
+    size_t bytesReceived{matched ? (BinaryFrame::HEADER_SIZE + responsePayload.size() + BinaryFrame::CRC_SIZE) : 0};
+    this->m_ioMetrics.recordExchange(binaryOpcodeHeader(opcode), frameToSend.length(), bytesReceived, std::chrono::steady_clock::now() - sentTime, !matched);
+    return responsePayload;
 }
 
-bool Arduino::isValidAnalogOutputPin(int pinNumber) const
+/* Binary equivalent of the {header:pin:state:result} requests: the reply payload is the pin,
+ * the state (one byte, or two for analog requests) and the signed result code */
+std::pair<IOStatus, int> Arduino::binaryIOStateRequest(uint8_t opcode, int pinNumber, const std::vector<uint8_t> &arguments)
 {
-    for (auto &it : this->m_availablePwmPins) {
-        if (pinNumber == it) {
-            return true;
+    if ((pinNumber < 0) || (pinNumber > std::numeric_limits<uint8_t>::max())) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    std::vector<uint8_t> payload{static_cast<uint8_t>(pinNumber)};
+    payload.insert(payload.end(), arguments.begin(), arguments.end());
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(binaryOpcodeHeader(opcode), i);
+        std::vector<uint8_t> response{genericBinaryIOTask(opcode, payload, this->m_streamSendDelay)};
+        if ((response.size() != IO_STATE_RETURN_SIZE) && (response.size() != IO_STATE_RETURN_SIZE + 1)) {
+            continue;
+        }
+        if (response.at(0) != pinNumber) {
+            continue;
+        }
+        if (static_cast<int8_t>(response.back()) != OPERATION_SUCCESS_CODE) {
+            return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
         }
+        int state{(response.size() == IO_STATE_RETURN_SIZE) ? response.at(1) : BinaryFrame::getUInt16(response.data() + 1)};
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state);
     }
-    return false;
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
 }
 
-bool Arduino::isValidAnalogInputPin(int pinNumber) const
+/* Shared request loop for the {header:pin:state:result} commands. The response is tokenized in
+ * place and the pin and state are converted straight from the field views */
+std::pair<IOStatus, int> Arduino::ioStateRequest(const std::string &stringToSend, const std::string &header, int pinNumber)
+{
+    IOResponseFields fields;
+    for (int i = 0; i < this->m_ioTryCount; i++) {
+        this->m_ioMetrics.recordAttempt(header, i);
+        if (!genericIOTask(stringToSend, header, this->m_streamSendDelay, &fields)) {
+            continue;
+        }
+        if (fields.size() != IO_STATE_RETURN_SIZE) {
+            continue;
+        }
+        int returnedPinNumber{0};
+        if ((!fields[IOState::PIN_NUMBER].toInt(&returnedPinNumber)) || (returnedPinNumber != pinNumber)) {
+            continue;
+        }
+        if (fields[IOState::RETURN_CODE] == OPERATION_FAILURE_STRING) {
+            continue;
+        }
+        int state{0};
+        if (!fields[IOState::STATE].toInt(&state)) {
+            continue;
+        }
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, state);
+    }
+    return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+}
+
+std::pair<IOStatus, int> Arduino::parseIOStateResponse(int pinNumber, const std::vector<std::string> &states)
+{
+    if (states.size() != IO_STATE_RETURN_SIZE) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    if (std::to_string(pinNumber) != states.at(IOState::PIN_NUMBER)) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    if (states.at(IOState::RETURN_CODE) == OPERATION_FAILURE_STRING) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+    try {
+        return std::make_pair(IOStatus::OPERATION_SUCCESS, GeneralUtilities::decStringToInt(states.at(IOState::STATE)));
+    } catch (std::exception &e) {
+        (void)e;
+        return std::make_pair(IOStatus::OPERATION_FAILURE, 0);
+    }
+}
+
+/* Writes the command immediately (waiting only while the in flight window is full) and queues
+ * the request for the reader thread, which matches replies by header and pin number in FIFO order.
+ * onResponse is called from the reader thread with the parsed reply fields, or with an empty
+ * vector if no reply arrived before the request's deadline */
+void Arduino::genericAsyncIOTask(const std::string &stringToSend, const std::string &header, const std::string &pinNumber, std::function<void(const std::vector<std::string> &)> onResponse)
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    this->m_ioCondition.wait(ioLock, [this]() { return this->m_inFlightRequests.size() < this->m_maximumInFlightCommands; });
+    if (!this->m_ioStream->isOpen()) {
+        this->openIOStream();
+    }
+    this->startAsyncReader();
+    this->m_ioStream->writeLine(stringToSend);
+    this->m_ioMetrics.recordAttempt(header, 0);
+    //The firmware answers pipelined commands in order, so allow one round trip for each command queued ahead of this one
+    double queuedTime{this->m_roundTripEstimator.smoothedRoundTripTime() * this->m_inFlightRequests.size()};
+    std::chrono::milliseconds timeLimit{static_cast<long>(this->timeLimitForDelay(this->m_streamSendDelay) + queuedTime)};
+    std::chrono::steady_clock::time_point sentTime{std::chrono::steady_clock::now()};
+    this->m_inFlightRequests.push_back(AsyncIORequest{header, pinNumber, sentTime, sentTime + timeLimit, stringToSend.length(), onResponse});
+    this->m_ioCondition.notify_all();
+}
+
+/* Synchronous callers read the stream themselves, so they wait until no pipelined command is
+ * outstanding and the reader thread is not blocked on a read. While IO reports are subscribed
+ * the reader would otherwise read continuously, so it also stands aside while anyone waits here */
+void Arduino::waitForExclusiveIO(std::unique_lock<std::mutex> &ioLock)
+{
+    this->m_exclusiveIOWaiters++;
+    this->m_ioCondition.wait(ioLock, [this]() { return this->m_inFlightRequests.empty() && !this->m_asyncReaderBusy; });
+    this->m_exclusiveIOWaiters--;
+    //The rest of any partial frame the reader buffered will be consumed by this caller
+    this->m_asyncReadBuffer = "";
+    if (this->m_exclusiveIOWaiters == 0) {
+        //A reader that stood aside would otherwise sleep until the next notification, it resumes
+        //streaming as soon as this caller releases the lock
+        this->m_ioCondition.notify_all();
+    }
+}
+
+void Arduino::startAsyncReader()
+{
+    if (this->m_asyncReaderRunning) {
+        return;
+    }
+    if (this->m_asyncReaderThread.joinable()) {
+        this->m_asyncReaderThread.join();
+    }
+    this->m_asyncReaderRunning = true;
+    this->m_asyncReadBuffer = "";
+    this->m_asyncReaderThread = std::thread{&Arduino::asyncReaderLoop, this};
+}
+
+void Arduino::asyncReaderLoop()
+{
+    std::unique_lock<std::mutex> ioLock{this->m_ioMutex};
+    while (this->m_asyncReaderRunning) {
+        this->m_ioCondition.wait(ioLock, [this]() {
+            return !this->m_asyncReaderRunning || !this->m_inFlightRequests.empty() || ((this->m_ioReportsSubscribed || this->m_canStreaming) && (this->m_exclusiveIOWaiters == 0));
+        });
+        if (!this->m_asyncReaderRunning) {
+            break;
+        }
+        //Writers may keep adding commands while we block on the stream, but synchronous
+        //callers stay out while m_asyncReaderBusy is set, so nothing else reads from it
+        this->m_asyncReaderBusy = true;
+        ioLock.unlock();
+        long tempTimeout{this->m_ioStream->timeout()};
+        this->m_ioStream->setTimeout(ASYNC_READER_POLL_TIME);
+        std::string received{this->m_ioStream->readUntil(TERMINATING_CHARACTER)};
+        this->m_ioStream->setTimeout(tempTimeout);
+        ioLock.lock();
+        this->m_asyncReaderBusy = false;
+        this->m_asyncReadBuffer += received;
+        size_t frameEnd{this->m_asyncReadBuffer.find(TERMINATING_CHARACTER)};
+        while (frameEnd != std::string::npos) {
+            //A frame starts at the last '{' before its terminator, anything in front of that is a fragment
+            size_t frameStart{this->m_asyncReadBuffer.rfind('{', frameEnd)};
+            if (frameStart != std::string::npos) {
+                this->dispatchAsyncResponse(this->m_asyncReadBuffer.substr(frameStart, frameEnd - frameStart + 1));
+            }
+            this->m_asyncReadBuffer = this->m_asyncReadBuffer.substr(frameEnd + 1);
+            frameEnd = this->m_asyncReadBuffer.find(TERMINATING_CHARACTER);
+        }
+        size_t frameStart{this->m_asyncReadBuffer.rfind('{')};
+        if (frameStart == std::string::npos) {
+            this->m_asyncReadBuffer = "";
+        } else if (frameStart != 0) {
+            this->m_asyncReadBuffer = this->m_asyncReadBuffer.substr(frameStart);
+        }
+        this->expireAsyncRequests(false);
+        this->m_ioCondition.notify_all();
+        if (!this->m_pendingIOReportFrames.empty()) {
+            //Run the callback unlocked so it is free to issue commands of its own
+            std::vector<std::string> frames{std::move(this->m_pendingIOReportFrames)};
+            this->m_pendingIOReportFrames.clear();
+            std::function<void(const IOReport &)> onIOReport{this->m_onIOReport};
+            ioLock.unlock();
+            for (auto &it : frames) {
+                IOReport ioReport;
+                if ((!this->m_ioReportFields.parse(std::move(it), IO_STREAM_HEADER, ':', TERMINATING_CHARACTER, LINE_ENDING)) || (!this->parseIOReportFields(this->m_ioReportFields, &ioReport))) {
+                    continue;
+                }
+                this->recordIOReport(ioReport);
+                ioLock.lock();
+                this->m_ioReportCache->merge(ioReport);
+                IOReport mergedReport{*this->m_ioReportCache};
+                ioLock.unlock();
+                if (onIOReport) {
+                    onIOReport(mergedReport);
+                }
+            }
+            ioLock.lock();
+        }
+    }
+}
+
+void Arduino::dispatchAsyncResponse(std::string &&frame)
+{
+    size_t headerEnd{frame.find(':')};
+    if (headerEnd == std::string::npos) {
+        headerEnd = frame.length() - 1;
+    }
+    std::string header{frame.substr(0, headerEnd)};
+    if (header == IO_STREAM_HEADER) {
+        this->m_ioMetrics.recordUnsolicited(header, frame.length());
+        if (this->m_ioReportsSubscribed) {
+            this->m_pendingIOReportFrames.push_back(std::move(frame));
+        }
+        return;
+    }
+    if ((header == CAN_BATCH_HEADER) && (this->m_canStreaming)) {
+        this->queueCanStreamBatch(std::move(frame));
+        return;
+    }
+    if ((header == CAN_READ_HEADER) && (this->m_canStreaming)) {
+        bool requested{std::any_of(this->m_inFlightRequests.begin(), this->m_inFlightRequests.end(), [](const AsyncIORequest &request) { return request.header == CAN_READ_HEADER; })};
+        if (!requested) {
+            this->queueCanStreamFrame(std::move(frame));
+            return;
+        }
+    }
+    std::string body{frame.substr(headerEnd, frame.length() - 1 - headerEnd)};
+    if ((body.length() > 0) && (body[0] == ':')) {
+        body = body.substr(1);
+    }
+    std::vector<std::string> states{GeneralUtilities::parseToContainer<std::vector<std::string>>(body.begin(), body.end(), ':')};
+    for (auto it = this->m_inFlightRequests.begin(); it != this->m_inFlightRequests.end(); it++) {
+        if (it->header != header) {
+            continue;
+        }
+        if ((it->pinNumber != "") && ((states.size() == 0) || (states.at(IOState::PIN_NUMBER) != it->pinNumber))) {
+            continue;
+        }
+        this->m_ioMetrics.recordExchange(it->header, it->bytesSent, frame.length(), std::chrono::steady_clock::now() - it->sentTime, false);
+        it->onResponse(states);
+        this->m_inFlightRequests.erase(it);
+        return;
+    }
+}
+
+void Arduino::expireAsyncRequests(bool expireAll)
+{
+    std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+    for (auto it = this->m_inFlightRequests.begin(); it != this->m_inFlightRequests.end(); ) {
+        if (expireAll || (it->deadline < now)) {
+            this->m_ioMetrics.recordExchange(it->header, it->bytesSent, 0, now - it->sentTime, true);
+            it->onResponse(std::vector<std::string>{});
+            it = this->m_inFlightRequests.erase(it);
+        } else {
+            it++;
+        }
+    }
+}
+
+static bool isDigitalIOType(IOType ioType)
+{
+    return ((ioType == IOType::DIGITAL_INPUT) || (ioType == IOType::DIGITAL_INPUT_PULLUP) || (ioType == IOType::DIGITAL_OUTPUT));
+}
+
+static bool isAnalogIOType(IOType ioType)
+{
+    return ((ioType == IOType::ANALOG_INPUT) || (ioType == IOType::ANALOG_OUTPUT));
+}
+
+/* The firmware switches a pin to the type of the last plain read or write on it, so a successful
+ * reply tells us both the pin's type and its state. A digital read keeps a pullup input a pullup */
+void Arduino::recordPinState(int pinNumber, IOType ioType, const std::pair<IOStatus, int> &result)
+{
+    if (result.first != IOStatus::OPERATION_SUCCESS) {
+        return;
+    }
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    auto found = this->m_gpioPins.find(pinNumber);
+    if (found == this->m_gpioPins.end()) {
+        return;
+    }
+    if ((ioType != IOType::DIGITAL_INPUT) || (found->second->ioType() != IOType::DIGITAL_INPUT_PULLUP)) {
+        found->second->setIOType(ioType);
+    }
+    found->second->setState(result.second);
+}
+
+/* Soft reads do not change the pin type, so they only refresh a state of the matching kind */
+void Arduino::recordSoftPinState(int pinNumber, bool analogState, const std::pair<IOStatus, int> &result)
+{
+    if (result.first != IOStatus::OPERATION_SUCCESS) {
+        return;
+    }
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    auto found = this->m_gpioPins.find(pinNumber);
+    if (found == this->m_gpioPins.end()) {
+        return;
+    }
+    if ((analogState) ? isAnalogIOType(found->second->ioType()) : isDigitalIOType(found->second->ioType())) {
+        found->second->setState(result.second);
+    }
+}
+
+void Arduino::recordPinType(int pinNumber, IOType ioType)
 {
-    for (auto &it : this->m_availableAnalogPins) {
-        if (pinNumber == it) {
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    auto found = this->m_gpioPins.find(pinNumber);
+    if (found == this->m_gpioPins.end()) {
+        return;
+    }
+    if (found->second->ioType() != ioType) {
+        found->second->setIOType(ioType);
+        found->second->clearState();
+    }
+}
+
+void Arduino::recordIOReport(const IOReport &ioReport)
+{
+    for (auto &it : ioReport.digitalInputResults()) {
+        this->recordPinState(it.first, IOType::DIGITAL_INPUT, std::make_pair(IOStatus::OPERATION_SUCCESS, static_cast<int>(it.second)));
+    }
+    for (auto &it : ioReport.digitalOutputResults()) {
+        this->recordPinState(it.first, IOType::DIGITAL_OUTPUT, std::make_pair(IOStatus::OPERATION_SUCCESS, static_cast<int>(it.second)));
+    }
+    for (auto &it : ioReport.analogInputResults()) {
+        this->recordPinState(it.first, IOType::ANALOG_INPUT, std::make_pair(IOStatus::OPERATION_SUCCESS, it.second));
+    }
+    for (auto &it : ioReport.analogOutputResults()) {
+        this->recordPinState(it.first, IOType::ANALOG_OUTPUT, std::make_pair(IOStatus::OPERATION_SUCCESS, it.second));
+    }
+}
+
+/* Looks up a cached state of the requested kind (digital or analog) that readPolicy allows
+ * using. Returns false if the caller has to go to the board instead */
+bool Arduino::cachedPinState(int pinNumber, bool analogState, const ReadPolicy &readPolicy, int *state)
+{
+    if (readPolicy.cacheMode() == CacheMode::FORCE_REFRESH) {
+        return false;
+    }
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    auto found = this->m_gpioPins.find(pinNumber);
+    if ((found == this->m_gpioPins.end()) || (!found->second->hasState())) {
+        return false;
+    }
+    if ((analogState) ? !isAnalogIOType(found->second->ioType()) : !isDigitalIOType(found->second->ioType())) {
+        return false;
+    }
+    if (readPolicy.cacheMode() == CacheMode::MAXIMUM_AGE) {
+        std::chrono::steady_clock::duration age{std::chrono::steady_clock::now() - found->second->stateTime()};
+        if (age > std::chrono::milliseconds{readPolicy.maximumAge()}) {
+            return false;
+        }
+    }
+    *state = found->second->state();
+    return true;
+}
+
+std::map<std::string, IOCommandMetrics> Arduino::ioMetrics() const
+{
+    return this->m_ioMetrics.snapshot();
+}
+
+IOCommandMetrics Arduino::ioMetrics(const std::string &header) const
+{
+    return this->m_ioMetrics.snapshot(header);
+}
+
+std::string Arduino::ioMetricsReport() const
+{
+    return this->m_ioMetrics.toString();
+}
+
+void Arduino::resetIOMetrics()
+{
+    this->m_ioMetrics.reset();
+}
+
+void Arduino::invalidatePinState(int pinNumber)
+{
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    auto found = this->m_gpioPins.find(pinNumber);
+    if (found != this->m_gpioPins.end()) {
+        found->second->clearState();
+    }
+}
+
+void Arduino::invalidatePinStates()
+{
+    std::lock_guard<std::mutex> pinStateLock{this->m_pinStateMutex};
+    for (auto &it : this->m_gpioPins) {
+        it.second->clearState();
+    }
+}
+
+bool Arduino::isValidAnalogPinIdentifier(const std::string &state) const
+{
+    for (auto &it : this->m_availableAnalogPins.pinNumbers()) {
+        if (state == analogPinFromNumber(this->m_arduinoType, it)) {
             return true;
         }
     }
     return false;
 }
 
+bool Arduino::isValidDigitalOutputPin(int pinNumber) const
+{
+    return (this->m_availableAnalogPins.test(pinNumber) || this->m_availablePins.test(pinNumber));
+}
+
+bool Arduino::isValidDigitalInputPin(int pinNumber) const
+{
+    return (this->m_availableAnalogPins.test(pinNumber) || this->m_availablePins.test(pinNumber));
+}
+
+bool Arduino::isValidAnalogOutputPin(int pinNumber) const
+{
+    return this->m_availablePwmPins.test(pinNumber);
+}
+
+bool Arduino::isValidAnalogInputPin(int pinNumber) const
+{
+    return this->m_availableAnalogPins.test(pinNumber);
+}
+
 std::set<int> Arduino::AVAILABLE_ANALOG_PINS() const
 {
-    return this->m_availableAnalogPins;
+    return this->m_availableAnalogPins.pinNumbers();
 }
 
 std::set<int> Arduino::AVAILABLE_PWM_PINS() const
 {
-    return this->m_availablePwmPins;
+    return this->m_availablePwmPins.pinNumbers();
 }
 
 std::set<int> Arduino::AVAILABLE_PINS() const
 {
-    return this->m_availablePins;
+    return this->m_availablePins.pinNumbers();
 }
 
 int Arduino::NUMBER_OF_DIGITAL_PINS() const
@@ -1425,31 +2597,36 @@ int Arduino::NUMBER_OF_DIGITAL_PINS() const
     return this->m_numberOfDigitalPins;
 }
 
-std::set<int> ArduinoUno::s_availableAnalogPins{14, 15, 16, 17, 18, 19};
-std::set<int> ArduinoUno::s_availablePwmPins{3, 5, 6, 9, 10, 11};
-std::set<int> ArduinoUno::s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+constexpr int PinMask::MAXIMUM_PIN_NUMBER;
+
+std::set<int> PinMask::pinNumbers() const
+{
+    std::set<int> pinNumbers;
+    for (int pinNumber = 0; pinNumber < MAXIMUM_PIN_NUMBER; pinNumber++) {
+        if (this->test(pinNumber)) {
+            pinNumbers.emplace_hint(pinNumbers.end(), pinNumber);
+        }
+    }
+    return pinNumbers;
+}
+
+constexpr PinMask ArduinoUno::s_availableAnalogPins;
+constexpr PinMask ArduinoUno::s_availablePwmPins;
+constexpr PinMask ArduinoUno::s_availablePins;
 const char *ArduinoUno::IDENTIFIER{"arduino_uno"};
 const char *ArduinoUno::LONG_NAME{"Arduino Uno"};
 int ArduinoUno::s_numberOfDigitalPins{13};
 
-std::set<int> ArduinoNano::s_availableAnalogPins{14, 15, 16, 17, 18, 19, 20, 21};
-std::set<int> ArduinoNano::s_availablePwmPins{3, 5, 6, 9, 10, 11};
-std::set<int> ArduinoNano::s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21};
+constexpr PinMask ArduinoNano::s_availableAnalogPins;
+constexpr PinMask ArduinoNano::s_availablePwmPins;
+constexpr PinMask ArduinoNano::s_availablePins;
 const char *ArduinoNano::IDENTIFIER{"arduino_nano"};
 const char *ArduinoNano::LONG_NAME{"Arduino Nano"};
 int ArduinoNano::s_numberOfDigitalPins{13};
 
-std::set<int> ArduinoMega::s_availableAnalogPins{54, 55, 56, 57, 58, 59, 60, 61,
-                                                 62, 63, 64, 65, 66, 67, 68, 69};
-std::set<int> ArduinoMega::s_availablePwmPins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 44, 45, 46};
-std::set<int> ArduinoMega::s_availablePins{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
-                                           13, 14, 15, 16, 17, 18, 19, 20, 21,
-                                           22, 23, 24, 25, 26, 27, 28, 29, 30,
-                                           31, 32, 33, 34, 35, 36, 37, 38, 39,
-                                           40, 41, 42, 43, 44, 45, 46, 47, 48,
-                                           49, 50, 51, 52, 53, 54, 55, 56, 57,
-                                           58, 59, 60, 61, 62, 63, 64, 65, 66,
-                                           67, 68, 69};
+constexpr PinMask ArduinoMega::s_availableAnalogPins;
+constexpr PinMask ArduinoMega::s_availablePwmPins;
+constexpr PinMask ArduinoMega::s_availablePins;
 const char *ArduinoMega::IDENTIFIER{"arduino_mega"};
 const char *ArduinoMega::LONG_NAME{"Arduino Mega"};
 int ArduinoMega::s_numberOfDigitalPins{53};
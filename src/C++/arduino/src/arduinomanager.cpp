@@ -0,0 +1,180 @@
+#include "arduinomanager.h"
+
+const char *ArduinoManager::NO_ARDUINO_ON_PORT_STRING{"No Arduino is managed on serial port "};
+
+ArduinoManager::ArduinoManager() :
+    m_boardsMutex{},
+    m_boards{}
+{
+
+}
+
+ArduinoManager::~ArduinoManager()
+{
+    //Each BoardWorker finishes its queued work before its thread is joined
+    std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+    this->m_boards.clear();
+}
+
+bool ArduinoManager::addArduino(std::shared_ptr<Arduino> arduino)
+{
+    if (!arduino) {
+        return false;
+    }
+    std::string serialPortName{arduino->serialPortName()};
+    std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+    if (this->m_boards.find(serialPortName) != this->m_boards.end()) {
+        return false;
+    }
+    this->m_boards.emplace(serialPortName, std::make_unique<BoardWorker>(arduino));
+    return true;
+}
+
+/* Constructs an Arduino on each stream at the same time, so the firmware readiness probes of
+ * all the boards overlap, and adds the ones that connected. Returns how many were added */
+size_t ArduinoManager::connectArduinos(const std::vector<std::pair<ArduinoType, std::shared_ptr<TStream>>> &ioStreams)
+{
+    std::vector<std::future<std::shared_ptr<Arduino>>> connections;
+    for (auto &it : ioStreams) {
+        connections.push_back(std::async(std::launch::async, [it]() {
+            return std::make_shared<Arduino>(it.first, it.second);
+        }));
+    }
+    size_t added{0};
+    for (auto &it : connections) {
+        try {
+            if (this->addArduino(it.get())) {
+                added++;
+            }
+        } catch (std::exception &e) {
+            (void)e;
+        }
+    }
+    return added;
+}
+
+bool ArduinoManager::removeArduino(const std::string &serialPortName)
+{
+    std::unique_ptr<BoardWorker> removed{nullptr};
+    {
+        std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+        auto found = this->m_boards.find(serialPortName);
+        if (found == this->m_boards.end()) {
+            return false;
+        }
+        removed = std::move(found->second);
+        this->m_boards.erase(found);
+    }
+    //Joined outside the lock, so the other boards can keep taking work while this one drains
+    removed.reset();
+    return true;
+}
+
+std::shared_ptr<Arduino> ArduinoManager::arduino(const std::string &serialPortName) const
+{
+    std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+    auto found = this->m_boards.find(serialPortName);
+    return ((found == this->m_boards.end()) ? nullptr : found->second->arduino());
+}
+
+std::vector<std::string> ArduinoManager::serialPortNames() const
+{
+    std::vector<std::string> returnVector;
+    std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+    for (auto &it : this->m_boards) {
+        returnVector.push_back(it.first);
+    }
+    return returnVector;
+}
+
+size_t ArduinoManager::size() const
+{
+    std::lock_guard<std::mutex> boardsLock{this->m_boardsMutex};
+    return this->m_boards.size();
+}
+
+std::map<std::string, std::pair<IOStatus, bool>> ArduinoManager::digitalRead(int pinNumber)
+{
+    return this->dispatchAndWait<std::pair<IOStatus, bool>>([pinNumber](Arduino &arduino) {
+        return arduino.digitalRead(pinNumber);
+    });
+}
+
+std::map<std::string, std::pair<IOStatus, bool>> ArduinoManager::digitalWrite(int pinNumber, bool state)
+{
+    return this->dispatchAndWait<std::pair<IOStatus, bool>>([pinNumber, state](Arduino &arduino) {
+        return arduino.digitalWrite(pinNumber, state);
+    });
+}
+
+std::map<std::string, std::pair<IOStatus, std::vector<int>>> ArduinoManager::digitalWriteAll(bool state)
+{
+    return this->dispatchAndWait<std::pair<IOStatus, std::vector<int>>>([state](Arduino &arduino) {
+        return arduino.digitalWriteAll(state);
+    });
+}
+
+std::map<std::string, std::pair<IOStatus, int>> ArduinoManager::analogReadRaw(int pinNumber)
+{
+    return this->dispatchAndWait<std::pair<IOStatus, int>>([pinNumber](Arduino &arduino) {
+        return arduino.analogReadRaw(pinNumber);
+    });
+}
+
+std::map<std::string, IOReport> ArduinoManager::ioReportRequest()
+{
+    return this->dispatchAndWait<IOReport>([](Arduino &arduino) {
+        return arduino.ioReportRequest();
+    });
+}
+
+std::map<std::string, std::pair<IOStatus, std::string>> ArduinoManager::firmwareVersion()
+{
+    return this->dispatchAndWait<std::pair<IOStatus, std::string>>([](Arduino &arduino) {
+        return arduino.firmwareVersion();
+    });
+}
+
+ArduinoManager::BoardWorker::BoardWorker(std::shared_ptr<Arduino> arduino) :
+    m_arduino{arduino},
+    m_taskMutex{},
+    m_taskCondition{},
+    m_tasks{},
+    m_running{true},
+    m_thread{}
+{
+    this->m_thread = std::thread{&BoardWorker::run, this};
+}
+
+ArduinoManager::BoardWorker::~BoardWorker()
+{
+    {
+        std::lock_guard<std::mutex> taskLock{this->m_taskMutex};
+        this->m_running = false;
+        this->m_taskCondition.notify_one();
+    }
+    if (this->m_thread.joinable()) {
+        this->m_thread.join();
+    }
+}
+
+std::shared_ptr<Arduino> ArduinoManager::BoardWorker::arduino() const
+{
+    return this->m_arduino;
+}
+
+void ArduinoManager::BoardWorker::run()
+{
+    std::unique_lock<std::mutex> taskLock{this->m_taskMutex};
+    while (true) {
+        this->m_taskCondition.wait(taskLock, [this]() { return (!this->m_running || !this->m_tasks.empty()); });
+        if (this->m_tasks.empty()) {
+            return;
+        }
+        std::function<void()> task{std::move(this->m_tasks.front())};
+        this->m_tasks.pop_front();
+        taskLock.unlock();
+        task();
+        taskLock.lock();
+    }
+}
@@ -0,0 +1,68 @@
+#include "binaryframe.h"
+
+namespace BinaryFrame
+{
+    uint8_t crc8(const uint8_t *data, size_t length, uint8_t crc)
+    {
+        for (size_t i = 0; i < length; i++) {
+            crc ^= data[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+            }
+        }
+        return crc;
+    }
+
+    std::string encode(uint8_t opcode, const std::vector<uint8_t> &payload)
+    {
+        std::vector<uint8_t> frame{SYNC, opcode, static_cast<uint8_t>(payload.size())};
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        frame.push_back(crc8(frame.data() + OPCODE_OFFSET, frame.size() - OPCODE_OFFSET));
+        return std::string{frame.begin(), frame.end()};
+    }
+
+    /* Pulls the first complete, CRC valid frame out of buffer, discarding any bytes in
+     * front of it. Returns false (leaving a possible partial frame in buffer) otherwise */
+    bool extractFrame(std::string &buffer, uint8_t *opcode, std::vector<uint8_t> *payload)
+    {
+        while (true) {
+            size_t syncPosition{buffer.find(static_cast<char>(SYNC))};
+            if (syncPosition == std::string::npos) {
+                buffer.clear();
+                return false;
+            }
+            buffer.erase(0, syncPosition);
+            if (buffer.length() < HEADER_SIZE) {
+                return false;
+            }
+            const uint8_t *frame{reinterpret_cast<const uint8_t *>(buffer.data())};
+            size_t length{frame[LENGTH_OFFSET]};
+            if (length > MAXIMUM_PAYLOAD) {
+                buffer.erase(0, 1);
+                continue;
+            }
+            if (buffer.length() < HEADER_SIZE + length + CRC_SIZE) {
+                return false;
+            }
+            if (crc8(frame + OPCODE_OFFSET, length + 2) != frame[PAYLOAD_OFFSET + length]) {
+                buffer.erase(0, 1);
+                continue;
+            }
+            *opcode = frame[OPCODE_OFFSET];
+            payload->assign(frame + PAYLOAD_OFFSET, frame + PAYLOAD_OFFSET + length);
+            buffer.erase(0, HEADER_SIZE + length + CRC_SIZE);
+            return true;
+        }
+    }
+
+    void appendUInt16(std::vector<uint8_t> &out, uint16_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value & 0xFF));
+        out.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+    }
+
+    uint16_t getUInt16(const uint8_t *in)
+    {
+        return static_cast<uint16_t>(in[0] | (in[1] << 8));
+    }
+}
@@ -0,0 +1,553 @@
+#include "buscapture.h"
+
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+static uint64_t microsecondsSinceEpoch()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+static bool isValidHeader(const BusCaptureFileHeader &header)
+{
+    return ((std::memcmp(header.magic, BUS_CAPTURE_MAGIC, sizeof(header.magic)) == 0) &&
+            (header.byteOrderMark == BUS_CAPTURE_BYTE_ORDER_MARK) &&
+            (header.version == BUS_CAPTURE_VERSION) &&
+            (header.recordSize == sizeof(BusCaptureRecord)));
+}
+
+BusCaptureWriter::BusCaptureWriter(const std::string &filePath) :
+    m_filePath{filePath},
+    m_file{},
+    m_startTime{0},
+    m_timestampOffset{0},
+    m_openTime{std::chrono::steady_clock::now()},
+    m_records{std::make_unique<RingBuffer<BusCaptureRecord, BUS_CAPTURE_RING_SIZE>>()},
+    m_producerMutex{},
+    m_fileMutex{},
+    m_batch{},
+    m_runMutex{},
+    m_runCondition{},
+    m_running{true},
+    m_captured{0},
+    m_dropped{0},
+    m_writerThread{}
+{
+    //An existing capture is appended to, continuing its timeline so the records stay sorted
+    this->m_file.open(filePath, std::ios::in | std::ios::out | std::ios::binary);
+    if (!this->m_file.is_open()) {
+        this->m_file.clear();
+        this->m_file.open(filePath, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+    }
+    if (!this->m_file.is_open()) {
+        throw std::runtime_error(BUS_CAPTURE_OPEN_FAILED_STRING + filePath);
+    }
+    this->m_file.seekg(0, std::ios::end);
+    uint64_t fileSize{static_cast<uint64_t>(this->m_file.tellg())};
+    uint64_t recordCount{0};
+    if (fileSize == 0) {
+        BusCaptureFileHeader header{};
+        std::memcpy(header.magic, BUS_CAPTURE_MAGIC, sizeof(header.magic));
+        header.byteOrderMark = BUS_CAPTURE_BYTE_ORDER_MARK;
+        header.version = BUS_CAPTURE_VERSION;
+        header.recordSize = sizeof(BusCaptureRecord);
+        header.startTime = microsecondsSinceEpoch();
+        this->m_file.seekp(0);
+        this->m_file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        this->m_startTime = header.startTime;
+    } else {
+        BusCaptureFileHeader header{};
+        this->m_file.seekg(0);
+        if ((fileSize < sizeof(header)) || (!this->m_file.read(reinterpret_cast<char *>(&header), sizeof(header))) || (!isValidHeader(header))) {
+            throw std::runtime_error(BUS_CAPTURE_INVALID_FILE_STRING + filePath);
+        }
+        this->m_startTime = header.startTime;
+        uint64_t now{microsecondsSinceEpoch()};
+        this->m_timestampOffset = ((now > header.startTime) ? (now - header.startTime) : 0);
+        recordCount = (fileSize - sizeof(header)) / sizeof(BusCaptureRecord);
+        if (recordCount != 0) {
+            BusCaptureRecord lastRecord{};
+            this->m_file.seekg(sizeof(header) + ((recordCount - 1) * sizeof(BusCaptureRecord)));
+            if (this->m_file.read(reinterpret_cast<char *>(&lastRecord), sizeof(lastRecord))) {
+                this->m_timestampOffset = std::max(this->m_timestampOffset, lastRecord.timestamp);
+            }
+        }
+    }
+    //Any partial record left at the end by a crash gets overwritten
+    this->m_file.clear();
+    this->m_file.seekp(sizeof(BusCaptureFileHeader) + (recordCount * sizeof(BusCaptureRecord)));
+    this->m_file.flush();
+    if (!this->m_file) {
+        throw std::runtime_error(BUS_CAPTURE_OPEN_FAILED_STRING + filePath);
+    }
+    this->m_writerThread = std::thread{&BusCaptureWriter::run, this};
+}
+
+BusCaptureWriter::~BusCaptureWriter()
+{
+    {
+        std::lock_guard<std::mutex> runLock{this->m_runMutex};
+        this->m_running = false;
+        this->m_runCondition.notify_one();
+    }
+    if (this->m_writerThread.joinable()) {
+        this->m_writerThread.join();
+    }
+    this->drain();
+}
+
+bool BusCaptureWriter::captureCanMessage(const CanMessage &message, bool transmitted)
+{
+    uint8_t flags{static_cast<uint8_t>((transmitted ? BUS_CAPTURE_TRANSMITTED : 0) | ((message.frame() == CAN_EXTENDED_FRAME) ? BUS_CAPTURE_EXTENDED_ID : 0))};
+    return this->capture(CaptureBus::CAN, message.id(), flags, message.dataPacket().dataPacket().data(), message.length());
+}
+
+/* Never blocks on the file: the frame is stamped and queued, and the writer thread writes it out.
+ * Returns false if the queue was full and the frame was dropped */
+bool BusCaptureWriter::capture(CaptureBus bus, uint32_t id, uint8_t flags, const uint8_t *data, uint8_t length)
+{
+    BusCaptureRecord record{};
+    record.id = id;
+    record.bus = static_cast<uint8_t>(bus);
+    record.flags = flags;
+    record.length = std::min(length, static_cast<uint8_t>(sizeof(record.data)));
+    std::memcpy(record.data, data, record.length);
+    //Stamped under the lock so records from different threads enter the ring in timestamp order
+    std::lock_guard<std::mutex> producerLock{this->m_producerMutex};
+    record.timestamp = this->m_timestampOffset + static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - this->m_openTime).count());
+    if (!this->m_records->tryPush(record)) {
+        this->m_dropped++;
+        return false;
+    }
+    this->m_captured++;
+    return true;
+}
+
+//Writes out everything queued so far
+void BusCaptureWriter::flush()
+{
+    this->drain();
+}
+
+std::string BusCaptureWriter::filePath() const
+{
+    return this->m_filePath;
+}
+
+uint64_t BusCaptureWriter::startTime() const
+{
+    return this->m_startTime;
+}
+
+uint64_t BusCaptureWriter::captured() const
+{
+    return this->m_captured.load();
+}
+
+uint64_t BusCaptureWriter::dropped() const
+{
+    return this->m_dropped.load();
+}
+
+void BusCaptureWriter::run()
+{
+    std::unique_lock<std::mutex> runLock{this->m_runMutex};
+    while (this->m_running) {
+        runLock.unlock();
+        size_t written{this->drain()};
+        runLock.lock();
+        if ((written == 0) && (this->m_running)) {
+            this->m_runCondition.wait_for(runLock, std::chrono::milliseconds{BUS_CAPTURE_WRITE_INTERVAL});
+        }
+    }
+}
+
+//The ring's consumer side. m_fileMutex keeps flush() and the writer thread from draining at once
+size_t BusCaptureWriter::drain()
+{
+    std::lock_guard<std::mutex> fileLock{this->m_fileMutex};
+    size_t written{0};
+    while (true) {
+        size_t batched{0};
+        while ((batched < this->m_batch.size()) && (this->m_records->tryPop(&this->m_batch[batched]))) {
+            batched++;
+        }
+        if (batched == 0) {
+            break;
+        }
+        this->m_file.write(reinterpret_cast<const char *>(this->m_batch.data()), batched * sizeof(BusCaptureRecord));
+        written += batched;
+    }
+    if (written != 0) {
+        this->m_file.flush();
+    }
+    return written;
+}
+
+BusCaptureReader::BusCaptureReader(const std::string &filePath) :
+    m_filePath{filePath},
+    m_file{filePath, std::ios::in | std::ios::binary},
+    m_header{},
+    m_size{0}
+{
+    if (!this->m_file.is_open()) {
+        throw std::runtime_error(BUS_CAPTURE_OPEN_FAILED_STRING + filePath);
+    }
+    if ((!this->m_file.read(reinterpret_cast<char *>(&this->m_header), sizeof(this->m_header))) || (!isValidHeader(this->m_header))) {
+        throw std::runtime_error(BUS_CAPTURE_INVALID_FILE_STRING + filePath);
+    }
+    this->refresh();
+}
+
+std::string BusCaptureReader::filePath() const
+{
+    return this->m_filePath;
+}
+
+uint64_t BusCaptureReader::startTime() const
+{
+    return this->m_header.startTime;
+}
+
+uint64_t BusCaptureReader::size() const
+{
+    return this->m_size;
+}
+
+//Picks up records appended since the file was opened, so a capture can be read while it is written
+void BusCaptureReader::refresh()
+{
+    this->m_file.clear();
+    this->m_file.seekg(0, std::ios::end);
+    uint64_t fileSize{static_cast<uint64_t>(this->m_file.tellg())};
+    this->m_size = ((fileSize > sizeof(BusCaptureFileHeader)) ? ((fileSize - sizeof(BusCaptureFileHeader)) / sizeof(BusCaptureRecord)) : 0);
+}
+
+bool BusCaptureReader::read(uint64_t index, BusCaptureRecord *record)
+{
+    return (this->read(index, record, 1) == 1);
+}
+
+size_t BusCaptureReader::read(uint64_t index, BusCaptureRecord *records, size_t maximumRecords)
+{
+    if (index >= this->m_size) {
+        return 0;
+    }
+    size_t count{static_cast<size_t>(std::min(static_cast<uint64_t>(maximumRecords), this->m_size - index))};
+    this->m_file.clear();
+    this->m_file.seekg(sizeof(BusCaptureFileHeader) + (index * sizeof(BusCaptureRecord)));
+    this->m_file.read(reinterpret_cast<char *>(records), count * sizeof(BusCaptureRecord));
+    return static_cast<size_t>(this->m_file.gcount()) / sizeof(BusCaptureRecord);
+}
+
+//Index of the first record at or after timestamp (size() if there is none)
+uint64_t BusCaptureReader::seek(uint64_t timestamp)
+{
+    uint64_t low{0};
+    uint64_t high{this->m_size};
+    while (low < high) {
+        uint64_t middle{low + ((high - low) / 2)};
+        BusCaptureRecord record{};
+        if (!this->read(middle, &record)) {
+            break;
+        }
+        if (record.timestamp < timestamp) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+BusCaptureReplayStream::BusCaptureReplayStream(std::shared_ptr<BusCaptureReader> reader, double speed) :
+    m_reader{reader},
+    m_speed{std::max(speed, 0.00)},
+    m_replayMutex{},
+    m_replayCondition{},
+    m_isOpen{false},
+    m_timeout{BUS_CAPTURE_REPLAY_DEFAULT_TIMEOUT},
+    m_lineEnding{"\n"},
+    m_liveUpdate{false},
+    m_output{""},
+    m_nextIndex{0},
+    m_firstTimestamp{0},
+    m_replayStart{std::chrono::steady_clock::now()},
+    m_readAhead{},
+    m_readAheadIndex{0},
+    m_readAheadSize{0}
+{
+    if (!this->m_reader) {
+        throw std::runtime_error(BUS_CAPTURE_NO_READER_STRING);
+    }
+}
+
+//Restarts the replay clock from the first record at or after timestamp
+void BusCaptureReplayStream::seek(uint64_t timestamp)
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_reader->refresh();
+    this->m_nextIndex = this->m_reader->seek(timestamp);
+    this->m_firstTimestamp = timestamp;
+    this->m_replayStart = std::chrono::steady_clock::now();
+}
+
+double BusCaptureReplayStream::speed() const
+{
+    return this->m_speed;
+}
+
+bool BusCaptureReplayStream::finished()
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    BusCaptureRecord record{};
+    return ((this->m_output.empty()) && (!this->nextReplayableRecord(&record)));
+}
+
+ssize_t BusCaptureReplayStream::writeLine(const std::string &str)
+{
+    return this->writeString(str + this->lineEnding());
+}
+
+ssize_t BusCaptureReplayStream::writeString(const std::string &str)
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    size_t commandStart{0};
+    while (commandStart < str.length()) {
+        size_t commandEnd{str.find_first_of("\r\n", commandStart)};
+        if (commandEnd == std::string::npos) {
+            commandEnd = str.length();
+        }
+        if (commandEnd > commandStart) {
+            this->handleCommand(str.substr(commandStart, commandEnd - commandStart));
+        }
+        commandStart = commandEnd + 1;
+    }
+    this->m_replayCondition.notify_all();
+    return static_cast<ssize_t>(str.length());
+}
+
+std::string BusCaptureReplayStream::readLine(bool *timeout)
+{
+    return this->readUntilMatch(this->lineEnding(), timeout);
+}
+
+std::string BusCaptureReplayStream::readUntil(const std::string &until, bool *timeout)
+{
+    return this->readUntilMatch(until, timeout);
+}
+
+std::string BusCaptureReplayStream::readUntil(char until, bool *timeout)
+{
+    return this->readUntilMatch(std::string(1, until), timeout);
+}
+
+//Returns whatever is waiting to be read, without waiting for more
+std::string BusCaptureReplayStream::readString(int maximumSize)
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->pumpLiveUpdates(std::chrono::steady_clock::now());
+    size_t length{(maximumSize < 0) ? this->m_output.length() : std::min(static_cast<size_t>(maximumSize), this->m_output.length())};
+    std::string returnString{this->m_output.substr(0, length)};
+    this->m_output.erase(0, length);
+    return returnString;
+}
+
+int BusCaptureReplayStream::available()
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->pumpLiveUpdates(std::chrono::steady_clock::now());
+    return static_cast<int>(this->m_output.length());
+}
+
+void BusCaptureReplayStream::openPort()
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_reader->refresh();
+    if (this->m_nextIndex == 0) {
+        //Start the clock at the first frame rather than at the moment the capture was created
+        BusCaptureRecord record{};
+        this->m_firstTimestamp = (this->m_reader->read(0, &record) ? record.timestamp : 0);
+    }
+    this->m_readAheadSize = 0;
+    this->m_output.clear();
+    this->m_liveUpdate = false;
+    this->m_replayStart = std::chrono::steady_clock::now();
+    this->m_isOpen = true;
+}
+
+void BusCaptureReplayStream::closePort()
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_isOpen = false;
+    this->m_liveUpdate = false;
+    this->m_output.clear();
+    this->m_replayCondition.notify_all();
+}
+
+bool BusCaptureReplayStream::isOpen() const
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    return this->m_isOpen;
+}
+
+std::string BusCaptureReplayStream::portName() const
+{
+    return BUS_CAPTURE_REPLAY_PORT_NAME_PREFIX + this->m_reader->filePath();
+}
+
+void BusCaptureReplayStream::setTimeout(long timeout)
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_timeout = timeout;
+}
+
+long BusCaptureReplayStream::timeout() const
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    return this->m_timeout;
+}
+
+void BusCaptureReplayStream::setLineEnding(const std::string &lineEnding)
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_lineEnding = lineEnding;
+}
+
+std::string BusCaptureReplayStream::lineEnding() const
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    return this->m_lineEnding;
+}
+
+void BusCaptureReplayStream::flushRx()
+{
+    std::lock_guard<std::mutex> replayLock{this->m_replayMutex};
+    this->m_output.clear();
+}
+
+//Peeks at the next received CAN record, skipping anything the firmware would not have reported
+bool BusCaptureReplayStream::nextReplayableRecord(BusCaptureRecord *record)
+{
+    while (true) {
+        if ((this->m_nextIndex < this->m_readAheadIndex) || (this->m_nextIndex >= this->m_readAheadIndex + this->m_readAheadSize)) {
+            this->m_readAheadIndex = this->m_nextIndex;
+            this->m_readAheadSize = this->m_reader->read(this->m_nextIndex, this->m_readAhead.data(), this->m_readAhead.size());
+            if (this->m_readAheadSize == 0) {
+                return false;
+            }
+        }
+        *record = this->m_readAhead[this->m_nextIndex - this->m_readAheadIndex];
+        if ((record->bus == static_cast<uint8_t>(CaptureBus::CAN)) && (!(record->flags & BUS_CAPTURE_TRANSMITTED))) {
+            return true;
+        }
+        this->m_nextIndex++;
+    }
+}
+
+bool BusCaptureReplayStream::nextDueFrame(std::chrono::steady_clock::time_point now, std::string *frame)
+{
+    BusCaptureRecord record{};
+    if ((!this->nextReplayableRecord(&record)) || (this->dueTime(record) > now)) {
+        return false;
+    }
+    this->m_nextIndex++;
+    *frame = canReadFrame(record);
+    return true;
+}
+
+std::chrono::steady_clock::time_point BusCaptureReplayStream::dueTime(const BusCaptureRecord &record) const
+{
+    if ((this->m_speed == 0.00) || (record.timestamp <= this->m_firstTimestamp)) {
+        return this->m_replayStart;
+    }
+    std::chrono::duration<double, std::micro> offset{static_cast<double>(record.timestamp - this->m_firstTimestamp) / this->m_speed};
+    return this->m_replayStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+
+//With live update on, every frame that has come due is pushed without being asked for
+void BusCaptureReplayStream::pumpLiveUpdates(std::chrono::steady_clock::time_point now)
+{
+    if ((!this->m_isOpen) || (!this->m_liveUpdate)) {
+        return;
+    }
+    std::string frame{""};
+    while (this->nextDueFrame(now, &frame)) {
+        this->m_output += frame + this->m_lineEnding;
+    }
+}
+
+void BusCaptureReplayStream::handleCommand(const std::string &command)
+{
+    using namespace GeneralUtilities;
+    std::string canLiveUpdatePrefix{static_cast<std::string>(CAN_LIVE_UPDATE_HEADER) + ":"};
+    if (startsWith(command, FIRMWARE_VERSION_HEADER)) {
+        this->m_output += static_cast<std::string>(FIRMWARE_VERSION_HEADER) + ":" + BUS_CAPTURE_REPLAY_FIRMWARE_VERSION + ":" + OPERATION_SUCCESS_STRING + TERMINATING_CHARACTER + this->m_lineEnding;
+    } else if (startsWith(command, canLiveUpdatePrefix) && (command.length() > canLiveUpdatePrefix.length())) {
+        char state{command[canLiveUpdatePrefix.length()]};
+        if ((state != '0') && (state != '1')) {
+            return;
+        }
+        this->m_liveUpdate = (state == '1');
+        this->m_output += canLiveUpdatePrefix + state + ":" + OPERATION_SUCCESS_STRING + TERMINATING_CHARACTER + this->m_lineEnding;
+    } else if (startsWith(command, CAN_READ_HEADER)) {
+        std::string frame{""};
+        if (!this->nextDueFrame(std::chrono::steady_clock::now(), &frame)) {
+            frame = CAN_EMPTY_READ_SUCCESS_STRING;
+        }
+        this->m_output += frame + this->m_lineEnding;
+    }
+}
+
+/* Waits up to the stream timeout for until to show up in the output, waking early when a live
+ * update frame comes due. On timeout, returns (and consumes) whatever was there */
+std::string BusCaptureReplayStream::readUntilMatch(const std::string &until, bool *timeout)
+{
+    std::unique_lock<std::mutex> replayLock{this->m_replayMutex};
+    std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::now() + std::chrono::milliseconds{this->m_timeout}};
+    while (this->m_isOpen) {
+        std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+        this->pumpLiveUpdates(now);
+        size_t found{until.empty() ? std::string::npos : this->m_output.find(until)};
+        if (found != std::string::npos) {
+            std::string returnString{this->m_output.substr(0, found + until.length())};
+            this->m_output.erase(0, found + until.length());
+            if (timeout) {
+                *timeout = false;
+            }
+            return returnString;
+        }
+        if (now >= deadline) {
+            break;
+        }
+        std::chrono::steady_clock::time_point wakeTime{deadline};
+        BusCaptureRecord record{};
+        if ((this->m_liveUpdate) && (this->nextReplayableRecord(&record))) {
+            wakeTime = std::min(wakeTime, this->dueTime(record));
+        }
+        this->m_replayCondition.wait_until(replayLock, wakeTime);
+    }
+    if (timeout) {
+        *timeout = true;
+    }
+    std::string returnString{std::move(this->m_output)};
+    this->m_output.clear();
+    return returnString;
+}
+
+//Formatted the way the firmware reports a received frame, {canread:0x7DF:0x02:...:0x00:1}, with one byte per byte of the record
+std::string BusCaptureReplayStream::canReadFrame(const BusCaptureRecord &record)
+{
+    char frame[BUS_CAPTURE_CAN_READ_FRAME_SIZE];
+    size_t position{0};
+    auto append = [&frame, &position](int written) {
+        position = std::min(position + static_cast<size_t>(std::max(written, 0)), sizeof(frame) - 1);
+    };
+    append(std::snprintf(frame, sizeof(frame), "%s:0x%03X", CAN_READ_HEADER, static_cast<unsigned int>(record.id)));
+    for (uint8_t i = 0; i < std::min(record.length, static_cast<uint8_t>(sizeof(record.data))); i++) {
+        append(std::snprintf(frame + position, sizeof(frame) - position, ":0x%02X", record.data[i]));
+    }
+    append(std::snprintf(frame + position, sizeof(frame) - position, ":%s%c", OPERATION_SUCCESS_STRING, TERMINATING_CHARACTER));
+    return std::string(frame, position);
+}
@@ -0,0 +1,181 @@
+#include "canfilter.h"
+
+#include <algorithm>
+#include <iterator>
+
+CanFilter::CanFilter() :
+    m_positive{},
+    m_negative{}
+{
+
+}
+
+bool CanFilter::addID(CanMaskType canMaskType, uint32_t id)
+{
+    if (id > MAXIMUM_EXTENDED_CAN_ID) {
+        return false;
+    }
+    RuleSet &rules{this->ruleSet(canMaskType)};
+    if (!rules.m_ids.insert(id).second) {
+        return false;
+    }
+    rules.compile();
+    return true;
+}
+
+bool CanFilter::addRange(CanMaskType canMaskType, uint32_t low, uint32_t high)
+{
+    if ((low > high) || (high > MAXIMUM_EXTENDED_CAN_ID)) {
+        return false;
+    }
+    RuleSet &rules{this->ruleSet(canMaskType)};
+    rules.m_ranges.emplace_back(low, high);
+    rules.compile();
+    return true;
+}
+
+//A value with bits outside of mask could never match, so it is rejected
+bool CanFilter::addMask(CanMaskType canMaskType, uint32_t mask, uint32_t value)
+{
+    if ((mask > MAXIMUM_EXTENDED_CAN_ID) || ((value & ~mask) != 0)) {
+        return false;
+    }
+    RuleSet &rules{this->ruleSet(canMaskType)};
+    rules.m_masks.emplace_back(mask, value);
+    rules.compile();
+    return true;
+}
+
+bool CanFilter::removeID(CanMaskType canMaskType, uint32_t id)
+{
+    RuleSet &rules{this->ruleSet(canMaskType)};
+    if (rules.m_ids.erase(id) == 0) {
+        return false;
+    }
+    rules.compile();
+    return true;
+}
+
+void CanFilter::clear(CanMaskType canMaskType)
+{
+    this->ruleSet(canMaskType) = RuleSet{};
+}
+
+void CanFilter::clear()
+{
+    this->m_positive = RuleSet{};
+    this->m_negative = RuleSet{};
+}
+
+bool CanFilter::accepts(uint32_t id) const
+{
+    if (this->m_negative.matches(id)) {
+        return false;
+    }
+    return (this->m_positive.empty() || this->m_positive.matches(id));
+}
+
+bool CanFilter::empty() const
+{
+    return (this->m_positive.empty() && this->m_negative.empty());
+}
+
+//True if the firmware's ID lists can express this filter exactly
+bool CanFilter::hasOnlyIDs() const
+{
+    return (this->m_positive.m_ranges.empty() && this->m_positive.m_masks.empty() &&
+            this->m_negative.m_ranges.empty() && this->m_negative.m_masks.empty());
+}
+
+std::vector<uint32_t> CanFilter::ids(CanMaskType canMaskType) const
+{
+    const RuleSet &rules{this->ruleSet(canMaskType)};
+    return std::vector<uint32_t>{rules.m_ids.begin(), rules.m_ids.end()};
+}
+
+CanFilter::RuleSet &CanFilter::ruleSet(CanMaskType canMaskType)
+{
+    return ((canMaskType == CanMaskType::POSITIVE) ? this->m_positive : this->m_negative);
+}
+
+const CanFilter::RuleSet &CanFilter::ruleSet(CanMaskType canMaskType) const
+{
+    return ((canMaskType == CanMaskType::POSITIVE) ? this->m_positive : this->m_negative);
+}
+
+CanFilter::RuleSet::RuleSet() :
+    m_ids{},
+    m_ranges{},
+    m_masks{},
+    m_standardIDs{},
+    m_extendedIDs{},
+    m_extendedRanges{}
+{
+
+}
+
+bool CanFilter::RuleSet::empty() const
+{
+    return (this->m_ids.empty() && this->m_ranges.empty() && this->m_masks.empty());
+}
+
+bool CanFilter::RuleSet::matches(uint32_t id) const
+{
+    if (id <= MAXIMUM_STANDARD_CAN_ID) {
+        return this->m_standardIDs.test(id);
+    }
+    if (this->m_extendedIDs.find(id) != this->m_extendedIDs.end()) {
+        return true;
+    }
+    //The ranges are sorted and disjoint, so only the last one starting at or below id can hold it
+    auto range = std::upper_bound(this->m_extendedRanges.begin(), this->m_extendedRanges.end(), std::make_pair(id, MAXIMUM_EXTENDED_CAN_ID));
+    if ((range != this->m_extendedRanges.begin()) && (id <= std::prev(range)->second)) {
+        return true;
+    }
+    for (auto &it : this->m_masks) {
+        if ((id & it.first) == it.second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CanFilter::RuleSet::compile()
+{
+    this->m_standardIDs.reset();
+    this->m_extendedIDs.clear();
+    this->m_extendedRanges.clear();
+    for (auto &it : this->m_ids) {
+        if (it <= MAXIMUM_STANDARD_CAN_ID) {
+            this->m_standardIDs.set(it);
+        } else {
+            this->m_extendedIDs.insert(it);
+        }
+    }
+    for (auto &it : this->m_ranges) {
+        for (uint32_t id = it.first; (id <= it.second) && (id <= MAXIMUM_STANDARD_CAN_ID); id++) {
+            this->m_standardIDs.set(id);
+        }
+        if (it.second > MAXIMUM_STANDARD_CAN_ID) {
+            this->m_extendedRanges.emplace_back(std::max(it.first, MAXIMUM_STANDARD_CAN_ID + 1), it.second);
+        }
+    }
+    for (auto &it : this->m_masks) {
+        for (uint32_t id = 0; id <= MAXIMUM_STANDARD_CAN_ID; id++) {
+            if ((id & it.first) == it.second) {
+                this->m_standardIDs.set(id);
+            }
+        }
+    }
+    //Merge overlapping and adjacent ranges so a lookup only has to check one of them
+    std::sort(this->m_extendedRanges.begin(), this->m_extendedRanges.end());
+    std::vector<std::pair<uint32_t, uint32_t>> merged;
+    for (auto &it : this->m_extendedRanges) {
+        if ((!merged.empty()) && (it.first <= merged.back().second + 1)) {
+            merged.back().second = std::max(merged.back().second, it.second);
+        } else {
+            merged.push_back(it);
+        }
+    }
+    this->m_extendedRanges = std::move(merged);
+}
@@ -0,0 +1,184 @@
+#include "iometrics.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+const unsigned int LatencyHistogram::SUB_BUCKET_BITS;
+const unsigned int LatencyHistogram::MAXIMUM_VALUE_BITS;
+const uint64_t LatencyHistogram::SUB_BUCKET_COUNT;
+const uint64_t LatencyHistogram::MAXIMUM_VALUE;
+const size_t LatencyHistogram::BUCKET_COUNT;
+
+LatencyHistogram::LatencyHistogram() :
+    m_counts{},
+    m_count{0},
+    m_minimum{0},
+    m_maximum{0},
+    m_sum{0.00}
+{
+
+}
+
+void LatencyHistogram::record(uint64_t microseconds)
+{
+    uint64_t value{std::min(microseconds, MAXIMUM_VALUE)};
+    this->m_counts[bucketIndex(value)]++;
+    this->m_minimum = ((this->m_count == 0) ? value : std::min(this->m_minimum, value));
+    this->m_maximum = std::max(this->m_maximum, value);
+    this->m_sum += static_cast<double>(value);
+    this->m_count++;
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(std::begin(this->m_counts), std::end(this->m_counts), 0);
+    this->m_count = 0;
+    this->m_minimum = 0;
+    this->m_maximum = 0;
+    this->m_sum = 0.00;
+}
+
+uint64_t LatencyHistogram::count() const
+{
+    return this->m_count;
+}
+
+uint64_t LatencyHistogram::minimum() const
+{
+    return this->m_minimum;
+}
+
+uint64_t LatencyHistogram::maximum() const
+{
+    return this->m_maximum;
+}
+
+double LatencyHistogram::mean() const
+{
+    return ((this->m_count == 0) ? 0.00 : (this->m_sum / static_cast<double>(this->m_count)));
+}
+
+/* Returns the highest value equivalent to the bucket holding the percentile'th recorded value
+ * (clamped to the largest value actually recorded), or 0 if nothing has been recorded */
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (this->m_count == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.00), 100.00);
+    uint64_t target{static_cast<uint64_t>(std::ceil((percentile / 100.00) * static_cast<double>(this->m_count)))};
+    target = std::max(target, static_cast<uint64_t>(1));
+    uint64_t seen{0};
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += this->m_counts[i];
+        if (seen >= target) {
+            return std::min(highestEquivalentValue(i), this->m_maximum);
+        }
+    }
+    return this->m_maximum;
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t value)
+{
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    unsigned int highestBit{0};
+    for (uint64_t shifted = value; shifted > 1; shifted >>= 1) {
+        highestBit++;
+    }
+    unsigned int magnitude{highestBit - (SUB_BUCKET_BITS - 1)};
+    uint64_t subBucket{value >> magnitude};
+    return static_cast<size_t>(SUB_BUCKET_COUNT + ((magnitude - 1) * (SUB_BUCKET_COUNT / 2)) + (subBucket - (SUB_BUCKET_COUNT / 2)));
+}
+
+uint64_t LatencyHistogram::highestEquivalentValue(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return static_cast<uint64_t>(index);
+    }
+    unsigned int magnitude{static_cast<unsigned int>((index - SUB_BUCKET_COUNT) / (SUB_BUCKET_COUNT / 2)) + 1};
+    uint64_t subBucket{((index - SUB_BUCKET_COUNT) % (SUB_BUCKET_COUNT / 2)) + (SUB_BUCKET_COUNT / 2)};
+    return (subBucket << magnitude) + ((static_cast<uint64_t>(1) << magnitude) - 1);
+}
+
+IOMetrics::IOMetrics() :
+    m_metricsMutex{},
+    m_commandMetrics{}
+{
+
+}
+
+void IOMetrics::recordAttempt(const std::string &header, int attempt)
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    IOCommandMetrics &commandMetrics = this->m_commandMetrics[header];
+    if (attempt == 0) {
+        commandMetrics.calls++;
+    } else {
+        commandMetrics.retries++;
+    }
+}
+
+void IOMetrics::recordExchange(const std::string &header, size_t bytesSent, size_t bytesReceived, std::chrono::steady_clock::duration latency, bool timedOut)
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    IOCommandMetrics &commandMetrics = this->m_commandMetrics[header];
+    commandMetrics.exchanges++;
+    commandMetrics.bytesSent += bytesSent;
+    commandMetrics.bytesReceived += bytesReceived;
+    if (timedOut) {
+        commandMetrics.timeouts++;
+    } else {
+        commandMetrics.latency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+    }
+}
+
+void IOMetrics::recordUnsolicited(const std::string &header, size_t bytesReceived)
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    this->m_commandMetrics[header].bytesReceived += bytesReceived;
+}
+
+void IOMetrics::reset()
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    this->m_commandMetrics.clear();
+}
+
+std::map<std::string, IOCommandMetrics> IOMetrics::snapshot() const
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    return this->m_commandMetrics;
+}
+
+IOCommandMetrics IOMetrics::snapshot(const std::string &header) const
+{
+    std::lock_guard<std::mutex> metricsLock{this->m_metricsMutex};
+    auto found = this->m_commandMetrics.find(header);
+    return ((found == this->m_commandMetrics.end()) ? IOCommandMetrics{} : found->second);
+}
+
+/* One line per header, latencies in microseconds (successful exchanges only) */
+std::string IOMetrics::toString() const
+{
+    std::map<std::string, IOCommandMetrics> commandMetrics{this->snapshot()};
+    std::stringstream returnStream;
+    returnStream << std::left << std::setw(18) << "header" << std::right
+                 << std::setw(10) << "calls" << std::setw(9) << "retries" << std::setw(10) << "timeouts"
+                 << std::setw(12) << "sent" << std::setw(12) << "received"
+                 << std::setw(10) << "mean" << std::setw(10) << "p50" << std::setw(10) << "p90"
+                 << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+    for (auto &it : commandMetrics) {
+        const LatencyHistogram &latency = it.second.latency;
+        returnStream << std::left << std::setw(18) << it.first << std::right
+                     << std::setw(10) << it.second.calls << std::setw(9) << it.second.retries << std::setw(10) << it.second.timeouts
+                     << std::setw(12) << it.second.bytesSent << std::setw(12) << it.second.bytesReceived
+                     << std::setw(10) << static_cast<uint64_t>(latency.mean()) << std::setw(10) << latency.valueAtPercentile(50.00)
+                     << std::setw(10) << latency.valueAtPercentile(90.00) << std::setw(10) << latency.valueAtPercentile(99.00)
+                     << std::setw(10) << latency.maximum() << std::endl;
+    }
+    return returnStream.str();
+}
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <iomanip>
+#include <serialport.h>
+#include <tstream.h>
+#include <generalutilities.h>
+#include <arduino.h>
+#include <prettyprinter.h>
+
+static const ForegroundColor FAILURE_COLOR{ForegroundColor::FG_RED};
+static const ForegroundColor SUCCESS_COLOR{ForegroundColor::FG_GREEN};
+static const ForegroundColor LIST_COLOR{ForegroundColor::FG_YELLOW};
+static const int COMMON_ATTRIBUTES{(FontAttribute::FA_BOLD | FontAttribute::FA_UNDERLINED)};
+static const int BENCHMARK_PIN_NUMBER{2};
+static const std::vector<int> BENCHMARK_POLL_PINS{2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+
+template <typename T>
+bool alwaysTrue(T param)
+{
+    (void)param;
+    return true;
+}
+
+double percentile(const std::vector<double> &sortedSamples, double percent)
+{
+    if (sortedSamples.empty()) {
+        return 0;
+    }
+    size_t index{static_cast<size_t>((percent / 100.0) * (sortedSamples.size() - 1) + 0.5)};
+    return sortedSamples.at(index);
+}
+
+void printLatencyReport(PrettyPrinter *prettyPrinter, const std::string &title, std::vector<double> samples, uint32_t failures)
+{
+    std::sort(samples.begin(), samples.end());
+    prettyPrinter->setForegroundColor(LIST_COLOR);
+    prettyPrinter->println(title);
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "    samples = " << samples.size() << ", failures = " << failures << std::endl;
+    std::cout << "    p50 = " << percentile(samples, 50) << "ms" << std::endl;
+    std::cout << "    p90 = " << percentile(samples, 90) << "ms" << std::endl;
+    std::cout << "    p99 = " << percentile(samples, 99) << "ms" << std::endl;
+    std::cout << "    max = " << (samples.empty() ? 0 : samples.back()) << "ms" << std::endl;
+    std::cout << std::endl;
+}
+
+void benchmarkRoundTripLatency(PrettyPrinter *prettyPrinter, Arduino *arduino, IOResponseMode ioResponseMode, const std::string &title, uint32_t iterations)
+{
+    arduino->setIOResponseMode(ioResponseMode);
+    std::vector<double> samples;
+    uint32_t failures{0};
+    for (uint32_t i = 0; i < iterations; i++) {
+        auto startTime = std::chrono::steady_clock::now();
+        auto result = arduino->digitalRead(BENCHMARK_PIN_NUMBER);
+        auto endTime = std::chrono::steady_clock::now();
+        if (result.first == IOStatus::OPERATION_SUCCESS) {
+            samples.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+        } else {
+            failures++;
+        }
+    }
+    printLatencyReport(prettyPrinter, title, samples, failures);
+}
+
+void benchmarkPinPoll(PrettyPrinter *prettyPrinter, Arduino *arduino, bool pipelined, const std::string &title, uint32_t iterations)
+{
+    std::vector<double> samples;
+    uint32_t failures{0};
+    for (uint32_t i = 0; i < iterations; i++) {
+        bool allSucceeded{true};
+        auto startTime = std::chrono::steady_clock::now();
+        if (pipelined) {
+            std::vector<std::future<std::pair<IOStatus, bool>>> results;
+            for (auto &it : BENCHMARK_POLL_PINS) {
+                results.push_back(arduino->digitalReadAsync(it));
+            }
+            for (auto &it : results) {
+                allSucceeded &= (it.get().first == IOStatus::OPERATION_SUCCESS);
+            }
+        } else {
+            for (auto &it : BENCHMARK_POLL_PINS) {
+                allSucceeded &= (arduino->digitalRead(it).first == IOStatus::OPERATION_SUCCESS);
+            }
+        }
+        auto endTime = std::chrono::steady_clock::now();
+        if (allSucceeded) {
+            samples.push_back(std::chrono::duration<double, std::milli>(endTime - startTime).count());
+        } else {
+            failures++;
+        }
+    }
+    printLatencyReport(prettyPrinter, title, samples, failures);
+}
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    std::string serialPortName{SerialPort::doUserSelectSerialPortName()};
+
+    uint32_t iterations{GeneralUtilities::doUserEnterNumericParameter("Round Trip Iterations",
+                                                                      static_cast<std::function<bool(uint32_t)>>(alwaysTrue<uint32_t>),
+                                                                      std::numeric_limits<uint32_t>::min()+1,
+                                                                      std::numeric_limits<uint32_t>::max())};
+
+    std::unique_ptr<PrettyPrinter> prettyPrinter{std::make_unique<PrettyPrinter>()};
+    prettyPrinter->setFontAttributes(COMMON_ATTRIBUTES);
+    prettyPrinter->setForegroundColor(LIST_COLOR);
+    std::cout << "Using SerialPortName=";
+    prettyPrinter->println(serialPortName);
+    std::cout << "Using Iterations=";
+    prettyPrinter->println(iterations);
+    prettyPrinter->println();
+
+    std::shared_ptr<TStream> serialPort{std::make_shared<SerialPort>(serialPortName,
+                                                                     Arduino::FIRMWARE_BAUD_RATE,
+                                                                     Arduino::FIRMWARE_DATA_BITS,
+                                                                     Arduino::FIRMWARE_STOP_BITS,
+                                                                     Arduino::FIRMWARE_PARITY)};
+    std::cout << "Creating Arduino object using serial port " << std::quoted(serialPort->portName()) << "...";
+    std::unique_ptr<Arduino> arduino{std::make_unique<Arduino>(ArduinoType::UNO, serialPort)};
+    prettyPrinter->setForegroundColor(SUCCESS_COLOR);
+    prettyPrinter->println("success");
+    for (auto &it : BENCHMARK_POLL_PINS) {
+        if (arduino->pinMode(it, IOType::DIGITAL_INPUT).first != IOStatus::OPERATION_SUCCESS) {
+            prettyPrinter->setForegroundColor(FAILURE_COLOR);
+            prettyPrinter->println("Could not set benchmark pin " + std::to_string(it) + " to DIGITAL_INPUT, exiting");
+            return 1;
+        }
+    }
+    prettyPrinter->println();
+
+    benchmarkRoundTripLatency(prettyPrinter.get(), arduino.get(), IOResponseMode::SEND_DELAY, "digitalRead round trip (SEND_DELAY):", iterations);
+    benchmarkRoundTripLatency(prettyPrinter.get(), arduino.get(), IOResponseMode::EVENT_DRIVEN, "digitalRead round trip (EVENT_DRIVEN):", iterations);
+    benchmarkPinPoll(prettyPrinter.get(), arduino.get(), false, "Poll " + std::to_string(BENCHMARK_POLL_PINS.size()) + " pins (sequential digitalRead):", iterations);
+    benchmarkPinPoll(prettyPrinter.get(), arduino.get(), true, "Poll " + std::to_string(BENCHMARK_POLL_PINS.size()) + " pins (pipelined digitalReadAsync):", iterations);
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <generalutilities.h>
+#include <arduino.h>
+
+/* Compares the allocations made for each received CAN frame by the old vector backed
+ * CanDataPacket / CanMessage (reproduced below) with the inline std::array backed ones.
+ * Each frame goes through the same steps as a streamed {canread} frame: parsed in place,
+ * decoded into a message, returned by value, queued through a RingBuffer, polled back out
+ * and its data packet read. Allocations are counted by replacing the global operator new */
+
+static unsigned long long allocationCount{0};
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *pointer{malloc(size)};
+    if (!pointer) {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept
+{
+    (void)size;
+    free(pointer);
+}
+
+class LegacyCanDataPacket
+{
+public:
+    LegacyCanDataPacket() :
+        m_dataPacket{std::vector<unsigned char>{0, 0, 0, 0, 0, 0, 0, 0}}
+    {
+
+    }
+
+    LegacyCanDataPacket(const LegacyCanDataPacket &dataPacket) :
+        m_dataPacket{dataPacket.m_dataPacket}
+    {
+
+    }
+
+    LegacyCanDataPacket &operator=(const LegacyCanDataPacket &) = default;
+
+    bool setNthByte(int index, unsigned char nth)
+    {
+        this->m_dataPacket.at(index) = nth;
+        return true;
+    }
+
+    std::vector<unsigned char> dataPacket() const
+    {
+        return this->m_dataPacket;
+    }
+
+private:
+    std::vector<unsigned char> m_dataPacket;
+};
+
+class LegacyCanMessage
+{
+public:
+    LegacyCanMessage() :
+        m_id{0},
+        m_frame{0},
+        m_length{0},
+        m_dataPacket{LegacyCanDataPacket{}}
+    {
+
+    }
+
+    LegacyCanMessage(uint32_t id, uint8_t frame, uint8_t length, const LegacyCanDataPacket &dataPacket) :
+        m_id{id},
+        m_frame{frame},
+        m_length{length},
+        m_dataPacket{dataPacket}
+    {
+
+    }
+
+    bool setDataPacketNthByte(int index, unsigned char nth)
+    {
+        return this->m_dataPacket.setNthByte(index, nth);
+    }
+
+    LegacyCanDataPacket dataPacket() const
+    {
+        return this->m_dataPacket;
+    }
+
+private:
+    uint32_t m_id;
+    uint8_t m_frame;
+    uint8_t m_length;
+    LegacyCanDataPacket m_dataPacket;
+};
+
+static const int ITERATIONS{200000};
+static const size_t BENCHMARK_RING_SIZE{64};
+static const std::string CAN_READ_FRAME{"{canread:0x7DF:0x02:0x01:0x0C:0x00:0x00:0x00:0x00:0x00:1}"};
+
+template <typename Message, typename DataPacket>
+bool decodeCanMessage(const IOResponseFields &fields, Message *message)
+{
+    if (fields.size() != CAN_READ_RETURN_SIZE) {
+        return false;
+    }
+    uint32_t messageID{0};
+    if (!fields[CanIOStatus::MESSAGE_ID].toHexUInt(&messageID)) {
+        return false;
+    }
+    *message = Message{messageID, CAN_FRAME, CAN_MESSAGE_LENGTH, DataPacket()};
+    for (unsigned int byteNumber = CanIOStatus::BYTE_0; byteNumber < CanIOStatus::CAN_IO_OPERATION_RESULT; byteNumber++) {
+        uint32_t byte{0};
+        if (!fields[byteNumber].toHexUInt(&byte)) {
+            return false;
+        }
+        message->setDataPacketNthByte(byteNumber - CanIOStatus::BYTE_0, static_cast<unsigned char>(byte));
+    }
+    return true;
+}
+
+template <typename Message>
+std::pair<IOStatus, Message> receiveCanMessage(const IOResponseFields &fields)
+{
+    Message message;
+    if (!decodeCanMessage<Message, typename std::decay<decltype(message.dataPacket())>::type>(fields, &message)) {
+        return std::make_pair(IOStatus::OPERATION_FAILURE, Message{});
+    }
+    return std::make_pair(IOStatus::OPERATION_SUCCESS, message);
+}
+
+template <typename Message>
+void runBenchmark(const std::string &title)
+{
+    volatile unsigned int sink{0};
+    std::vector<std::string> frames(ITERATIONS, CAN_READ_FRAME);
+    std::unique_ptr<IOResponseFields> fields{std::make_unique<IOResponseFields>()};
+    std::unique_ptr<RingBuffer<Message, BENCHMARK_RING_SIZE>> ring{std::make_unique<RingBuffer<Message, BENCHMARK_RING_SIZE>>()};
+    Message polled;
+
+    //The frame strings stand in for what the reader thread hands over and are built up front
+    unsigned long long startAllocations{allocationCount};
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        fields->parse(std::move(frames[i]), CAN_READ_HEADER, ':', TERMINATING_CHARACTER, LINE_ENDING);
+        std::pair<IOStatus, Message> result{receiveCanMessage<Message>(*fields)};
+        ring->tryPush(result.second);
+        if (ring->tryPop(&polled)) {
+            const auto &dataPacket = polled.dataPacket();
+            sink = sink + dataPacket.dataPacket()[2];
+        }
+    }
+    auto endTime = std::chrono::steady_clock::now();
+    double nanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+    double allocations{static_cast<double>(allocationCount - startAllocations) / ITERATIONS};
+
+    std::cout << title << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << nanoseconds << "ns/frame, " << allocations << " allocations/frame" << std::endl;
+    std::cout << std::endl;
+}
+
+int main()
+{
+    std::cout << "CAN receive path (" << std::quoted(CAN_READ_FRAME) << ")" << std::endl << std::endl;
+    runBenchmark<LegacyCanMessage>("vector backed CanDataPacket");
+    runBenchmark<CanMessage>("std::array backed CanDataPacket");
+    return 0;
+}
@@ -0,0 +1,352 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstdio>
+#include <tstream.h>
+#include <generalutilities.h>
+#include <arduino.h>
+#include <buscapture.h>
+
+/* Drives the Arduino class through a scripted stream instead of a board. Every line written to
+ * the stream is answered immediately by a responder, so a request that waits for its reply
+ * longer than a few milliseconds is waiting for something other than the "firmware" */
+
+class ScriptedStream : public TStream
+{
+public:
+    using Responder = std::function<std::string(const std::string &)>;
+
+    explicit ScriptedStream(Responder responder) :
+        m_responder{responder},
+        m_received{""},
+        m_written{},
+        m_isOpen{false},
+        m_timeout{0},
+        m_lineEnding{""},
+        m_activeReads{0},
+        m_overlappedReads{false}
+    {
+
+    }
+
+    ssize_t writeLine(const std::string &str) override
+    {
+        this->m_written.push_back(str);
+        this->m_received += this->m_responder(str);
+        return static_cast<ssize_t>(str.length());
+    }
+
+    ssize_t writeString(const std::string &str) override
+    {
+        return this->writeLine(str);
+    }
+
+    std::string readLine(bool *timeout = nullptr) override
+    {
+        return this->readUntil(this->m_lineEnding, timeout);
+    }
+
+    std::string readUntil(const std::string &until, bool *timeout = nullptr) override
+    {
+        //A real port hands each byte to only one reader, so two at once means someone skipped the IO lock
+        if (++this->m_activeReads > 1) {
+            this->m_overlappedReads = true;
+        }
+        std::string line{this->readUntilUnguarded(until, timeout)};
+        this->m_activeReads--;
+        return line;
+    }
+
+    std::string readUntil(char until, bool *timeout = nullptr) override
+    {
+        return this->readUntil(std::string(1, until), timeout);
+    }
+
+    std::string readString(int max = -1) override
+    {
+        size_t count{(max < 0) ? this->m_received.length() : static_cast<size_t>(max)};
+        std::string str{this->m_received.substr(0, count)};
+        this->m_received = this->m_received.substr(str.length());
+        return str;
+    }
+
+    int available() override { return static_cast<int>(this->m_received.length()); }
+    void openPort() override { this->m_isOpen = true; }
+    void closePort() override { this->m_isOpen = false; }
+    bool isOpen() const override { return this->m_isOpen; }
+    std::string portName() const override { return "scripted"; }
+    void setTimeout(long timeout) override { this->m_timeout = timeout; }
+    long timeout() const override { return this->m_timeout; }
+    void setLineEnding(const std::string &lineEnding) override { this->m_lineEnding = lineEnding; }
+    std::string lineEnding() const override { return this->m_lineEnding; }
+    void flushRx() override { this->m_received = ""; }
+
+    const std::vector<std::string> &written() const { return this->m_written; }
+    void clearWritten() { this->m_written.clear(); }
+    bool overlappedReads() const { return this->m_overlappedReads; }
+
+private:
+    Responder m_responder;
+    std::string m_received;
+    std::vector<std::string> m_written;
+    bool m_isOpen;
+    long m_timeout;
+    std::string m_lineEnding;
+    std::atomic<int> m_activeReads;
+    std::atomic<bool> m_overlappedReads;
+
+    std::string readUntilUnguarded(const std::string &until, bool *timeout)
+    {
+        size_t position{this->m_received.find(until)};
+        if ((until.empty()) || (position == std::string::npos)) {
+            //Nothing more is coming, so a real port would sit out its whole timeout
+            std::this_thread::sleep_for(std::chrono::milliseconds{this->m_timeout});
+            if (timeout) {
+                *timeout = true;
+            }
+            std::string partial{this->m_received};
+            this->m_received = "";
+            return partial;
+        }
+        if (timeout) {
+            *timeout = false;
+        }
+        std::string line{this->m_received.substr(0, position + until.length())};
+        this->m_received = this->m_received.substr(position + until.length());
+        return line;
+    }
+};
+
+static int failures{0};
+
+void check(bool condition, const std::string &description)
+{
+    std::cout << (condition ? "PASS: " : "FAIL: ") << description << std::endl;
+    if (!condition) {
+        failures++;
+    }
+}
+
+template <typename Function>
+double elapsedMilliseconds(Function function)
+{
+    std::chrono::steady_clock::time_point startTime{std::chrono::steady_clock::now()};
+    function();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+/* Answers the version probe and reports every pin of a single or multi pin digital read as high */
+std::string firmwareResponder(const std::string &request)
+{
+    if (GeneralUtilities::startsWith(request, FIRMWARE_VERSION_HEADER)) {
+        return static_cast<std::string>(FIRMWARE_VERSION_HEADER) + ":0.0.1:1}";
+    }
+    if (GeneralUtilities::startsWith(request, static_cast<std::string>(DIGITAL_READ_MULTI_HEADER) + ":")) {
+        std::string pinList{GeneralUtilities::stripAllFromString(request.substr(std::string{DIGITAL_READ_MULTI_HEADER}.length() + 1), LINE_ENDING)};
+        std::string response{DIGITAL_READ_MULTI_HEADER};
+        for (auto &it : GeneralUtilities::parseToContainer<std::vector<std::string>>(pinList.begin(), pinList.end(), ':')) {
+            response += ":" + it + ":1:1";
+        }
+        return response + ":1}";
+    }
+    if (GeneralUtilities::startsWith(request, static_cast<std::string>(DIGITAL_READ_HEADER) + ":")) {
+        std::string pinNumber{request.substr(std::string{DIGITAL_READ_HEADER}.length() + 1)};
+        pinNumber = GeneralUtilities::stripAllFromString(pinNumber, LINE_ENDING);
+        return static_cast<std::string>(DIGITAL_READ_HEADER) + ":" + pinNumber + ":1:1}";
+    }
+    return "";
+}
+
+/* Acknowledges iostream requests, echoing the interval and either the requested mode or, when
+ * echoedMode is not empty, that mode instead */
+ScriptedStream::Responder ioStreamResponder(const std::string &echoedMode)
+{
+    return [echoedMode](const std::string &request) -> std::string {
+        if (!GeneralUtilities::startsWith(request, static_cast<std::string>(IO_STREAM_HEADER) + ":")) {
+            return firmwareResponder(request);
+        }
+        std::string items{GeneralUtilities::stripAllFromString(request.substr(std::string{IO_STREAM_HEADER}.length() + 1), LINE_ENDING)};
+        std::vector<std::string> arguments{GeneralUtilities::parseToContainer<std::vector<std::string>>(items.begin(), items.end(), ':')};
+        std::string mode{(arguments.size() > 1) ? arguments.at(1) : std::to_string(IO_STREAM_PERIODIC_MODE)};
+        return static_cast<std::string>(IO_STREAM_HEADER) + ":" + arguments.at(0) + ":" + (echoedMode.empty() ? mode : echoedMode) + ":1}";
+    };
+}
+
+void testEventDrivenResponseFrame()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(firmwareResponder)};
+    Arduino arduino{ArduinoType::UNO, stream};
+    arduino.setIOResponseMode(IOResponseMode::EVENT_DRIVEN);
+    std::pair<IOStatus, bool> result{IOStatus::OPERATION_FAILURE, false};
+    double elapsed{elapsedMilliseconds([&]() { result = arduino.digitalRead(5); })};
+    check(result.first == IOStatus::OPERATION_SUCCESS, "event driven digitalRead(5) succeeds");
+    check(result.second, "event driven digitalRead(5) returns the state in the reply");
+    check(elapsed < 20, "event driven digitalRead(5) returns as soon as {dread:5:1:1} arrives (" + std::to_string(elapsed) + "ms)");
+}
+
+void testFirmwareReadyProbe()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(firmwareResponder)};
+    std::unique_ptr<Arduino> arduino{nullptr};
+    double elapsed{elapsedMilliseconds([&]() { arduino = std::make_unique<Arduino>(ArduinoType::UNO, stream); })};
+    check(stream->written().size() == 1, "constructor sends one version probe when the firmware answers it (" + std::to_string(stream->written().size()) + " sent)");
+    check(elapsed < FIRMWARE_READY_PROBE_SETTLE_TIME + 40, "constructor returns once the firmware answered instead of after BOOTLOADER_BOOT_TIME (" + std::to_string(elapsed) + "ms)");
+}
+
+void testFullMegaMultiRead()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(firmwareResponder)};
+    Arduino arduino{ArduinoType::MEGA, stream};
+    std::vector<int> pinNumbers;
+    for (int pinNumber = 2; pinNumber <= 69; pinNumber++) {
+        pinNumbers.push_back(pinNumber);
+    }
+    std::pair<IOStatus, std::vector<std::pair<IOStatus, bool>>> result{arduino.digitalReadMany(pinNumbers)};
+    size_t succeeded{static_cast<size_t>(std::count_if(result.second.begin(), result.second.end(), [](const std::pair<IOStatus, bool> &state) { return state.first == IOStatus::OPERATION_SUCCESS; }))};
+    check(result.first == IOStatus::OPERATION_SUCCESS, "digitalReadMany over Mega pins 2 to 69 succeeds");
+    check(succeeded == pinNumbers.size(), "digitalReadMany over Mega pins 2 to 69 reads every pin (" + std::to_string(succeeded) + " of " + std::to_string(pinNumbers.size()) + ")");
+}
+
+void testDeltaIOReportSubscription()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(ioStreamResponder(""))};
+    Arduino arduino{ArduinoType::UNO, stream};
+    stream->clearWritten();
+    std::pair<IOStatus, unsigned int> result{arduino.subscribeIOReports(50, IOStreamMode::DELTA, nullptr)};
+    std::vector<std::string> written{stream->written()};
+    check(result.first == IOStatus::OPERATION_SUCCESS, "subscribeIOReports in DELTA mode succeeds when the firmware echoes mode 2");
+    check((written.size() == 1) && (written.at(0) == static_cast<std::string>(IO_STREAM_HEADER) + ":50:2" + LINE_ENDING), "subscribeIOReports in DELTA mode sends mode 2 after the interval");
+    check(arduino.unsubscribeIOReports() == IOStatus::OPERATION_SUCCESS, "unsubscribeIOReports succeeds when the firmware echoes the periodic mode");
+
+    std::shared_ptr<ScriptedStream> mismatchedStream{std::make_shared<ScriptedStream>(ioStreamResponder(std::to_string(IO_STREAM_ON_CHANGE_MODE)))};
+    Arduino mismatchedArduino{ArduinoType::UNO, mismatchedStream};
+    check(mismatchedArduino.subscribeIOReports(50, IOStreamMode::DELTA, nullptr).first == IOStatus::OPERATION_FAILURE, "subscribeIOReports in DELTA mode fails when the firmware echoes a different mode");
+}
+
+/* Answers like ioStreamResponder, but ends every reply with LINE_ENDING (as SEND_DELAY mode reads
+ * up to it) and, once reports are streaming, pushes a report ahead of each reply */
+std::string streamingResponder(const std::string &request)
+{
+    static bool streaming{false};
+    std::string reply{ioStreamResponder("")(request) + LINE_ENDING};
+    std::string pushedReport{static_cast<std::string>(IO_STREAM_HEADER) + ":5:" + DIGITAL_INPUT_IDENTIFIER + ":1:" + IO_STREAM_END_IDENTIFIER + TERMINATING_CHARACTER + LINE_ENDING};
+    if (streaming) {
+        reply = pushedReport + reply;
+    }
+    if (GeneralUtilities::startsWith(request, static_cast<std::string>(IO_STREAM_HEADER) + ":")) {
+        streaming = !GeneralUtilities::startsWith(request, static_cast<std::string>(IO_STREAM_HEADER) + ":0" + LINE_ENDING);
+    }
+    return reply;
+}
+
+void testSendDelayPushedIOReports()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(streamingResponder)};
+    Arduino arduino{ArduinoType::UNO, stream};
+    arduino.setIOResponseMode(IOResponseMode::SEND_DELAY);
+    std::atomic<int> reportCount{0};
+    check(arduino.subscribeIOReports(50, IOStreamMode::ON_CHANGE, [&reportCount](const IOReport &ioReport) { (void)ioReport; reportCount++; }).first == IOStatus::OPERATION_SUCCESS, "send delay subscribeIOReports succeeds");
+    stream->clearWritten();
+    std::pair<IOStatus, bool> result{arduino.digitalRead(5)};
+    check((result.first == IOStatus::OPERATION_SUCCESS) && (stream->written().size() == 1), "send delay digitalRead(5) skips a pushed report sent ahead of its reply");
+    for (int i = 0; (i < 100) && (reportCount == 0); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    check(reportCount == 1, "the report pushed ahead of the digitalRead(5) reply reaches onIOReport");
+    stream->clearWritten();
+    check((arduino.unsubscribeIOReports() == IOStatus::OPERATION_SUCCESS) && (stream->written().size() == 1), "send delay unsubscribeIOReports does not take a pushed report as its acknowledgement");
+}
+
+/* Acknowledges live update requests and, once live update is on, pushes a {canread} frame
+ * ahead of every other reply */
+std::string canStreamingResponder(const std::string &request)
+{
+    static bool streaming{false};
+    if (GeneralUtilities::startsWith(request, static_cast<std::string>(CAN_LIVE_UPDATE_HEADER) + ":")) {
+        streaming = GeneralUtilities::startsWith(request, static_cast<std::string>(CAN_LIVE_UPDATE_HEADER) + ":1");
+        return static_cast<std::string>(CAN_LIVE_UPDATE_HEADER) + ":" + (streaming ? "1" : "0") + ":1}";
+    }
+    std::string pushedFrame{static_cast<std::string>(CAN_READ_HEADER) + ":123:1:2:3:4:5:6:7:8:1}"};
+    return (streaming ? pushedFrame : "") + firmwareResponder(request);
+}
+
+void testEventDrivenPushedCanFrames()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(canStreamingResponder)};
+    Arduino arduino{ArduinoType::UNO, stream};
+    arduino.setIOResponseMode(IOResponseMode::EVENT_DRIVEN);
+    check(arduino.canAutoUpdate(true).first == IOStatus::OPERATION_SUCCESS, "canAutoUpdate(true) succeeds");
+    check(arduino.digitalRead(5).first == IOStatus::OPERATION_SUCCESS, "event driven digitalRead(5) succeeds behind a pushed {canread} frame");
+    CanMessage messages[2];
+    size_t polled{arduino.pollCanMessages(messages, 2)};
+    check((polled == 1) && (messages[0].id() == 0x123) && (messages[0].nthDataPacketByte(7) == 8), "the {canread} frame pushed ahead of the digitalRead(5) reply is queued for pollCanMessages (" + std::to_string(polled) + " polled)");
+    check(arduino.canAutoUpdate(false).first == IOStatus::OPERATION_SUCCESS, "canAutoUpdate(false) succeeds");
+}
+
+/* canListen reads the stream itself, so with the reader thread running for live update it has to
+ * wait its turn on the IO lock like every other synchronous request */
+void testCanListenWhileStreaming()
+{
+    std::shared_ptr<ScriptedStream> stream{std::make_shared<ScriptedStream>(canStreamingResponder)};
+    Arduino arduino{ArduinoType::UNO, stream};
+    arduino.setIOResponseMode(IOResponseMode::EVENT_DRIVEN);
+    check(arduino.canAutoUpdate(true).first == IOStatus::OPERATION_SUCCESS, "canAutoUpdate(true) succeeds");
+    int listened{0};
+    for (int i = 0; i < 50; i++) {
+        std::pair<IOStatus, CanMessage> result{arduino.canListen(DEFAULT_IO_STREAM_SEND_DELAY)};
+        if ((result.first == IOStatus::OPERATION_SUCCESS) && (result.second.id() == 0x123)) {
+            listened++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    check(listened == 50, "canListen reads its own reply while the reader thread streams (" + std::to_string(listened) + " of 50)");
+    check(!stream->overlappedReads(), "canListen never reads the stream while the reader thread is blocked on it");
+    check(arduino.canAutoUpdate(false).first == IOStatus::OPERATION_SUCCESS, "canAutoUpdate(false) succeeds");
+}
+
+/* Short and extended frames keep their length and frame type through a capture file, and a replay
+ * hands canRead() back just the bytes that were captured */
+void testBusCaptureKeepsFrameShape()
+{
+    const std::string capturePath{"arduino-io-test-capture.cap"};
+    CanMessage extended{0x18DAF110, CAN_EXTENDED_FRAME, 3, CanDataPacket{0x02, 0x10, 0x03, 0, 0, 0, 0, 0}};
+    CanMessage standard{0x123, CAN_FRAME, 2, CanDataPacket{0xAB, 0xCD, 0, 0, 0, 0, 0, 0}};
+    {
+        BusCaptureWriter writer{capturePath};
+        writer.captureCanMessage(extended, false);
+        writer.captureCanMessage(standard, false);
+        writer.flush();
+    }
+    std::shared_ptr<BusCaptureReader> reader{std::make_shared<BusCaptureReader>(capturePath)};
+    BusCaptureRecord records[2];
+    check(reader->read(0, records, 2) == 2, "both captured frames are read back");
+    check((records[0].length == 3) && ((records[0].flags & BUS_CAPTURE_EXTENDED_ID) != 0), "the extended frame is captured with its 3 bytes and flagged extended");
+    check((records[1].length == 2) && ((records[1].flags & BUS_CAPTURE_EXTENDED_ID) == 0), "the standard frame is captured with its 2 bytes and not flagged extended");
+    Arduino arduino{ArduinoType::UNO, std::make_shared<BusCaptureReplayStream>(reader, 0)};
+    std::pair<IOStatus, CanMessage> first{arduino.canRead()};
+    check((first.first == IOStatus::OPERATION_SUCCESS) && (first.second.id() == 0x18DAF110) && (first.second.length() == 3) && (first.second.frame() == CAN_EXTENDED_FRAME) && (first.second.nthDataPacketByte(2) == 0x03), "the replayed extended frame reads back with 3 bytes");
+    std::pair<IOStatus, CanMessage> second{arduino.canRead()};
+    check((second.first == IOStatus::OPERATION_SUCCESS) && (second.second.id() == 0x123) && (second.second.length() == 2) && (second.second.frame() == CAN_FRAME) && (second.second.nthDataPacketByte(1) == 0xCD), "the replayed standard frame reads back with 2 bytes");
+    std::remove(capturePath.c_str());
+}
+
+int main()
+{
+    testEventDrivenResponseFrame();
+    testFirmwareReadyProbe();
+    testFullMegaMultiRead();
+    testDeltaIOReportSubscription();
+    testSendDelayPushedIOReports();
+    testEventDrivenPushedCanFrames();
+    testCanListenWhileStreaming();
+    testBusCaptureKeepsFrameShape();
+    std::cout << std::endl << (failures == 0 ? "All tests passed" : std::to_string(failures) + " test(s) failed") << std::endl;
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
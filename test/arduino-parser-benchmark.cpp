@@ -0,0 +1,111 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <generalutilities.h>
+#include <arduino.h>
+
+/* Compares the legacy genericIOTask parsing (unique_ptr<string>, substr, parseToContainer,
+ * decStringToInt) with the in place IOResponseFields parser on representative frames.
+ * Allocations are counted by replacing the global operator new */
+
+static unsigned long long allocationCount{0};
+
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *pointer{malloc(size)};
+    if (!pointer) {
+        throw std::bad_alloc{};
+    }
+    return pointer;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept
+{
+    (void)size;
+    free(pointer);
+}
+
+static const int ITERATIONS{1000000};
+static const std::string DIGITAL_READ_FRAME{"{dread:13:1:1}"};
+static const std::string DIGITAL_READ_MULTI_FRAME{"{dreadmulti:2:1:1:3:0:1:4:1:1:5:0:1:6:1:1:7:0:1:8:1:1:9:0:1:1}"};
+
+int legacyParse(const std::string &frame, const std::string &header)
+{
+    std::unique_ptr<std::string> returnString{std::make_unique<std::string>(frame)};
+    if (GeneralUtilities::startsWith(*returnString, header) && GeneralUtilities::endsWith(*returnString, TERMINATING_CHARACTER)) {
+        *returnString = returnString->substr(header.length() + 1);
+        *returnString = returnString->substr(0, returnString->length()-1);
+    } else {
+        return 0;
+    }
+    std::vector<std::string> states{GeneralUtilities::parseToContainer<std::vector<std::string>>(returnString->begin(), returnString->end(), ':')};
+    int sum{0};
+    for (auto &it : states) {
+        sum += GeneralUtilities::decStringToInt(it);
+    }
+    return sum;
+}
+
+int fieldParse(IOResponseFields *fields, std::string &&frame, const std::string &header)
+{
+    if (!fields->parse(std::move(frame), header, ':', TERMINATING_CHARACTER, LINE_ENDING)) {
+        return 0;
+    }
+    int sum{0};
+    for (size_t i = 0; i < fields->size(); i++) {
+        int value{0};
+        if ((*fields)[i].toInt(&value)) {
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+void runBenchmark(const std::string &title, const std::string &frame, const std::string &header)
+{
+    volatile int sink{0};
+    std::unique_ptr<IOResponseFields> fields{std::make_unique<IOResponseFields>()};
+
+    unsigned long long startAllocations{allocationCount};
+    auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink = sink + legacyParse(frame, header);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+    double legacyNanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+    double legacyAllocations{static_cast<double>(allocationCount - startAllocations) / ITERATIONS};
+
+    //The frame copy stands in for the string genericIOFrameTask hands over, and is counted for both paths
+    startAllocations = allocationCount;
+    startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        sink = sink + fieldParse(fields.get(), std::string{frame}, header);
+    }
+    endTime = std::chrono::steady_clock::now();
+    double fieldNanoseconds{std::chrono::duration<double, std::nano>(endTime - startTime).count() / ITERATIONS};
+    double fieldAllocations{static_cast<double>(allocationCount - startAllocations) / ITERATIONS};
+
+    std::cout << title << " (" << std::quoted(frame) << ")" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    legacy: " << legacyNanoseconds << "ns/parse, " << legacyAllocations << " allocations/parse" << std::endl;
+    std::cout << "    fields: " << fieldNanoseconds << "ns/parse, " << fieldAllocations << " allocations/parse" << std::endl;
+    std::cout << std::endl;
+}
+
+int main()
+{
+    runBenchmark("digitalRead response", DIGITAL_READ_FRAME, DIGITAL_READ_HEADER);
+    runBenchmark("digitalReadMany response (8 pins)", DIGITAL_READ_MULTI_FRAME, DIGITAL_READ_MULTI_HEADER);
+    return 0;
+}